@@ -43,6 +43,7 @@
 using decimal::Decimal;
 
 #include "PF_CollectDataApp.h"
+#include "PF_Trace.h"
 
 int main(int argc, char** argv)
 {
@@ -93,6 +94,10 @@ int main(int argc, char** argv)
         result = 5;
     }
 
+    // all worker threads are finished by now.
+
+    PF_TRACE_WRITE();
+
 	return result;
 }
 
@@ -0,0 +1,241 @@
+// =====================================================================================
+//
+//       Filename:  CSVScanner.h
+//
+//    Description:  Allocation free scanner for delimited text data such as
+//    memory mapped price files.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 11:05 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _CSVSCANNER_INC_
+#define _CSVSCANNER_INC_
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <decimal.hh>
+
+// find the first 'delim' or newline at or after 'begin'. Returns 'end' if there is none.
+// With SSE2 we check 16 bytes at a time for both characters at once.
+
+inline const char *FindDelimiterOrNewline(const char *begin, const char *end, char delim)
+{
+#if defined(__SSE2__)
+    const __m128i delims = _mm_set1_epi8(delim);
+    const __m128i newlines = _mm_set1_epi8('\n');
+    while (end - begin >= 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        const auto mask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, delims), _mm_cmpeq_epi8(chunk, newlines))));
+        if (mask != 0)
+        {
+            return begin + std::countr_zero(mask);
+        }
+        begin += 16;
+    }
+#endif
+    for (; begin != end; ++begin)
+    {
+        if (*begin == delim || *begin == '\n')
+        {
+            return begin;
+        }
+    }
+    return end;
+}
+
+// convert a price field to a Decimal without going through a temporary std::string.
+// Plain decimal numbers of up to 18 digits are handled directly. Anything else
+// (exponents, very long values) goes the slow way.
+
+inline decimal::Decimal FieldToDecimal(std::string_view field)
+{
+    constexpr size_t kMaxDigits = 18;
+
+    const char *p = field.data();
+    const char *end = p + field.size();
+    const bool negative = p != end && *p == '-';
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+        ++p;
+    }
+
+    // an empty field's data() can be null and memchr must not be given that even
+    // with a length of 0.
+
+    if (p == end)
+    {
+        return decimal::Decimal{std::string{field}};
+    }
+
+    const char *point = static_cast<const char *>(std::memchr(p, '.', end - p));
+    const char *int_end = point != nullptr ? point : end;
+    const char *frac_begin = point != nullptr ? point + 1 : end;
+
+    const auto int_digits = static_cast<size_t>(int_end - p);
+    const auto frac_digits = static_cast<size_t>(end - frac_begin);
+
+    if (int_digits + frac_digits > 0 && int_digits + frac_digits <= kMaxDigits)
+    {
+        int64_t int_part = 0;
+        int64_t frac_part = 0;
+        bool ok = true;
+        if (int_digits > 0)
+        {
+            const auto [ptr, ec] = std::from_chars(p, int_end, int_part);
+            ok = ec == std::errc{} && ptr == int_end && *p != '-';
+        }
+        if (ok && frac_digits > 0)
+        {
+            const auto [ptr, ec] = std::from_chars(frac_begin, end, frac_part);
+            ok = ec == std::errc{} && ptr == end && *frac_begin != '-' && *frac_begin != '+';
+        }
+        if (ok)
+        {
+            int64_t coefficient = int_part;
+            for (size_t i = 0; i < frac_digits; ++i)
+            {
+                coefficient *= 10;
+            }
+            coefficient += frac_part;
+            decimal::Decimal result{negative ? -coefficient : coefficient};
+            return frac_digits == 0 ? result : result.scaleb(decimal::Decimal{-static_cast<int32_t>(frac_digits)});
+        }
+    }
+    return decimal::Decimal{std::string{field}};
+}
+
+// =====================================================================================
+//        Class:  CSVScanner
+//  Description:  walk through delimited records held in memory. Fields are views
+//  into the original data so nothing is copied. Blank lines are skipped and
+//  a trailing '\r' is removed from each record.
+//
+//  Only the first kMaxFields fields of a record are kept.
+// =====================================================================================
+
+class CSVScanner
+{
+public:
+    static constexpr size_t kMaxFields = 32;
+
+    // ====================  LIFECYCLE     =======================================
+
+    CSVScanner(std::string_view data, char delim) : data_{data}, delim_{delim} {}
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] std::string_view Record() const
+    {
+        return record_;
+    }
+    [[nodiscard]] size_t FieldCount() const
+    {
+        return field_count_;
+    }
+    [[nodiscard]] std::string_view Field(size_t which) const
+    {
+        return which < field_count_ ? fields_[which] : std::string_view{};
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    // move to the next non-empty record. Returns false when there are no more.
+
+    bool NextRecord()
+    {
+        const char *const end = data_.data() + data_.size();
+        while (position_ < data_.size())
+        {
+            const char *p = data_.data() + position_;
+            const char *record_begin = p;
+            field_count_ = 0;
+
+            while (true)
+            {
+                const char *stop = FindDelimiterOrNewline(p, end, delim_);
+                AddField(p, stop);
+                if (stop == end || *stop == '\n')
+                {
+                    position_ = stop == end ? data_.size() : static_cast<size_t>(stop - data_.data()) + 1;
+                    record_ = std::string_view{record_begin, static_cast<size_t>(stop - record_begin)};
+                    break;
+                }
+                p = stop + 1;
+            }
+
+            if (!record_.empty() && record_.back() == '\r')
+            {
+                record_.remove_suffix(1);
+            }
+            if (!record_.empty())
+            {
+                return true;
+            }
+        }
+        field_count_ = 0;
+        record_ = {};
+        return false;
+    }
+
+private:
+    void AddField(const char *begin, const char *end)
+    {
+        if (end != begin && *(end - 1) == '\r')
+        {
+            --end;
+        }
+        if (field_count_ < kMaxFields)
+        {
+            fields_[field_count_] = std::string_view{begin, static_cast<size_t>(end - begin)};
+            ++field_count_;
+        }
+    }
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::string_view data_;
+    std::string_view record_;
+    std::array<std::string_view, kMaxFields> fields_;
+
+    size_t position_ = 0;
+    size_t field_count_ = 0;
+    char delim_;
+
+}; // -----  end of class CSVScanner  -----
+
+#endif // ----- #ifndef _CSVSCANNER_INC_  -----
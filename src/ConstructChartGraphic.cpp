@@ -18,6 +18,7 @@
 #include <chrono>
 #include <cstddef>
 #include <format>
+#include <fstream>
 #include <memory>
 #include <ranges>
 
@@ -88,9 +89,35 @@ const auto tt_cat_buy_sym = Chart::ArrowShape();
 const auto tb_cat_sell_sym = Chart::ArrowShape(180);
 // NOLINTEND
 
+namespace
+{
+// ChartDirector owns the memory it returns so we need a copy.
+
+std::string MemBlockToString(const MemBlock &block)
+{
+    return block.data != nullptr ? std::string{block.data, static_cast<size_t>(block.len)} : std::string{};
+}
+
+void WriteGraphicToFile(const fs::path &output_filename, const std::string &graphic)
+{
+    std::ofstream out{output_filename, std::ios::out | std::ios::binary};
+    BOOST_ASSERT_MSG(out.is_open(),
+                     std::format("Unable to open file: {} for graphic output.", output_filename).c_str());
+    out.write(graphic.data(), static_cast<std::streamsize>(graphic.size()));
+    out.close();
+}
+} // namespace
+
 void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs::path &output_filename,
-                                             const StreamedPrices &streamed_prices,
-                                             const std::string & /*show_trend_lines*/, X_AxisFormat date_or_time)
+                                             const StreamedPrices &streamed_prices, const std::string &show_trend_lines,
+                                             X_AxisFormat date_or_time)
+{
+    WriteGraphicToFile(output_filename,
+                       ConstructCDPFChartGraphicAsSVG(the_chart, streamed_prices, show_trend_lines, date_or_time));
+}
+
+std::string ConstructCDPFChartGraphicAsSVG(const PF_Chart &the_chart, const StreamedPrices &streamed_prices,
+                                           const std::string & /*show_trend_lines*/, X_AxisFormat date_or_time)
 {
     BOOST_ASSERT_MSG(
         !the_chart.empty(),
@@ -423,8 +450,7 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs
 
     if (!p)
     {
-        c->makeChart(output_filename.c_str());
-        return;
+        return MemBlockToString(c->makeChart(Chart::SVG));
     }
 
     // we have a dual chart setup
@@ -434,7 +460,7 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs
     m->addChart(0, 0, c.get());
     m->addChart(0, (kChartHeight2 * kDpi), p.get());
 
-    m->makeChart(output_filename.c_str());
+    return MemBlockToString(m->makeChart(Chart::SVG));
 }
 
 void ConstructCDPFChartGraphicAddPFSignals(const PF_Chart &the_chart, Signals_1 &data_arrays, size_t skipped_columns,
@@ -738,6 +764,11 @@ void ConstructCDPricesGraphicAddSignals(const PF_Chart &the_chart, Signals_2 &da
 }
 
 void ConstructCDSummaryGraphic(const PF_StreamedSummary &streamed_summary, const fs::path &output_filename)
+{
+    WriteGraphicToFile(output_filename, ConstructCDSummaryGraphicAsSVG(streamed_summary));
+}
+
+std::string ConstructCDSummaryGraphicAsSVG(const PF_StreamedSummary &streamed_summary)
 {
     // simple floating bar graphic which shows overall price movement for each symbol
 
@@ -792,5 +823,5 @@ void ConstructCDSummaryGraphic(const PF_StreamedSummary &streamed_summary, const
     c->yAxis2()->copyAxis(c->yAxis());
     c->yAxis2()->setTickWidth(3, 1);
 
-    c->makeChart(output_filename.c_str());
+    return MemBlockToString(c->makeChart(Chart::SVG));
 }
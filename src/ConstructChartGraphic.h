@@ -18,6 +18,7 @@
 #define _CONSTRUCTCHARTGRAPHIC_INC_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 class XYChart;
@@ -83,6 +84,12 @@ void ConstructCDPFChartGraphicAndWriteToFile(const PF_Chart &the_chart, const fs
                                              const StreamedPrices &streamed_prices, const std::string &show_trend_lines,
                                              X_AxisFormat date_or_time = X_AxisFormat::e_show_date);
 
+// same graphic but returned as SVG text so the caller decides how it gets written.
+
+std::string ConstructCDPFChartGraphicAsSVG(const PF_Chart &the_chart, const StreamedPrices &streamed_prices,
+                                           const std::string &show_trend_lines,
+                                           X_AxisFormat date_or_time = X_AxisFormat::e_show_date);
+
 void ConstructCDPFChartGraphicAddPFSignals(const PF_Chart &the_chart, Signals_1 &data_arrays, size_t skipped_columns,
                                            std::unique_ptr<XYChart> &the_graphic);
 
@@ -90,5 +97,6 @@ void ConstructCDPricesGraphicAddSignals(const PF_Chart &the_chart, Signals_2 &da
                                         const StreamedPrices &streamed_prices, std::unique_ptr<XYChart> &the_graphic);
 
 void ConstructCDSummaryGraphic(const PF_StreamedSummary &streamed_summary, const fs::path &output_filename);
+std::string ConstructCDSummaryGraphicAsSVG(const PF_StreamedSummary &streamed_summary);
 
 #endif // ----- #ifndef _CONSTRUCTCHARTGRAPHIC_INC_  -----
@@ -0,0 +1,324 @@
+// =====================================================================================
+//
+//       Filename:  DateTimeParsing.h
+//
+//    Description:  Hand written parsers for the few date/time formats we
+//    ingest so we don't go through iostreams for every record.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 11:05 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _DATETIMEPARSING_INC_
+#define _DATETIMEPARSING_INC_
+
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+#include "utilities.h"
+
+// these produce the same time points as 'StringToUTCTimePoint' for the formats we use.
+// Anything else is passed on to 'StringToUTCTimePoint'.
+//
+// All our ingest paths (files, stock DB, price cache) come through here so that
+// no record needs iostreams or a trip through the leap second table.
+//
+// header-only because both the PF_Chart library and the collector use them.
+
+using UTCTimePoint = std::chrono::utc_time<std::chrono::utc_clock::duration>;
+
+enum class DateTimeFormat : int32_t
+{
+    e_unknown,
+    e_date,              // "%F"
+    e_date_time_zone,    // "%F %T%z"
+    e_iso_date_time_zone // "%FT%T%z"
+};
+
+constexpr DateTimeFormat ClassifyDateTimeFormat(std::string_view format)
+{
+    if (format == "%F")
+    {
+        return DateTimeFormat::e_date;
+    }
+    if (format == "%F %T%z")
+    {
+        return DateTimeFormat::e_date_time_zone;
+    }
+    if (format == "%FT%T%z")
+    {
+        return DateTimeFormat::e_iso_date_time_zone;
+    }
+    return DateTimeFormat::e_unknown;
+}
+
+namespace DateTimeParsing_detail
+{
+// parse exactly 'width' digits. Returns -1 if any are not digits.
+
+constexpr int32_t ParseDigits(const char *text, int32_t width)
+{
+    int32_t result = 0;
+    for (int32_t i = 0; i < width; ++i)
+    {
+        const char c = text[i];
+        if (c < '0' || c > '9')
+        {
+            return -1;
+        }
+        result = result * 10 + (c - '0');
+    }
+    return result;
+}
+} // namespace DateTimeParsing_detail
+
+// YYYY-MM-DD as days since the epoch.
+
+constexpr std::optional<std::chrono::sys_days> ParseDate(std::string_view text)
+{
+    using namespace DateTimeParsing_detail;
+
+    if (text.size() < 10 || text[4] != '-' || text[7] != '-')
+    {
+        return {};
+    }
+    const int32_t year = ParseDigits(text.data(), 4);
+    const int32_t month = ParseDigits(text.data() + 5, 2);
+    const int32_t day = ParseDigits(text.data() + 8, 2);
+    if (year < 0 || month < 0 || day < 0)
+    {
+        return {};
+    }
+    const std::chrono::year_month_day ymd{std::chrono::year{year}, std::chrono::month{static_cast<unsigned>(month)},
+                                          std::chrono::day{static_cast<unsigned>(day)}};
+    if (!ymd.ok())
+    {
+        return {};
+    }
+    return std::chrono::sys_days{ymd};
+}
+
+// "YYYY-MM-DD<sep>HH:MM:SS[.fffffffff](Z|(+|-)HH[[:]MM])" where <sep> is ' ' or 'T'.
+// The zone is required, as it is for %z. Postgres timestamptz text has just the hours.
+// Every field must have its full width and be in range. Anything else is not a time.
+
+constexpr std::optional<std::chrono::sys_time<std::chrono::utc_clock::duration>> ParseDateTime(std::string_view text,
+                                                                                              char separator)
+{
+    using namespace DateTimeParsing_detail;
+    using namespace std::chrono;
+
+    const auto the_date = ParseDate(text);
+    if (!the_date || text.size() < 19 || text[10] != separator || text[13] != ':' || text[16] != ':')
+    {
+        return {};
+    }
+    const int32_t hours = ParseDigits(text.data() + 11, 2);
+    const int32_t minutes = ParseDigits(text.data() + 14, 2);
+    const int32_t seconds = ParseDigits(text.data() + 17, 2);
+    if (hours < 0 || hours > 23 || minutes < 0 || minutes > 59 || seconds < 0 || seconds > 60)
+    {
+        return {};
+    }
+    sys_time<utc_clock::duration> result =
+        the_date.value() + std::chrono::hours{hours} + std::chrono::minutes{minutes} + std::chrono::seconds{seconds};
+
+    size_t pos = 19;
+    if (pos < text.size() && text[pos] == '.')
+    {
+        // fractional seconds. We keep up to nanoseconds and drop anything beyond.
+
+        int64_t fraction = 0;
+        int32_t fraction_digits = 0;
+        const size_t fraction_begin = ++pos;
+        for (; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos)
+        {
+            if (fraction_digits < 9)
+            {
+                fraction = fraction * 10 + (text[pos] - '0');
+                ++fraction_digits;
+            }
+        }
+        if (pos == fraction_begin)
+        {
+            return {};
+        }
+        for (; fraction_digits < 9; ++fraction_digits)
+        {
+            fraction *= 10;
+        }
+        result += duration_cast<utc_clock::duration>(nanoseconds{fraction});
+    }
+
+    if (pos == text.size())
+    {
+        return {};
+    }
+    if (text[pos] == 'Z')
+    {
+        return result;
+    }
+    if (text[pos] != '+' && text[pos] != '-')
+    {
+        return {};
+    }
+    const bool negative = text[pos] == '-';
+    ++pos;
+    if (text.size() - pos < 2)
+    {
+        return {};
+    }
+    const int32_t offset_hours = ParseDigits(text.data() + pos, 2);
+    pos += 2;
+    const bool has_colon = pos < text.size() && text[pos] == ':';
+    if (has_colon)
+    {
+        ++pos;
+    }
+    int32_t offset_minutes = 0;
+    if (has_colon || pos < text.size())
+    {
+        if (text.size() - pos < 2)
+        {
+            return {};
+        }
+        offset_minutes = ParseDigits(text.data() + pos, 2);
+    }
+    if (offset_hours < 0 || offset_hours > 23 || offset_minutes < 0 || offset_minutes > 59)
+    {
+        return {};
+    }
+    const auto offset = std::chrono::hours{offset_hours} + std::chrono::minutes{offset_minutes};
+
+    // local time = UTC + offset
+
+    return negative ? result + offset : result - offset;
+}
+
+// the last leap second was at the end of 2016 and more are not expected. So, for
+// anything after the most recent one, converting to UTC is just adding a constant.
+// We look that up once instead of letting clock_cast search for it every time.
+
+struct LeapSecondOffset
+{
+    std::chrono::sys_seconds last_leap_second_;
+    std::chrono::seconds total_leap_seconds_;
+};
+
+inline const LeapSecondOffset &GetLeapSecondOffset()
+{
+    static const LeapSecondOffset offset = [] {
+        // if there is no list, we just always use clock_cast.
+
+        LeapSecondOffset result{.last_leap_second_ = std::chrono::sys_seconds::max(),
+                                .total_leap_seconds_ = std::chrono::seconds{0}};
+        for (const auto &leap_second : std::chrono::get_tzdb().leap_seconds)
+        {
+            result.last_leap_second_ = leap_second.date();
+            result.total_leap_seconds_ += leap_second.value();
+        }
+        return result;
+    }();
+    return offset;
+}
+
+inline UTCTimePoint SysToUTCTimePoint(std::chrono::sys_time<std::chrono::utc_clock::duration> sys_time)
+{
+    if (const auto &offset = GetLeapSecondOffset(); sys_time >= offset.last_leap_second_)
+    {
+        return UTCTimePoint{sys_time.time_since_epoch() + offset.total_leap_seconds_};
+    }
+    return std::chrono::clock_cast<std::chrono::utc_clock>(sys_time);
+}
+
+// EOD data has only a few thousand distinct dates and every symbol uses the same ones,
+// so we remember the dates we have already converted. The table is per thread so no
+// locking is needed when we load symbols in parallel.
+
+inline UTCTimePoint DateToUTCTimePoint(std::string_view text)
+{
+    using namespace DateTimeParsing_detail;
+
+    thread_local std::unordered_map<int32_t, UTCTimePoint> converted_dates;
+
+    if (text.size() >= 10 && text[4] == '-' && text[7] == '-')
+    {
+        const int32_t year = ParseDigits(text.data(), 4);
+        const int32_t month = ParseDigits(text.data() + 5, 2);
+        const int32_t day = ParseDigits(text.data() + 8, 2);
+        if (year >= 0 && month >= 0 && day >= 0)
+        {
+            const int32_t key = year * 10'000 + month * 100 + day;
+            if (const auto found = converted_dates.find(key); found != converted_dates.end())
+            {
+                return found->second;
+            }
+            if (const auto the_date = ParseDate(text); the_date)
+            {
+                return converted_dates.emplace(key, SysToUTCTimePoint(the_date.value())).first->second;
+            }
+        }
+    }
+    throw std::invalid_argument{std::format("Unable to parse date: '{}'.", text)};
+}
+
+inline UTCTimePoint ParseUTCTimePoint(DateTimeFormat format, std::string_view text)
+{
+    std::optional<std::chrono::sys_time<std::chrono::utc_clock::duration>> result;
+    switch (format)
+    {
+        case DateTimeFormat::e_date:
+            return DateToUTCTimePoint(text);
+        case DateTimeFormat::e_date_time_zone:
+            result = ParseDateTime(text, ' ');
+            break;
+        case DateTimeFormat::e_iso_date_time_zone:
+            result = ParseDateTime(text, 'T');
+            break;
+        default:
+            break;
+    }
+    if (!result)
+    {
+        throw std::invalid_argument{std::format("Unable to parse date/time: '{}'.", text)};
+    }
+    return SysToUTCTimePoint(result.value());
+}
+
+inline UTCTimePoint ParseUTCTimePoint(std::string_view format, std::string_view text)
+{
+    if (const auto which_format = ClassifyDateTimeFormat(format); which_format != DateTimeFormat::e_unknown)
+    {
+        return ParseUTCTimePoint(which_format, text);
+    }
+    return StringToUTCTimePoint(format, text);
+}
+
+#endif // ----- #ifndef _DATETIMEPARSING_INC_  -----
@@ -80,7 +80,7 @@ void Eodhd::on_read_subscribe(beast::error_code ec, std::size_t bytes_transferre
     StartReadLoop();
 }
 
-Eodhd::PF_Data Eodhd::ExtractStreamedData(const std::string &buffer)
+Eodhd::PF_Data Eodhd::ExtractStreamedData(std::string_view buffer)
 {
 
     // response format is 'simple' so we'll use RegExes here too.
@@ -124,7 +124,10 @@ Eodhd::PF_Data Eodhd::ExtractStreamedData(const std::string &buffer)
 
     PF_Data new_value;
 
-    if (bool matched_it = boost::regex_match(response_text, fields, kResponseRegex); matched_it)
+    // the buffer is a view into a pooled frame. It's not null terminated.
+
+    if (bool matched_it = boost::regex_match(response_text, response_text + buffer.size(), fields, kResponseRegex);
+        matched_it)
     {
         std::string_view tmp_fld(response_text + fields.position(e_time), fields.length(std::to_underlying(e_time)));
 
@@ -292,12 +295,18 @@ RemoteDataSource::TopOfBookList Eodhd::GetTopOfBookAndLastClose()
 
     TopOfBookList stock_data;
 
+    // 1 request per symbol so we make several at a time.
+
+    std::vector<std::string> request_strings;
     for (const auto &symbol : symbol_list_)
     {
-        std::string request_string =
-            std::format("https://{}/api/real-time/{}.US?api_token={}&fmt=csv", host_, symbol, api_key_);
-        const auto tob_data = RequestData(request_string);
+        request_strings.push_back(
+            std::format("https://{}/api/real-time/{}.US?api_token={}&fmt=csv", host_, symbol, api_key_));
+    }
+    const auto responses = RequestData(request_strings);
 
+    for (const auto &[symbol, tob_data] : vws::zip(symbol_list_, responses))
+    {
         const auto rows = split_string<std::string_view>(tob_data, "\n");
         const auto fields = split_string<std::string_view>(rows[1], ",");
 
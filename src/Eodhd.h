@@ -32,7 +32,7 @@ public:
                                                          UseAdjusted use_adjusted,
                                                          const US_MarketHolidays *holidays) override;
 
-    PF_Data ExtractStreamedData(const std::string &buffer) override;
+    PF_Data ExtractStreamedData(std::string_view buffer) override;
 
     // Async Hooks
     void OnConnected() override;
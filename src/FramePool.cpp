@@ -0,0 +1,106 @@
+// =====================================================================================
+//
+//       Filename:  FramePool.cpp
+//
+//    Description:  recycled buffers for websocket frames so streaming doesn't
+//    allocate for each message.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 11:58 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <cstring>
+
+#include "FramePool.h"
+
+FramePool::FramePool(size_t max_idle) : max_idle_{max_idle}
+{
+    // reserve up front so returning a buffer never has to grow the free list.
+
+    idle_buffers_.reserve(max_idle_);
+} // -----  end of method FramePool::FramePool  (constructor)  -----
+
+FramePool::Frame FramePool::Acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!idle_buffers_.empty())
+        {
+            auto buffer = std::move(idle_buffers_.back());
+            idle_buffers_.pop_back();
+            return Frame{this, std::move(buffer)};
+        }
+    }
+    ++buffers_created_;
+    return Frame{this, std::make_unique<boost::beast::flat_buffer>()};
+} // -----  end of method FramePool::Acquire  -----
+
+void FramePool::Release(std::unique_ptr<boost::beast::flat_buffer> buffer)
+{
+    if (buffer->capacity() > kMaxKeptCapacity)
+    {
+        return;
+    }
+
+    // consuming everything empties the buffer but keeps its memory.
+
+    buffer->consume(buffer->size());
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (idle_buffers_.size() < max_idle_)
+    {
+        idle_buffers_.push_back(std::move(buffer));
+    }
+} // -----  end of method FramePool::Release  -----
+
+FramePool::Frame &FramePool::Frame::operator=(Frame &&rhs) noexcept
+{
+    if (this != &rhs)
+    {
+        if (buffer_)
+        {
+            pool_->Release(std::move(buffer_));
+        }
+        pool_ = rhs.pool_;
+        buffer_ = std::move(rhs.buffer_);
+    }
+    return *this;
+} // -----  end of method FramePool::Frame::operator=  -----
+
+FramePool::Frame::~Frame()
+{
+    if (buffer_)
+    {
+        pool_->Release(std::move(buffer_));
+    }
+} // -----  end of method FramePool::Frame::~Frame  -----
+
+void FramePool::Frame::Assign(std::string_view frame)
+{
+    buffer_->consume(buffer_->size());
+    auto space = buffer_->prepare(frame.size());
+    std::memcpy(space.data(), frame.data(), frame.size());
+    buffer_->commit(frame.size());
+} // -----  end of method FramePool::Frame::Assign  -----
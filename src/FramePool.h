@@ -0,0 +1,150 @@
+// =====================================================================================
+//
+//       Filename:  FramePool.h
+//
+//    Description:  recycled buffers for websocket frames so streaming doesn't
+//    allocate for each message.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 11:58 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _FRAMEPOOL_INC_
+#define _FRAMEPOOL_INC_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include <boost/beast/core/flat_buffer.hpp>
+
+// =====================================================================================
+//        Class:  FramePool
+//  Description:  a free list of frame buffers. The websocket reader reads each
+//  message straight into a buffer from the pool, the buffer goes through the
+//  parse queue as is and the parser looks at it in place. When the parser is done
+//  with it, the buffer goes back to the pool still holding its memory so, once
+//  the pool has warmed up, a message costs no allocations.
+//
+//  A flat_buffer keeps its bytes in 1 piece so a frame can be looked at as a
+//  string_view. Buffers which grew past kMaxKeptCapacity for an unusually big
+//  message are let go instead of being kept. Safe to use from any thread.
+// =====================================================================================
+
+class FramePool
+{
+public:
+    static constexpr size_t kMaxKeptCapacity = 64 * 1024;
+
+    // a move-only handle on 1 buffer from the pool. It returns the buffer to the
+    // pool when it goes away. The pool must outlive it.
+
+    class Frame
+    {
+    public:
+        Frame() = default;
+        Frame(Frame &&rhs) noexcept = default;
+        Frame &operator=(Frame &&rhs) noexcept;
+        ~Frame();
+
+        Frame(const Frame &rhs) = delete;
+        Frame &operator=(const Frame &rhs) = delete;
+
+        [[nodiscard]] explicit operator bool() const
+        {
+            return buffer_ != nullptr;
+        }
+
+        [[nodiscard]] std::string_view View() const
+        {
+            return {static_cast<const char *>(buffer_->cdata().data()), buffer_->size()};
+        }
+
+        [[nodiscard]] boost::beast::flat_buffer &Buffer()
+        {
+            return *buffer_;
+        }
+
+        // for frames which didn't come from the websocket (replay).
+        void Assign(std::string_view frame);
+
+    private:
+        friend class FramePool;
+
+        Frame(FramePool *pool, std::unique_ptr<boost::beast::flat_buffer> buffer)
+            : pool_{pool}, buffer_{std::move(buffer)}
+        {
+        }
+
+        FramePool *pool_ = nullptr;
+        std::unique_ptr<boost::beast::flat_buffer> buffer_;
+    };
+
+    // ====================  LIFECYCLE     =======================================
+
+    explicit FramePool(size_t max_idle = 4096);
+
+    FramePool(const FramePool &rhs) = delete;
+    FramePool(FramePool &&rhs) = delete;
+
+    ~FramePool() = default;
+
+    // ====================  ACCESSORS     =======================================
+
+    // how many buffers the pool has had to create. Stops growing once the pool
+    // has enough for the deepest parse queue.
+
+    [[nodiscard]] int64_t BuffersCreated() const
+    {
+        return buffers_created_;
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    // an empty buffer, from the free list if there is one.
+    [[nodiscard]] Frame Acquire();
+
+    // ====================  OPERATORS     =======================================
+
+    FramePool &operator=(const FramePool &rhs) = delete;
+    FramePool &operator=(FramePool &&rhs) = delete;
+
+private:
+    void Release(std::unique_ptr<boost::beast::flat_buffer> buffer);
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::mutex mtx_;
+    std::vector<std::unique_ptr<boost::beast::flat_buffer>> idle_buffers_;
+    size_t max_idle_;
+
+    std::atomic<int64_t> buffers_created_ = 0;
+
+}; // -----  end of class FramePool  -----
+
+#endif // ----- #ifndef _FRAMEPOOL_INC_  -----
@@ -0,0 +1,263 @@
+// =====================================================================================
+//
+//       Filename:  HttpsClient.cpp
+//
+//    Description:  HTTPS GET requests to a single host over a pool of kept-alive
+//    connections.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 11:15 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <charconv>
+#include <exception>
+#include <format>
+#include <stdexcept>
+
+#include <boost/asio/connect.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/version.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include "HttpsClient.h"
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+
+namespace
+{
+constexpr std::chrono::seconds kRequestTimeout{30};
+constexpr int32_t kMaxRateLimitRetries = 5;
+constexpr std::chrono::milliseconds kFirstRetryDelay{500};
+
+// Retry-After is either seconds or an HTTP date. We only use the seconds form.
+
+std::chrono::milliseconds RetryDelay(const http::response<http::string_body> &response, int32_t attempt)
+{
+    const auto retry_after = response[http::field::retry_after];
+    int32_t seconds = 0;
+    if (const auto [ptr, ec] = std::from_chars(retry_after.data(), retry_after.data() + retry_after.size(), seconds);
+        ec == std::errc{} && seconds > 0)
+    {
+        return std::chrono::seconds{seconds};
+    }
+    return kFirstRetryDelay * (1 << attempt);
+}
+} // namespace
+
+HttpsClient::HttpsClient(std::string host, std::string port, int32_t max_connections, int32_t requests_per_second)
+    : host_{std::move(host)},
+      port_{std::move(port)},
+      ctx_{ssl::context::tlsv12_client},
+      max_connections_{std::max(max_connections, 1)}
+{
+    if (requests_per_second > 0)
+    {
+        request_spacing_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>{1.0 / requests_per_second});
+    }
+} // -----  end of method HttpsClient::HttpsClient  (constructor)  -----
+
+HttpsClient::~HttpsClient()
+{
+    // just drop the connections. A TLS shutdown handshake would only slow us down.
+
+    for (auto &connection : idle_connections_)
+    {
+        beast::error_code ec;
+        beast::get_lowest_layer(*connection->stream_).socket().close(ec);
+    }
+} // -----  end of method HttpsClient::~HttpsClient  (destructor)  -----
+
+std::unique_ptr<HttpsClient::Connection> HttpsClient::Borrow()
+{
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this] { return !idle_connections_.empty() || open_connections_ < max_connections_; });
+    if (!idle_connections_.empty())
+    {
+        auto connection = std::move(idle_connections_.back());
+        idle_connections_.pop_back();
+        return connection;
+    }
+    ++open_connections_;
+    return std::make_unique<Connection>();
+} // -----  end of method HttpsClient::Borrow  -----
+
+void HttpsClient::GiveBack(std::unique_ptr<Connection> connection)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (connection && connection->stream_)
+        {
+            idle_connections_.push_back(std::move(connection));
+        }
+        else
+        {
+            --open_connections_;
+        }
+    }
+    cv_.notify_one();
+} // -----  end of method HttpsClient::GiveBack  -----
+
+void HttpsClient::Open(Connection &connection)
+{
+    connection.stream_ = std::make_unique<Stream>(connection.ioc_, ctx_);
+    if (!SSL_set_tlsext_host_name(connection.stream_->native_handle(), host_.c_str()))
+    {
+        throw beast::system_error{
+            beast::error_code(static_cast<int>(::ERR_get_error()), net::error::get_ssl_category())};
+    }
+    tcp::resolver resolver{connection.ioc_};
+    auto &tcp_stream = beast::get_lowest_layer(*connection.stream_);
+    tcp_stream.expires_after(kRequestTimeout);
+    tcp_stream.connect(resolver.resolve(host_, port_));
+    tcp_stream.socket().set_option(tcp::no_delay{true});
+    connection.stream_->handshake(ssl::stream_base::client);
+    ++connections_opened_;
+} // -----  end of method HttpsClient::Open  -----
+
+void HttpsClient::WaitForRateLimit()
+{
+    // even with no limit of our own, we may have been told to back off.
+
+    std::chrono::steady_clock::time_point start_at;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        start_at = std::max(std::chrono::steady_clock::now(), next_request_at_);
+        next_request_at_ = start_at + request_spacing_;
+    }
+    std::this_thread::sleep_until(start_at);
+} // -----  end of method HttpsClient::WaitForRateLimit  -----
+
+void HttpsClient::BackOff(std::chrono::milliseconds delay)
+{
+    // the server is telling all of us to slow down, not just this request.
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    next_request_at_ = std::max(next_request_at_, std::chrono::steady_clock::now() + delay);
+} // -----  end of method HttpsClient::BackOff  -----
+
+std::string HttpsClient::Get(const std::string &target)
+{
+    http::request<http::string_body> request{http::verb::get, target, 11};
+    request.set(http::field::host, host_);
+    request.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+    request.keep_alive(true);
+
+    for (int32_t attempt = 0;; ++attempt)
+    {
+        WaitForRateLimit();
+
+        auto connection = Borrow();
+        http::response<http::string_body> response;
+        try
+        {
+            // an idle connection may have been closed by the server since we last used
+            // it. We only find out when we use it so in that case, we go around again on
+            // a new connection.
+
+            const bool reused = connection->stream_ != nullptr;
+            try
+            {
+                if (!reused)
+                {
+                    Open(*connection);
+                }
+                beast::get_lowest_layer(*connection->stream_).expires_after(kRequestTimeout);
+                http::write(*connection->stream_, request);
+                beast::flat_buffer buffer;
+                http::read(*connection->stream_, buffer, response);
+            }
+            catch (const beast::system_error &)
+            {
+                if (!reused)
+                {
+                    throw;
+                }
+                Open(*connection);
+                response = {};
+                beast::flat_buffer buffer;
+                http::write(*connection->stream_, request);
+                http::read(*connection->stream_, buffer, response);
+            }
+        }
+        catch (...)
+        {
+            connection->stream_.reset();
+            GiveBack(std::move(connection));
+            throw;
+        }
+
+        if (!response.keep_alive())
+        {
+            connection->stream_.reset();
+        }
+        GiveBack(std::move(connection));
+
+        if (response.result() == http::status::too_many_requests && attempt < kMaxRateLimitRetries)
+        {
+            const auto delay = RetryDelay(response, attempt);
+            spdlog::info(std::format("Rate limited by: {}. Waiting {} before trying again.", host_, delay));
+            BackOff(delay);
+            continue;
+        }
+        if (response.result() != http::status::ok)
+        {
+            throw std::runtime_error(std::format("Request to: {} failed: {} {}", host_, response.result_int(),
+                                                 std::string{response.reason()}));
+        }
+        return std::move(response.body());
+    }
+} // -----  end of method HttpsClient::Get  -----
+
+std::vector<std::string> HttpsClient::GetMany(const std::vector<std::string> &targets)
+{
+    std::vector<std::string> responses(targets.size());
+    std::vector<std::exception_ptr> failures(targets.size());
+    RunConcurrently(targets.size(), max_connections_, [&](size_t i) {
+        try
+        {
+            responses[i] = Get(targets[i]);
+        }
+        catch (...)
+        {
+            failures[i] = std::current_exception();
+        }
+    });
+    for (const auto &failure : failures)
+    {
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+    return responses;
+} // -----  end of method HttpsClient::GetMany  -----
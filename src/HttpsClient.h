@@ -0,0 +1,172 @@
+// =====================================================================================
+//
+//       Filename:  HttpsClient.h
+//
+//    Description:  HTTPS GET requests to a single host over a pool of kept-alive
+//    connections.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 11:15 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _HTTPSCLIENT_INC_
+#define _HTTPSCLIENT_INC_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/ssl/ssl_stream.hpp>
+
+// runs fn(0) ... fn(count - 1) on up to max_threads threads and waits for them all.
+// fn must handle its own exceptions.
+
+template <typename Fn>
+void RunConcurrently(size_t count, int32_t max_threads, Fn fn)
+{
+    const auto thread_count = std::min(count, static_cast<size_t>(std::max(max_threads, 1)));
+    if (thread_count <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            fn(i);
+        }
+        return;
+    }
+    std::atomic<size_t> next = 0;
+    std::vector<std::jthread> workers;
+    workers.reserve(thread_count);
+    for (size_t t = 0; t < thread_count; ++t)
+    {
+        workers.emplace_back([&] {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                fn(i);
+            }
+        });
+    }
+}
+
+// =====================================================================================
+//        Class:  HttpsClient
+//  Description:  Get() can be called from any number of threads. Each call borrows
+//  an idle connection (or opens a new one if fewer than max_connections are open,
+//  otherwise waits for one) and puts it back when the response has been read so
+//  the next request skips the TCP and TLS handshakes.
+//
+//  A connection the server has closed while it was idle is re-opened and the
+//  request sent again.
+//
+//  If requests_per_second > 0, request starts are spaced out to stay under it.
+//  A '429 Too Many Requests' response is retried after the server's Retry-After
+//  (or an increasing delay if there isn't one). Any other response which isn't
+//  200 throws.
+// =====================================================================================
+
+class HttpsClient
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    HttpsClient(std::string host, std::string port, int32_t max_connections = 4, int32_t requests_per_second = 0);
+
+    HttpsClient(const HttpsClient &rhs) = delete;
+    HttpsClient(HttpsClient &&rhs) = delete;
+
+    ~HttpsClient();
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] int32_t MaxConnections() const
+    {
+        return max_connections_;
+    }
+    [[nodiscard]] int64_t ConnectionsOpened() const
+    {
+        return connections_opened_;
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    std::string Get(const std::string &target);
+
+    // responses are in the same order as targets. All the requests are made
+    // before the first failure, if any, is thrown.
+
+    std::vector<std::string> GetMany(const std::vector<std::string> &targets);
+
+    // ====================  OPERATORS     =======================================
+
+    HttpsClient &operator=(const HttpsClient &rhs) = delete;
+    HttpsClient &operator=(HttpsClient &&rhs) = delete;
+
+private:
+    using Stream = boost::beast::ssl_stream<boost::beast::tcp_stream>;
+
+    struct Connection
+    {
+        boost::asio::io_context ioc_;
+        std::unique_ptr<Stream> stream_;
+    };
+
+    [[nodiscard]] std::unique_ptr<Connection> Borrow();
+    void GiveBack(std::unique_ptr<Connection> connection);
+    void Open(Connection &connection);
+
+    void WaitForRateLimit();
+    void BackOff(std::chrono::milliseconds delay);
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::string host_;
+    std::string port_;
+    boost::asio::ssl::context ctx_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<std::unique_ptr<Connection>> idle_connections_;
+    int32_t open_connections_ = 0;
+    int32_t max_connections_;
+
+    std::chrono::steady_clock::duration request_spacing_{};
+    std::chrono::steady_clock::time_point next_request_at_{};
+
+    std::atomic<int64_t> connections_opened_ = 0;
+
+}; // -----  end of class HttpsClient  -----
+
+#endif // ----- #ifndef _HTTPSCLIENT_INC_  -----
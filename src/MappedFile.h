@@ -0,0 +1,172 @@
+// =====================================================================================
+//
+//       Filename:  MappedFile.h
+//
+//    Description:  Simple RAII wrapper for read-only memory mapped files.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 09:12 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _MAPPEDFILE_INC_
+#define _MAPPEDFILE_INC_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+// =====================================================================================
+//        Class:  MappedFile
+//  Description:  map an entire file into memory for reading. Empty files are
+//  allowed and simply produce an empty view.
+//
+//  This is header-only because it is used by both the PF_Chart library and the
+//  collector application.
+// =====================================================================================
+
+class MappedFile
+{
+public:
+    enum class Access : int32_t
+    {
+        e_Random,
+        e_Sequential
+    };
+
+    // ====================  LIFECYCLE     =======================================
+
+    MappedFile() = default;
+
+    explicit MappedFile(const fs::path &file_name, Access access = Access::e_Sequential)
+    {
+        const int fd = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Unable to open file: " + file_name.string());
+        }
+
+        struct stat file_info{};
+        if (::fstat(fd, &file_info) != 0)
+        {
+            const int save_errno = errno;
+            ::close(fd);
+            throw std::system_error(save_errno, std::generic_category(), "Unable to stat file: " + file_name.string());
+        }
+
+        size_ = static_cast<size_t>(file_info.st_size);
+        if (size_ > 0)
+        {
+            void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                const int save_errno = errno;
+                ::close(fd);
+                throw std::system_error(save_errno, std::generic_category(),
+                                        "Unable to memory map file: " + file_name.string());
+            }
+            data_ = static_cast<const char *>(mapped);
+            ::madvise(mapped, size_, access == Access::e_Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+        }
+
+        // the mapping stays valid after the descriptor is closed.
+
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile &rhs) = delete;
+    MappedFile(MappedFile &&rhs) noexcept
+        : data_{std::exchange(rhs.data_, nullptr)}, size_{std::exchange(rhs.size_, 0)}
+    {
+    }
+
+    ~MappedFile()
+    {
+        Unmap();
+    }
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] const char *data() const
+    {
+        return data_;
+    }
+    [[nodiscard]] size_t size() const
+    {
+        return size_;
+    }
+    [[nodiscard]] bool empty() const
+    {
+        return size_ == 0;
+    }
+    [[nodiscard]] std::string_view AsStringView() const
+    {
+        return {data_, size_};
+    }
+
+    // ====================  OPERATORS     =======================================
+
+    MappedFile &operator=(const MappedFile &rhs) = delete;
+    MappedFile &operator=(MappedFile &&rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Unmap();
+            data_ = std::exchange(rhs.data_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+private:
+    void Unmap()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<char *>(data_), size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    // ====================  DATA MEMBERS  =======================================
+
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+
+}; // -----  end of class MappedFile  -----
+
+#endif // ----- #ifndef _MAPPEDFILE_INC_  -----
@@ -0,0 +1,498 @@
+// =====================================================================================
+//
+//       Filename:  PF_Benchmarks.cpp
+//
+//    Description:  Benchmarks for the core Point & Figure code using made up
+//    but repeatable price data.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 04:30 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+// every benchmark uses fixed seeds so runs can be compared with each other.
+// Build with makefile_bench and run ./PF_Benchmarks [--benchmark_filter=<regex>].
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <decimal.hh>
+
+#include "Boxes.h"
+#include "Eodhd.h"
+#include "FramePool.h"
+#include "PF_Chart.h"
+#include "PF_ChartQuery.h"
+#include "PF_Conflation.h"
+#include "PF_SignalBus.h"
+#include "PF_Signals.h"
+#include "SyntheticPrices.h"
+#include "Tiingo.h"
+
+namespace
+{
+constexpr uint64_t kSeed = 20261019;
+constexpr size_t kPricesPerChart = 10'000;
+
+struct PriceSeries
+{
+    std::vector<decimal::Decimal> prices_;
+    std::vector<PF_Column::TmPt> times_;
+};
+
+// 1 second data for a fairly volatile stock starting at $100.
+
+PriceSeries MakePriceSeries(size_t count, uint64_t seed)
+{
+    GBMPrices generator{100.0, 0.05, 0.40, 252.0 * 23'400.0, seed};
+
+    PriceSeries result;
+    result.prices_.reserve(count);
+    result.times_.reserve(count);
+
+    auto the_time = std::chrono::clock_cast<std::chrono::utc_clock>(
+        std::chrono::sys_days{std::chrono::year{2026} / std::chrono::October / 19} + std::chrono::hours{14});
+    for (size_t i = 0; i < count; ++i)
+    {
+        result.prices_.push_back(decimal::Decimal{generator.NextPriceCents()}.scaleb(decimal::Decimal{-2}));
+        result.times_.push_back(the_time);
+        the_time += std::chrono::seconds{1};
+    }
+    return result;
+}
+
+const PriceSeries &SharedPriceSeries()
+{
+    static const PriceSeries series = MakePriceSeries(kPricesPerChart, kSeed);
+    return series;
+}
+
+PF_Chart MakeChart(BoxScale box_scale, int32_t reversal, const std::string &symbol = "BENCH")
+{
+    const decimal::Decimal box_size{box_scale == BoxScale::e_Linear ? "0.10" : "0.001"};
+    return PF_Chart{symbol, box_size, reversal, 0, box_scale};
+}
+
+PF_Chart MakeLoadedChart(BoxScale box_scale, int32_t reversal, const std::string &symbol = "BENCH")
+{
+    const auto &series = SharedPriceSeries();
+    PF_Chart chart = MakeChart(box_scale, reversal, symbol);
+    for (size_t i = 0; i < series.prices_.size(); ++i)
+    {
+        chart.AddValue(series.prices_[i], series.times_[i]);
+    }
+    return chart;
+}
+
+// messages in the same format the tick server sends.
+
+std::vector<std::string> MakeStreamedMessages(bool tiingo, size_t count)
+{
+    RandomWalkPrices prices{1, 10'000, 5, kSeed};
+    std::vector<std::string> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto price = CentsToPriceString(prices.NextPriceCents(0));
+        if (tiingo)
+        {
+            result.push_back(std::format(
+                R"({{"messageType":"A","service":"iex","data":["2026-10-19T14:30:{:02}.{:09}+00:00","aapl",{}]}})",
+                i % 60, i, price));
+        }
+        else
+        {
+            result.push_back(std::format(R"({{"s":"AAPL","p":{},"c":[12,37],"v":100,"dp":false,"ms":"open","t":{}}})",
+                                         price, 1'792'420'200'000 + i));
+        }
+    }
+    return result;
+}
+} // namespace
+
+// ===================  PF_Chart::AddValue  ===============================
+
+static void BM_AddValue(benchmark::State &state)
+{
+    const auto box_scale = static_cast<BoxScale>(state.range(0));
+    const auto reversal = static_cast<int32_t>(state.range(1));
+    const auto &series = SharedPriceSeries();
+
+    for (auto _ : state)
+    {
+        PF_Chart chart = MakeChart(box_scale, reversal);
+        for (size_t i = 0; i < series.prices_.size(); ++i)
+        {
+            benchmark::DoNotOptimize(chart.AddValue(series.prices_[i], series.times_[i]));
+        }
+        state.counters["columns"] = static_cast<double>(chart.size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(series.prices_.size()));
+}
+BENCHMARK(BM_AddValue)
+    ->ArgNames({"percent", "reversal"})
+    ->ArgsProduct({{std::to_underlying(BoxScale::e_Linear), std::to_underlying(BoxScale::e_Percent)}, {1, 2, 3}})
+    ->Unit(benchmark::kMillisecond);
+
+// feed the same prices in backlogs of 'backlog' ticks, conflated once the chart has a
+// direction. The result must have the same columns as the chart built from every tick.
+
+static void BM_ConflatedAddValue(benchmark::State &state)
+{
+    const auto box_scale = static_cast<BoxScale>(state.range(0));
+    const auto reversal = static_cast<int32_t>(state.range(1));
+    const auto backlog = static_cast<size_t>(state.range(2));
+    const auto &series = SharedPriceSeries();
+    const auto expected = MakeLoadedChart(box_scale, reversal);
+
+    auto price = [&series](size_t i) -> const decimal::Decimal & { return series.prices_[i]; };
+
+    size_t kept = 0;
+    for (auto _ : state)
+    {
+        PF_Chart chart = MakeChart(box_scale, reversal);
+        kept = 0;
+        size_t next = 0;
+        for (; next < series.prices_.size() && chart.GetCurrentDirection() == PF_Column::Direction::e_Unknown; ++next)
+        {
+            chart.AddValue(series.prices_[next], series.times_[next]);
+            ++kept;
+        }
+        for (size_t first = next; first < series.prices_.size(); first += backlog)
+        {
+            std::vector<size_t> ticks(std::min(backlog, series.prices_.size() - first));
+            std::iota(ticks.begin(), ticks.end(), first);
+            for (const auto i : ConflateTicks(std::move(ticks), price))
+            {
+                benchmark::DoNotOptimize(chart.AddValue(series.prices_[i], series.times_[i]));
+                ++kept;
+            }
+        }
+        if (!std::equal(chart.begin(), chart.end(), expected.begin(), expected.end()))
+        {
+            state.SkipWithError("Conflated chart has different columns from unconflated chart.");
+            break;
+        }
+    }
+    state.counters["kept"] = static_cast<double>(kept) / static_cast<double>(series.prices_.size());
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(series.prices_.size()));
+}
+BENCHMARK(BM_ConflatedAddValue)
+    ->ArgNames({"percent", "reversal", "backlog"})
+    ->ArgsProduct({{std::to_underlying(BoxScale::e_Linear), std::to_underlying(BoxScale::e_Percent)},
+                   {2, 3},
+                   {1, 10, 100}})
+    ->Unit(benchmark::kMillisecond);
+
+// ===================  Boxes  ============================================
+
+// range(0) is the number of boxes already in the ladder.
+
+static void BM_FindBox(benchmark::State &state)
+{
+    const auto ladder_size = state.range(0);
+    Boxes boxes{decimal::Decimal{"0.10"}};
+    const decimal::Decimal low{"100.00"};
+    const decimal::Decimal high = low + decimal::Decimal{ladder_size} * decimal::Decimal{"0.10"};
+    boxes.FindBox(low);
+    boxes.FindBox(high);
+
+    GBMPrices generator{dec2dbl(low + high) / 2.0, 0.0, 0.20, 252.0, kSeed};
+    std::vector<decimal::Decimal> lookups;
+    for (int i = 0; i < 1'000; ++i)
+    {
+        auto value = decimal::Decimal{generator.NextPriceCents()}.scaleb(decimal::Decimal{-2});
+        lookups.push_back(value < low ? low : value > high ? high : value);
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto &value : lookups)
+        {
+            benchmark::DoNotOptimize(boxes.FindBox(value));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(lookups.size()));
+}
+BENCHMARK(BM_FindBox)->RangeMultiplier(4)->Range(64, 16'384);
+
+static void BM_FindNextBox(benchmark::State &state)
+{
+    const auto ladder_size = state.range(0);
+    Boxes boxes{decimal::Decimal{"0.10"}};
+    const decimal::Decimal low{"100.00"};
+    const decimal::Decimal high = low + decimal::Decimal{ladder_size} * decimal::Decimal{"0.10"};
+    boxes.FindBox(low);
+    boxes.FindBox(high);
+
+    // walk the ladder from bottom to top, staying inside what is already there.
+
+    const Boxes &ladder = boxes;
+    for (auto _ : state)
+    {
+        decimal::Decimal box = low;
+        for (int64_t i = 0; i < ladder_size - 1; ++i)
+        {
+            box = ladder.FindNextBox(box);
+        }
+        benchmark::DoNotOptimize(box);
+    }
+    state.SetItemsProcessed(state.iterations() * (ladder_size - 1));
+}
+BENCHMARK(BM_FindNextBox)->RangeMultiplier(4)->Range(64, 16'384);
+
+// ===================  signals  ==========================================
+
+static void BM_LookForNewSignal(benchmark::State &state)
+{
+    const PF_Chart chart = MakeLoadedChart(BoxScale::e_Linear, static_cast<int32_t>(state.range(0)));
+    const auto next = MakePriceSeries(1'000, kSeed + 1);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < next.prices_.size(); ++i)
+        {
+            benchmark::DoNotOptimize(LookForNewSignal(chart, next.prices_[i], next.times_[i]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(next.prices_.size()));
+}
+BENCHMARK(BM_LookForNewSignal)->Arg(1)->Arg(3);
+
+// ===================  serialization  ====================================
+
+static void BM_ToJSON(benchmark::State &state)
+{
+    const PF_Chart chart = MakeLoadedChart(static_cast<BoxScale>(state.range(0)), 3);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(chart.ToJSON());
+    }
+    state.counters["columns"] = static_cast<double>(chart.size());
+}
+BENCHMARK(BM_ToJSON)
+    ->Arg(std::to_underlying(BoxScale::e_Linear))
+    ->Arg(std::to_underlying(BoxScale::e_Percent))
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_FromJSON(benchmark::State &state)
+{
+    const Json::Value json = MakeLoadedChart(static_cast<BoxScale>(state.range(0)), 3).ToJSON();
+    for (auto _ : state)
+    {
+        PF_Chart chart{json};
+        benchmark::DoNotOptimize(chart);
+    }
+}
+BENCHMARK(BM_FromJSON)
+    ->Arg(std::to_underlying(BoxScale::e_Linear))
+    ->Arg(std::to_underlying(BoxScale::e_Percent))
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_JSONRoundTrip(benchmark::State &state)
+{
+    const PF_Chart chart = MakeLoadedChart(BoxScale::e_Linear, 3);
+    int64_t bytes = 0;
+    for (auto _ : state)
+    {
+        std::ostringstream out;
+        chart.ConvertChartToJsonAndWriteToStream(out);
+
+        Json::Value json;
+        Json::CharReaderBuilder builder;
+        const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+        const std::string text = std::move(out).str();
+        JSONCPP_STRING err;
+        reader->parse(text.data(), text.data() + text.size(), &json, &err);
+
+        PF_Chart loaded{json};
+        benchmark::DoNotOptimize(loaded);
+        bytes += static_cast<int64_t>(text.size());
+    }
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_JSONRoundTrip)->Unit(benchmark::kMicrosecond);
+
+static void BM_ConvertChartToTable(benchmark::State &state)
+{
+    const PF_Chart chart = MakeLoadedChart(BoxScale::e_Linear, 3);
+    for (auto _ : state)
+    {
+        std::ostringstream out;
+        chart.ConvertChartToTableAndWriteToStream(out, X_AxisFormat::e_show_time);
+        benchmark::DoNotOptimize(out);
+    }
+}
+BENCHMARK(BM_ConvertChartToTable)->Unit(benchmark::kMicrosecond);
+
+// ===================  chart queries  ====================================
+
+// what a client of the query socket waits for, less the socket round trip.
+// Arg is the number of symbols (with 2 charts each) being streamed.
+
+static void BM_ChartQuery(benchmark::State &state, const char *request)
+{
+    PF_ChartQuery query;
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+        const auto symbol = std::format("SYM{}", i);
+        query.AddChart(MakeLoadedChart(BoxScale::e_Linear, 1, symbol));
+        query.AddChart(MakeLoadedChart(BoxScale::e_Linear, 3, symbol));
+    }
+    int64_t bytes = 0;
+    for (auto _ : state)
+    {
+        const auto response = query.Answer(request);
+        bytes += static_cast<int64_t>(response.size());
+        benchmark::DoNotOptimize(response);
+    }
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK_CAPTURE(BM_ChartQuery, chart, "chart SYM0 10")->Arg(100)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ChartQuery, signals, "signals any 2026-10-19T16:30:00Z")
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMicrosecond);
+
+// ===================  signal bus  =======================================
+
+// publish to every sink seeing the event. Arg is the number of callback sinks.
+
+static void BM_SignalBusDelivery(benchmark::State &state)
+{
+    std::atomic<int64_t> delivered = 0;
+    PF_SignalBus bus{1024};
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+        bus.AddSink(std::make_unique<PF_SignalCallbackSink>(
+            std::format("callback {}", i), [&delivered](const PF_SignalEvent &) { delivered.fetch_add(1); }));
+    }
+    bus.Start();
+
+    const auto chart = MakeLoadedChart(BoxScale::e_Linear, 1, "SYM0");
+    const auto event = MakeSignalEvent(chart, chart.GetSignals().back(), std::chrono::steady_clock::now());
+    int64_t expected = 0;
+    for (auto _ : state)
+    {
+        bus.Publish(event);
+        expected += state.range(0);
+        while (delivered.load() < expected)
+        {
+        }
+    }
+    bus.Stop();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SignalBusDelivery)->Arg(1)->Arg(4)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// ===================  streamed data parsing  ============================
+
+static void BM_TiingoExtractStreamedData(benchmark::State &state)
+{
+    Tiingo tiingo;
+    const auto messages = MakeStreamedMessages(true, 1'000);
+    for (auto _ : state)
+    {
+        for (const auto &message : messages)
+        {
+            benchmark::DoNotOptimize(tiingo.ExtractStreamedData(message));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(messages.size()));
+}
+BENCHMARK(BM_TiingoExtractStreamedData);
+
+static void BM_EodhdExtractStreamedData(benchmark::State &state)
+{
+    Eodhd eodhd;
+    const auto messages = MakeStreamedMessages(false, 1'000);
+    for (auto _ : state)
+    {
+        for (const auto &message : messages)
+        {
+            benchmark::DoNotOptimize(eodhd.ExtractStreamedData(message));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(messages.size()));
+}
+BENCHMARK(BM_EodhdExtractStreamedData);
+
+// what it costs to get a frame from the websocket reader to the parser and back:
+// fill a pooled frame, queue it, take the queue and look at each frame in place.
+// buffers_created should stay at the batch size however many iterations run.
+
+static void BM_StreamedFrameHandoff(benchmark::State &state)
+{
+    const auto messages = MakeStreamedMessages(false, static_cast<size_t>(state.range(0)));
+    FramePool frame_pool;
+    std::vector<RemoteDataSource::StreamedFrame> queued;
+    std::vector<RemoteDataSource::StreamedFrame> taken;
+    for (auto _ : state)
+    {
+        for (const auto &message : messages)
+        {
+            auto frame = frame_pool.Acquire();
+            frame.Assign(message);
+            queued.push_back({.data_ = std::move(frame), .received_at_ = std::chrono::steady_clock::now()});
+        }
+        taken.clear();
+        taken.swap(queued);
+        for (auto &frame : taken)
+        {
+            auto parsed = std::move(frame.data_);
+            benchmark::DoNotOptimize(parsed.View().size());
+        }
+    }
+    state.counters["buffers_created"] = static_cast<double>(frame_pool.BuffersCreated());
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(messages.size()));
+}
+BENCHMARK(BM_StreamedFrameHandoff)->Arg(1)->Arg(100);
+
+int main(int argc, char **argv)
+{
+    // same decimal setup as the application.
+
+    decimal::context_template = decimal::IEEEContext(decimal::DECIMAL64);
+    decimal::context_template.round(decimal::ROUND_HALF_UP);
+    decimal::context = decimal::context_template;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
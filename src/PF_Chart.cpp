@@ -39,6 +39,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <utility>
 
 namespace rng = std::ranges;
@@ -48,6 +49,9 @@ namespace vws = std::ranges::views;
 
 using namespace std::string_literals;
 
+#include "CSVScanner.h"
+#include "DateTimeParsing.h"
+#include "MappedFile.h"
 #include "PF_Chart.h"
 #include "PF_Column.h"
 #include "PF_Signals.h"
@@ -360,20 +364,33 @@ std::optional<StreamedPrices> PF_Chart::BuildChartFromCSVStream(std::istream *in
                                                                 std::string_view delim,
                                                                 PF_CollectAndReturnStreamedPrices return_streamed_data)
 {
+    // read everything in 1 go then scan it in memory.
+
+    const std::string buffer{std::istreambuf_iterator<char>{*input_data}, std::istreambuf_iterator<char>{}};
+
+    return BuildChartFromCSVData(buffer, date_format, delim, return_streamed_data);
+} // -----  end of method PF_Chart::BuildChartFromCSVStream  -----
+
+std::optional<StreamedPrices> PF_Chart::BuildChartFromCSVData(std::string_view input_data,
+                                                              std::string_view date_format, std::string_view delim,
+                                                              PF_CollectAndReturnStreamedPrices return_streamed_data)
+{
+    BOOST_ASSERT_MSG(delim.size() == 1, std::format("CSV delimiter must be a single character: '{}'", delim).c_str());
+
     StreamedPrices streamed_prices;
 
-    std::string buffer;
-    while (!input_data->eof())
+    const auto which_format = ClassifyDateTimeFormat(date_format);
+
+    CSVScanner scanner{input_data, delim.front()};
+    while (scanner.NextRecord())
     {
-        buffer.clear();
-        std::getline(*input_data, buffer);
-        if (input_data->fail())
-        {
-            continue;
-        }
-        auto fields = split_string<std::string_view>(buffer, delim);
-        decimal::Decimal new_value{std::string{fields[1]}};
-        auto timept = StringToUTCTimePoint(date_format, fields[0]);
+        BOOST_ASSERT_MSG(scanner.FieldCount() >= 2,
+                         std::format("Expected 'date{}price' but found: '{}'", delim, scanner.Record()).c_str());
+
+        const auto new_value = FieldToDecimal(scanner.Field(1));
+        const auto timept = which_format != DateTimeFormat::e_unknown
+                                ? ParseUTCTimePoint(which_format, scanner.Field(0))
+                                : ParseUTCTimePoint(date_format, scanner.Field(0));
 
         auto chart_changed = AddValue(new_value, timept);
 
@@ -406,20 +423,17 @@ std::optional<StreamedPrices> PF_Chart::BuildChartFromCSVStream(std::istream *in
         return streamed_prices;
     }
     return {};
-} // -----  end of method PF_Chart::BuildChartFromCSVStream  -----
+} // -----  end of method PF_Chart::BuildChartFromCSVData  -----
 
 std::optional<StreamedPrices> PF_Chart::BuildChartFromCSVFile(const std::string &file_name,
                                                               std::string_view date_format, std::string_view delim,
                                                               PF_CollectAndReturnStreamedPrices return_streamed_data)
 {
-    std::ifstream data_file{fs::path{file_name}, std::ios::in | std::ios::binary};
-    BOOST_ASSERT_MSG(data_file.is_open(), std::format("Unable to open data file: {}", file_name).c_str());
-
-    const auto streamed_prices = BuildChartFromCSVStream(&data_file, date_format, delim, return_streamed_data);
+    // the whole file is mapped into memory so there is no copying or per line allocation.
 
-    data_file.close();
+    const MappedFile data_file{fs::path{file_name}, MappedFile::Access::e_Sequential};
 
-    return streamed_prices;
+    return BuildChartFromCSVData(data_file.AsStringView(), date_format, delim, return_streamed_data);
 } // -----  end of method PF_Chart::BuildChartFromCSVFile  -----
 
 std::optional<StreamedPrices> PF_Chart::BuildChartFromPricesDB(const PF_DB::DB_Params &db_params,
@@ -445,20 +459,12 @@ std::optional<StreamedPrices> PF_Chart::BuildChartFromPricesDB(const PF_DB::DB_P
 
     // right now, DB only has eod data.
 
-    const auto *dt_format = "%F";
-
-    std::istringstream time_stream;
-    std::chrono::utc_time<std::chrono::utc_clock::duration> tp;
-
     // we know our database contains 'date's, but we need timepoints.
     // we'll handle that in the conversion routine below.
 
-    auto Row2Closing = [dt_format, &time_stream, &tp](const auto &r) {
-        time_stream.clear();
-        time_stream.str(std::string{std::get<0>(r)});
-        std::chrono::from_stream(time_stream, dt_format, tp);
-        std::chrono::utc_time<std::chrono::utc_clock::duration> tp1{tp.time_since_epoch()};
-        DateCloseRecord new_data{.date_ = tp1, .close_ = decimal::Decimal{std::get<1>(r)}};
+    auto Row2Closing = [](const auto &r) {
+        DateCloseRecord new_data{.date_ = DateToUTCTimePoint(std::get<0>(r)),
+                                 .close_ = decimal::Decimal{std::get<1>(r)}};
         return new_data;
     };
 
@@ -471,11 +477,11 @@ std::optional<StreamedPrices> PF_Chart::BuildChartFromPricesDB(const PF_DB::DB_P
         {
             // std::cout << "new value: " << new_price << "\t" <<
             // new_date << std::endl;
-            auto chart_changed = AddValue(new_price, std::chrono::clock_cast<std::chrono::utc_clock>(new_date));
+            auto chart_changed = AddValue(new_price, new_date);
             if (return_streamed_data == PF_CollectAndReturnStreamedPrices::e_yes)
             {
                 streamed_prices.timestamp_seconds_.push_back(
-                    std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count());
+                    std::chrono::duration_cast<std::chrono::seconds>(new_date.time_since_epoch()).count());
                 streamed_prices.price_.push_back(dec2dbl(new_price));
                 streamed_prices.signal_type_.push_back(chart_changed == PF_Column::Status::e_AcceptedWithSignal
                                                            ? std::to_underlying(GetSignals().back().signal_type_)
@@ -687,6 +693,25 @@ void PF_Chart::UpdateChartInChartsDB(const PF_DB &chart_db, std::string_view int
     chart_db.UpdatePFChartDataInDB(*this, interval, cvs_graphics);
 } // -----  end of method PF_Chart::StoreChartInChartsDB  -----
 
+void PF_Chart::UpsertChartsInChartsDB(const PF_DB &chart_db, const std::vector<const PF_Chart *> &charts,
+                                      std::string_view interval, X_AxisFormat date_or_time, bool store_cvs_graphics)
+{
+    std::vector<PF_DB::ChartForDB> charts_for_db;
+    charts_for_db.reserve(charts.size());
+    for (const PF_Chart *chart : charts)
+    {
+        std::string cvs_graphics;
+        if (store_cvs_graphics)
+        {
+            std::ostringstream oss{};
+            chart->ConvertChartToTableAndWriteToStream(oss, date_or_time);
+            cvs_graphics = oss.str();
+        }
+        charts_for_db.emplace_back(chart, std::move(cvs_graphics));
+    }
+    chart_db.UpsertPFChartsInDB(charts_for_db, interval);
+} // -----  end of method PF_Chart::UpsertChartsInChartsDB  -----
+
 Json::Value PF_Chart::ToJSON() const
 {
     Json::Value result;
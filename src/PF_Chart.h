@@ -54,6 +54,7 @@
 #include <vector>
 
 #include "Boxes.h"
+#include "DateTimeParsing.h"
 #include "PF_Column.h"
 #include "PF_Signals.h"
 #include "PointAndFigureDB.h"
@@ -278,6 +279,12 @@ public:
                                X_AxisFormat date_or_time = X_AxisFormat::e_show_date,
                                bool store_cvs_graphics = false) const;
 
+    // store many charts at once. Existing charts are replaced.
+
+    static void UpsertChartsInChartsDB(const PF_DB &chart_db, const std::vector<const PF_Chart *> &charts,
+                                       std::string_view interval, X_AxisFormat date_or_time = X_AxisFormat::e_show_date,
+                                       bool store_cvs_graphics = false);
+
     [[nodiscard]] Json::Value ToJSON() const;
     [[nodiscard]] bool IsPercent() const
     {
@@ -341,7 +348,7 @@ public:
     PF_Column::Status AddValue(const decimal::Decimal &new_value, PF_Column::TmPt the_time);
     PF_Column::Status AddValue(std::string_view new_value, std::string_view time_value, std::string_view time_format)
     {
-        return AddValue(sv2dec(new_value), StringToUTCTimePoint(time_format, time_value));
+        return AddValue(sv2dec(new_value), ParseUTCTimePoint(time_format, time_value));
     }
     // for Python - value as floating point and time in seconds
     PF_Column::Status AddValue(double new_value, int64_t the_time)
@@ -352,6 +359,12 @@ public:
         std::istream *input_data, std::string_view date_format, std::string_view delim,
         PF_CollectAndReturnStreamedPrices return_streamed_data = PF_CollectAndReturnStreamedPrices::e_no);
 
+    // 'date,price' records already in memory (for example, a memory mapped file).
+
+    std::optional<StreamedPrices> BuildChartFromCSVData(
+        std::string_view input_data, std::string_view date_format, std::string_view delim,
+        PF_CollectAndReturnStreamedPrices return_streamed_data = PF_CollectAndReturnStreamedPrices::e_no);
+
     std::optional<StreamedPrices> BuildChartFromCSVFile(
         const std::string &file_name, std::string_view date_format, std::string_view delim,
         PF_CollectAndReturnStreamedPrices return_streamed_data = PF_CollectAndReturnStreamedPrices::e_no);
@@ -0,0 +1,348 @@
+// =====================================================================================
+//
+//       Filename:  PF_ChartQuery.cpp
+//
+//    Description:  Answers questions about the current state of streamed charts
+//    over a local socket without getting in the way of the threads updating them.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 08:30 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+
+#include <boost/assert.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include "DateTimeParsing.h"
+#include "PF_ChartQuery.h"
+
+namespace rng = std::ranges;
+
+namespace
+{
+// we don't send whole charts, just the end of them.
+
+constexpr int32_t kDefaultColumns = 5;
+constexpr int32_t kMaxColumns = 100;
+constexpr size_t kMaxBoxLevels = 500;
+
+// error messages can echo back what we were sent so they need escaping.
+
+std::string ErrorResponse(std::string_view message)
+{
+    std::string escaped;
+    escaped.reserve(message.size());
+    for (const char c : message)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += static_cast<unsigned char>(c) < 0x20 ? ' ' : c;
+    }
+    return std::format(R"({{"status":"error","message":"{}"}})", escaped);
+}
+
+// the request is split on spaces. Only symbols, names, numbers and dates are
+// expected so nothing needs to be escaped on the way back.
+
+std::vector<std::string_view> SplitRequest(std::string_view request)
+{
+    std::vector<std::string_view> words;
+    while (!request.empty())
+    {
+        const auto start = request.find_first_not_of(' ');
+        if (start == std::string_view::npos)
+        {
+            break;
+        }
+        request.remove_prefix(start);
+        const auto end = std::min(request.find(' '), request.size());
+        words.push_back(request.substr(0, end));
+        request.remove_prefix(end);
+    }
+    return words;
+}
+
+void AppendSignal(std::string &response, const PF_Signal &signal)
+{
+    std::format_to(std::back_inserter(response), R"({{"type":"{}","category":"{}","time":"{:%FT%TZ}","price":{},)"
+                   R"("box":{},"column":{}}})",
+                   signal.signal_type_, signal.signal_category_ == PF_SignalCategory::e_PF_Buy ? "buy" : "sell",
+                   signal.tpt_, signal.signal_price_.format("f"), signal.box_.format("f"), signal.column_number_);
+}
+
+// 'any', 'buy', 'sell' or one signal type by name.
+
+std::optional<std::function<bool(const PF_Signal &)>> MakeSignalFilter(std::string_view which_signals)
+{
+    if (which_signals == "any")
+    {
+        return [](const PF_Signal &) { return true; };
+    }
+    if (which_signals == "buy" || which_signals == "sell")
+    {
+        const auto category = which_signals == "buy" ? PF_SignalCategory::e_PF_Buy : PF_SignalCategory::e_PF_Sell;
+        return [category](const PF_Signal &signal) { return signal.signal_category_ == category; };
+    }
+    for (auto type = std::to_underlying(PF_SignalType::e_double_top_buy);
+         type <= std::to_underlying(PF_SignalType::e_tbottom_catapult_sell); ++type)
+    {
+        if (std::format("{}", static_cast<PF_SignalType>(type)) == which_signals)
+        {
+            return [signal_type = static_cast<PF_SignalType>(type)](const PF_Signal &signal) {
+                return signal.signal_type_ == signal_type;
+            };
+        }
+    }
+    return std::nullopt;
+}
+} // namespace
+
+PF_ChartQuery::~PF_ChartQuery()
+{
+    Stop();
+} // -----  end of method PF_ChartQuery::~PF_ChartQuery  (destructor)  -----
+
+void PF_ChartQuery::AddChart(const PF_Chart &chart)
+{
+    BOOST_ASSERT_MSG(!server_, "Charts must be added before starting to answer queries.");
+
+    auto &slot = slots_.emplace_back();
+    slot.symbol_ = chart.GetSymbol();
+    slot.chart_name_ = chart.GetChartBaseName();
+    slot.chart_ = std::make_shared<const PF_Chart>(chart);
+
+    slots_by_chart_name_[slot.chart_name_] = &slot;
+    slots_by_symbol_[slot.symbol_].push_back(&slot);
+} // -----  end of method PF_ChartQuery::AddChart  -----
+
+void PF_ChartQuery::Start(const fs::path &socket_path)
+{
+    server_ = std::make_unique<UnixSocketServer>(
+        socket_path, [this](std::string_view request, UnixSocketServer::Reply reply) { reply(Answer(request)); });
+    server_->Start();
+    spdlog::info(std::format("Answering chart queries for {} charts.", slots_.size()));
+} // -----  end of method PF_ChartQuery::Start  -----
+
+void PF_ChartQuery::Stop()
+{
+    if (server_)
+    {
+        server_->Stop();
+        server_.reset();
+    }
+} // -----  end of method PF_ChartQuery::Stop  -----
+
+void PF_ChartQuery::Publish(const std::string &chart_name, std::shared_ptr<const PF_Chart> chart)
+{
+    if (auto found = slots_by_chart_name_.find(chart_name); found != slots_by_chart_name_.end())
+    {
+        found->second->chart_.store(std::move(chart), std::memory_order_release);
+    }
+} // -----  end of method PF_ChartQuery::Publish  -----
+
+std::string PF_ChartQuery::Answer(std::string_view request) const
+{
+    const auto words = SplitRequest(request);
+    if (words.empty())
+    {
+        return ErrorResponse("empty request");
+    }
+    try
+    {
+        if (words[0] == "chart" && (words.size() == 2 || words.size() == 3))
+        {
+            int32_t how_many_columns = kDefaultColumns;
+            if (words.size() == 3)
+            {
+                const auto [ptr, ec] =
+                    std::from_chars(words[2].data(), words[2].data() + words[2].size(), how_many_columns);
+                if (ec != std::errc{} || ptr != words[2].data() + words[2].size() || how_many_columns < 1)
+                {
+                    return ErrorResponse("number of columns must be a positive number");
+                }
+            }
+            return AnswerChart(words[1], std::min(how_many_columns, kMaxColumns));
+        }
+        if (words[0] == "signals" && words.size() == 3)
+        {
+            return AnswerSignals(words[1], words[2]);
+        }
+        if (words[0] == "symbols" && words.size() == 1)
+        {
+            return AnswerSymbols();
+        }
+        if (words[0] == "help")
+        {
+            return R"({"status":"ok","commands":"chart SYMBOL [N] | signals any|buy|sell|SIGNAL_TYPE SINCE | )"
+                   R"(symbols"})";
+        }
+    }
+    catch (const std::exception &e)
+    {
+        return ErrorResponse(e.what());
+    }
+    return ErrorResponse("unknown or malformed request. Try 'help'.");
+} // -----  end of method PF_ChartQuery::Answer  -----
+
+std::string PF_ChartQuery::AnswerChart(std::string_view symbol, int32_t how_many_columns) const
+{
+    std::string upper_symbol{symbol};
+    rng::for_each(upper_symbol, [](char &c) { c = std::toupper(c); });
+
+    const auto found = slots_by_symbol_.find(upper_symbol);
+    if (found == slots_by_symbol_.end())
+    {
+        return ErrorResponse(std::format("no charts for symbol: {}", upper_symbol));
+    }
+
+    std::string response;
+    response.reserve(1024 * found->second.size());
+    std::format_to(std::back_inserter(response), R"({{"status":"ok","symbol":"{}","charts":[)", upper_symbol);
+
+    const char *chart_separator = "";
+    for (const Slot *slot : found->second)
+    {
+        const auto chart = slot->chart_.load(std::memory_order_acquire);
+
+        std::format_to(std::back_inserter(response),
+                       R"({}{{"chart":"{}","box_size":{},"reversal":{},"scale":"{}","direction":"{}",)"
+                       R"("last_change":"{:%FT%TZ}","columns_total":{},"last_signal":)",
+                       chart_separator, slot->chart_name_, chart->GetChartBoxSize().format("f"),
+                       chart->GetReversalboxes(), chart->GetBoxScale(), chart->GetCurrentDirection(),
+                       chart->GetLastChangeTime(), chart->empty() ? 0 : chart->size());
+        chart_separator = ",";
+
+        if (const auto signal = chart->GetMostRecentSignal(); signal)
+        {
+            AppendSignal(response, signal.value());
+        }
+        else
+        {
+            response += "null";
+        }
+
+        // the last N columns, oldest first, and the range of boxes they cover.
+
+        response += R"(,"columns":[)";
+        std::optional<decimal::Decimal> lowest;
+        std::optional<decimal::Decimal> highest;
+        if (!chart->empty())
+        {
+            const auto how_many = std::min(chart->size(), static_cast<size_t>(how_many_columns));
+            for (size_t which = chart->size() - how_many; which < chart->size(); ++which)
+            {
+                const auto &col = (*chart)[which];
+                if (col.IsEmpty())
+                {
+                    continue;
+                }
+                std::format_to(std::back_inserter(response),
+                               R"({}{{"column":{},"direction":"{}","bottom":{},"top":{},"reversal":{}}})",
+                               lowest ? "," : "", col.GetColumnNumber(), col.GetDirection(),
+                               col.GetBottom().format("f"), col.GetTop().format("f"), col.GetHadReversal());
+                lowest = lowest ? std::min(lowest.value(), col.GetBottom()) : col.GetBottom();
+                highest = highest ? std::max(highest.value(), col.GetTop()) : col.GetTop();
+            }
+        }
+        response += R"(],"boxes":[)";
+        if (lowest)
+        {
+            const auto &boxes = chart->GetBoxes().GetBoxList();
+            auto first = std::lower_bound(boxes.begin(), boxes.end(), lowest.value());
+            const auto last = std::upper_bound(first, boxes.end(), highest.value());
+            for (size_t count = 0; first != last && count < kMaxBoxLevels; ++first, ++count)
+            {
+                std::format_to(std::back_inserter(response), "{}{}", count > 0 ? "," : "", first->format("f"));
+            }
+        }
+        response += "]}";
+    }
+    response += "]}";
+    return response;
+} // -----  end of method PF_ChartQuery::AnswerChart  -----
+
+std::string PF_ChartQuery::AnswerSignals(std::string_view which_signals, std::string_view since) const
+{
+    const auto wanted = MakeSignalFilter(which_signals);
+    if (!wanted)
+    {
+        return ErrorResponse(std::format("unknown signal type: {}", which_signals));
+    }
+    const auto since_time = ParseUTCTimePoint(
+        since.size() > 10 ? DateTimeFormat::e_iso_date_time_zone : DateTimeFormat::e_date, since);
+
+    std::string response;
+    response.reserve(4096);
+    std::format_to(std::back_inserter(response), R"({{"status":"ok","since":"{:%FT%TZ}","signals":[)", since_time);
+
+    // signals are kept in the order they happened so we only look at the newest ones.
+
+    size_t matches = 0;
+    for (const auto &slot : slots_)
+    {
+        const auto chart = slot.chart_.load(std::memory_order_acquire);
+        const auto &signals = chart->GetSignals();
+        auto first_new = std::find_if(signals.rbegin(), signals.rend(),
+                                      [&since_time](const auto &signal) { return signal.tpt_ < since_time; })
+                             .base();
+        for (; first_new != signals.end(); ++first_new)
+        {
+            if (!wanted.value()(*first_new))
+            {
+                continue;
+            }
+            std::format_to(std::back_inserter(response), R"({}{{"symbol":"{}","chart":"{}","signal":)",
+                           matches > 0 ? "," : "", slot.symbol_, slot.chart_name_);
+            AppendSignal(response, *first_new);
+            response += '}';
+            ++matches;
+        }
+    }
+    std::format_to(std::back_inserter(response), R"(],"count":{}}})", matches);
+    return response;
+} // -----  end of method PF_ChartQuery::AnswerSignals  -----
+
+std::string PF_ChartQuery::AnswerSymbols() const
+{
+    std::string response{R"({"status":"ok","symbols":[)"};
+    for (const char *separator = ""; const auto &[symbol, slots] : slots_by_symbol_)
+    {
+        std::format_to(std::back_inserter(response), R"({}"{}")", separator, symbol);
+        separator = ",";
+    }
+    response += "]}";
+    return response;
+} // -----  end of method PF_ChartQuery::AnswerSymbols  -----
@@ -0,0 +1,135 @@
+// =====================================================================================
+//
+//       Filename:  PF_ChartQuery.h
+//
+//    Description:  Answers questions about the current state of streamed charts
+//    over a local socket without getting in the way of the threads updating them.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 08:30 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _PF_CHARTQUERY_INC_
+#define _PF_CHARTQUERY_INC_
+
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "PF_Chart.h"
+#include "UnixSocketServer.h"
+
+namespace fs = std::filesystem;
+
+// =====================================================================================
+//        Class:  PF_ChartQuery
+//  Description:  holds the newest published copy of every streamed chart.
+//
+//  Processor threads already make a read-only copy of each chart they change for
+//  the render thread. Publish() just swaps a pointer to that same copy into the
+//  chart's slot so the cost to the tick path is one atomic store. Queries load
+//  the pointer and work from that copy so they never wait for, or hold up, a
+//  processor thread.
+//
+//  The set of charts is fixed by AddChart() before Start(). After that, the
+//  lookup tables are only read.
+//
+//  Protocol: one request per line, one line of compact JSON back.
+//
+//      chart SYMBOL [N]        direction, last signal, last N columns (default 5)
+//                              and the box levels they span, for each of the
+//                              symbol's charts.
+//      signals TYPE SINCE      every chart with a signal of TYPE ('any', 'buy',
+//                              'sell' or a signal name such as double_top_buy) at
+//                              or after SINCE (YYYY-MM-DD or YYYY-MM-DDTHH:MM:SSZ).
+//      symbols                 the symbols we have charts for.
+//      help
+// =====================================================================================
+
+class PF_ChartQuery
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    PF_ChartQuery() = default;
+
+    PF_ChartQuery(const PF_ChartQuery &rhs) = delete;
+    PF_ChartQuery(PF_ChartQuery &&rhs) = delete;
+
+    ~PF_ChartQuery();
+
+    // ====================  ACCESSORS     =======================================
+
+    // public so it can be timed without a socket.
+
+    [[nodiscard]] std::string Answer(std::string_view request) const;
+
+    // ====================  MUTATORS      =======================================
+
+    void AddChart(const PF_Chart &chart);
+
+    void Start(const fs::path &socket_path);
+    void Stop();
+
+    // charts we weren't told about are ignored.
+
+    void Publish(const std::string &chart_name, std::shared_ptr<const PF_Chart> chart);
+
+    // ====================  OPERATORS     =======================================
+
+    PF_ChartQuery &operator=(const PF_ChartQuery &rhs) = delete;
+    PF_ChartQuery &operator=(PF_ChartQuery &&rhs) = delete;
+
+private:
+    struct Slot
+    {
+        std::string symbol_;
+        std::string chart_name_;
+        std::atomic<std::shared_ptr<const PF_Chart>> chart_;
+    };
+
+    [[nodiscard]] std::string AnswerChart(std::string_view symbol, int32_t how_many_columns) const;
+    [[nodiscard]] std::string AnswerSignals(std::string_view which_signals, std::string_view since) const;
+    [[nodiscard]] std::string AnswerSymbols() const;
+
+    // ====================  DATA MEMBERS  =======================================
+
+    // a deque so slots never move once added.
+
+    std::deque<Slot> slots_;
+    std::unordered_map<std::string, Slot *> slots_by_chart_name_;
+    std::map<std::string, std::vector<const Slot *>, std::less<>> slots_by_symbol_;
+
+    std::unique_ptr<UnixSocketServer> server_;
+
+}; // -----  end of class PF_ChartQuery  -----
+
+#endif // ----- #ifndef _PF_CHARTQUERY_INC_  -----
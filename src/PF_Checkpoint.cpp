@@ -0,0 +1,258 @@
+// =====================================================================================
+//
+//       Filename:  PF_Checkpoint.cpp
+//
+//    Description:  Snapshot of a streaming session (charts plus streamed prices
+//    and summary) so a restart can pick up where it left off.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 10:30 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <cstring>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include <json/json.h>
+
+#include <spdlog/spdlog.h>
+
+#include "MappedFile.h"
+#include "PF_Checkpoint.h"
+#include "PF_FileSink.h"
+
+namespace
+{
+constexpr char kMagic[8] = {'P', 'F', '_', 'C', 'K', 'P', 'T', '\0'};
+constexpr uint32_t kVersion = 1;
+
+// FNV-1a. Catches a damaged file, not a malicious one.
+
+uint64_t Checksum(std::string_view data)
+{
+    uint64_t hash = 14'695'981'039'346'656'037ULL;
+    for (const unsigned char c : data)
+    {
+        hash ^= c;
+        hash *= 1'099'511'628'211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+void Append(std::string &out, const T &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void AppendString(std::string &out, std::string_view value)
+{
+    Append(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+template <typename T>
+void AppendArray(std::string &out, const std::vector<T> &values)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    out.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+// walks the body of a checkpoint. Any attempt to read past the end throws.
+
+class BodyReader
+{
+public:
+    explicit BodyReader(std::string_view body) : body_{body} {}
+
+    std::string_view Take(size_t count)
+    {
+        if (count > body_.size() - offset_)
+        {
+            throw std::runtime_error("Checkpoint is truncated.");
+        }
+        const auto result = body_.substr(offset_, count);
+        offset_ += count;
+        return result;
+    }
+
+    template <typename T>
+    T Get()
+    {
+        T value;
+        std::memcpy(&value, Take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    std::string_view GetString()
+    {
+        return Take(Get<uint32_t>());
+    }
+
+    template <typename T>
+    void GetArray(std::vector<T> &values, size_t count)
+    {
+        const auto bytes = Take(count * sizeof(T));
+        values.resize(count);
+        std::memcpy(values.data(), bytes.data(), bytes.size());
+    }
+
+private:
+    std::string_view body_;
+    size_t offset_ = 0;
+};
+} // namespace
+
+PF_Checkpoint::PF_Checkpoint(fs::path checkpoint_file, std::chrono::sys_days session_day)
+    : checkpoint_file_{std::move(checkpoint_file)}, session_day_{session_day}
+{
+} // -----  end of method PF_Checkpoint::PF_Checkpoint  (constructor)  -----
+
+void PF_Checkpoint::UpdateChart(const PF_Chart &chart)
+{
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+
+    std::string record;
+    AppendString(record, chart.GetChartBaseName());
+    AppendString(record, Json::writeString(builder, chart.ToJSON()));
+    chart_records_[chart.GetChartBaseName()] = std::move(record);
+} // -----  end of method PF_Checkpoint::UpdateChart  -----
+
+void PF_Checkpoint::UpdateSymbol(const std::string &symbol, const SymbolPrices &prices, const SymbolSummary &summary)
+{
+    std::string record;
+    AppendString(record, symbol);
+    Append(record, summary.opening_price_);
+    Append(record, summary.latest_price_);
+    Append(record, static_cast<uint64_t>(prices.timestamp_seconds_.size()));
+    AppendArray(record, prices.timestamp_seconds_);
+    AppendArray(record, prices.price_);
+    AppendArray(record, prices.signal_type_);
+    symbol_records_[symbol] = std::move(record);
+} // -----  end of method PF_Checkpoint::UpdateSymbol  -----
+
+size_t PF_Checkpoint::Save()
+{
+    std::string body;
+    for (const auto &[chart_name, record] : chart_records_)
+    {
+        body.append(record);
+    }
+    for (const auto &[symbol, record] : symbol_records_)
+    {
+        body.append(record);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic_, kMagic, sizeof(header.magic_));
+    header.version_ = kVersion;
+    header.session_day_ = session_day_.time_since_epoch().count();
+    header.chart_count_ = static_cast<uint32_t>(chart_records_.size());
+    header.symbol_count_ = static_cast<uint32_t>(symbol_records_.size());
+    header.saved_at_ns_ =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::utc_clock::now().time_since_epoch()).count();
+    header.body_size_ = body.size();
+    header.body_checksum_ = Checksum(body);
+
+    std::string contents;
+    contents.reserve(sizeof(header) + body.size());
+    Append(contents, header);
+    contents.append(body);
+
+    ReplaceFile(checkpoint_file_, contents, true);
+    SyncDirectory(checkpoint_file_.parent_path());
+    ++save_count_;
+    return contents.size();
+} // -----  end of method PF_Checkpoint::Save  -----
+
+std::optional<PF_Checkpoint::Contents> PF_Checkpoint::Load(const fs::path &checkpoint_file,
+                                                          std::chrono::sys_days session_day)
+{
+    if (!fs::exists(checkpoint_file) || fs::file_size(checkpoint_file) < sizeof(FileHeader))
+    {
+        return std::nullopt;
+    }
+    const MappedFile file_content{checkpoint_file, MappedFile::Access::e_Sequential};
+    const auto data = file_content.AsStringView();
+
+    FileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic_, kMagic, sizeof(kMagic)) != 0 || header.version_ != kVersion)
+    {
+        spdlog::error(std::format("Checkpoint: {} is not a version {} checkpoint. Ignoring it.", checkpoint_file,
+                                  kVersion));
+        return std::nullopt;
+    }
+    if (header.session_day_ != session_day.time_since_epoch().count())
+    {
+        spdlog::info(std::format("Checkpoint: {} is from a different session day. Ignoring it.", checkpoint_file));
+        return std::nullopt;
+    }
+    const auto body = data.substr(sizeof(header));
+    if (body.size() != header.body_size_ || Checksum(body) != header.body_checksum_)
+    {
+        spdlog::error(std::format("Checkpoint: {} is damaged. Ignoring it.", checkpoint_file));
+        return std::nullopt;
+    }
+
+    Contents contents;
+    contents.saved_at_ = std::chrono::utc_time<std::chrono::nanoseconds>{std::chrono::nanoseconds{header.saved_at_ns_}};
+
+    BodyReader reader{body};
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> json_reader(builder.newCharReader());
+    for (uint32_t i = 0; i < header.chart_count_; ++i)
+    {
+        const std::string chart_name{reader.GetString()};
+        const auto chart_json = reader.GetString();
+
+        JSONCPP_STRING err;
+        Json::Value chart_data;
+        if (!json_reader->parse(chart_json.data(), chart_json.data() + chart_json.size(), &chart_data, &err))
+        {
+            throw std::runtime_error(std::format("Problem parsing chart: {} from checkpoint.\n{}", chart_name, err));
+        }
+        contents.charts_.emplace(chart_name, PF_Chart{chart_data});
+    }
+    for (uint32_t i = 0; i < header.symbol_count_; ++i)
+    {
+        const std::string symbol{reader.GetString()};
+        auto &summary = contents.streamed_summary_[symbol];
+        summary.opening_price_ = reader.Get<decltype(summary.opening_price_)>();
+        summary.latest_price_ = reader.Get<decltype(summary.latest_price_)>();
+
+        auto &prices = contents.streamed_prices_[symbol];
+        const auto count = reader.Get<uint64_t>();
+        reader.GetArray(prices.timestamp_seconds_, count);
+        reader.GetArray(prices.price_, count);
+        reader.GetArray(prices.signal_type_, count);
+    }
+    return contents;
+} // -----  end of method PF_Checkpoint::Load  -----
@@ -0,0 +1,141 @@
+// =====================================================================================
+//
+//       Filename:  PF_Checkpoint.h
+//
+//    Description:  Snapshot of a streaming session (charts plus streamed prices
+//    and summary) so a restart can pick up where it left off.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 10:30 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _PF_CHECKPOINT_INC_
+#define _PF_CHECKPOINT_INC_
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "PF_Chart.h"
+#include "utilities.h"
+
+namespace fs = std::filesystem;
+
+// =====================================================================================
+//        Class:  PF_Checkpoint
+//  Description:  keeps an encoded record for every chart and every symbol's
+//  streamed prices. Only the records which changed since the last Save() are
+//  encoded again. Save() writes all of them to a temporary file, syncs it and
+//  renames it over the checkpoint so after a crash we have either the previous
+//  checkpoint or the new one, never part of one.
+//
+//  File: header, then chart records (name, compact chart JSON), then symbol records
+//  (symbol, opening and latest price, then the timestamp, price and signal arrays
+//  as-is). The header has a checksum of everything after it.
+//
+//  A checkpoint belongs to 1 session day. Load() ignores one from any other day.
+// =====================================================================================
+
+class PF_Checkpoint
+{
+public:
+    using SymbolPrices = PF_StreamedPrices::mapped_type;
+    using SymbolSummary = PF_StreamedSummary::mapped_type;
+
+    struct Contents
+    {
+        std::map<std::string, PF_Chart> charts_; // by chart base name
+        PF_StreamedPrices streamed_prices_;
+        PF_StreamedSummary streamed_summary_;
+        std::chrono::utc_time<std::chrono::nanoseconds> saved_at_;
+    };
+
+    // ====================  LIFECYCLE     =======================================
+
+    PF_Checkpoint() = delete;
+    PF_Checkpoint(fs::path checkpoint_file, std::chrono::sys_days session_day);
+
+    PF_Checkpoint(const PF_Checkpoint &rhs) = delete;
+    PF_Checkpoint(PF_Checkpoint &&rhs) = delete;
+
+    ~PF_Checkpoint() = default;
+
+    // ====================  ACCESSORS     =======================================
+
+    // nothing if there is no checkpoint for session_day or it fails its checksum.
+
+    [[nodiscard]] static std::optional<Contents> Load(const fs::path &checkpoint_file,
+                                                      std::chrono::sys_days session_day);
+
+    [[nodiscard]] int64_t SaveCount() const
+    {
+        return save_count_;
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    void UpdateChart(const PF_Chart &chart);
+    void UpdateSymbol(const std::string &symbol, const SymbolPrices &prices, const SymbolSummary &summary);
+
+    // returns the size of the checkpoint written.
+
+    size_t Save();
+
+    // ====================  OPERATORS     =======================================
+
+    PF_Checkpoint &operator=(const PF_Checkpoint &rhs) = delete;
+    PF_Checkpoint &operator=(PF_Checkpoint &&rhs) = delete;
+
+    // storage format. Written to and read from disk as-is.
+
+    struct FileHeader
+    {
+        char magic_[8];
+        uint32_t version_;
+        int32_t session_day_; // days since epoch
+        uint32_t chart_count_;
+        uint32_t symbol_count_;
+        int64_t saved_at_ns_; // utc_clock
+        uint64_t body_size_;
+        uint64_t body_checksum_;
+    };
+
+private:
+    // ====================  DATA MEMBERS  =======================================
+
+    fs::path checkpoint_file_;
+    std::chrono::sys_days session_day_;
+
+    std::map<std::string, std::string> chart_records_;
+    std::map<std::string, std::string> symbol_records_;
+
+    int64_t save_count_ = 0;
+
+}; // -----  end of class PF_Checkpoint  -----
+
+#endif // ----- #ifndef _PF_CHECKPOINT_INC_  -----
@@ -32,12 +32,16 @@
 /* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <csignal>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <format>
 #include <fstream>
+#include <functional>
 #include <future>
 #include <iostream>
 #include <iterator>
@@ -58,11 +62,19 @@ namespace vws = std::ranges::views;
 #include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
+#include "CSVScanner.h"
 #include "ConstructChartGraphic.h"
+#include "DateTimeParsing.h"
 #include "Eodhd.h"
+#include "MappedFile.h"
 #include "PF_Chart.h"
 #include "PF_CollectDataApp.h"
 #include "PF_Column.h"
+#include "PF_Conflation.h"
+#include "PF_PriceCache.h"
+#include "PF_RunStats.h"
+#include "PF_Trace.h"
+#include "ReplayDataSource.h"
 #include "PointAndFigureDB.h"
 #include "Tiingo.h"
 #include "utilities.h"
@@ -71,7 +83,8 @@ using decimal::Decimal;
 
 using namespace std::string_literals;
 
-bool PF_CollectDataApp::had_signal_ = false;
+std::atomic<bool> PF_CollectDataApp::had_signal_ = false;
+std::atomic<bool> PF_CollectDataApp::stop_service_ = false;
 
 // code from "The C++ Programming Language" 4th Edition. p. 1243.
 
@@ -104,6 +117,63 @@ int wait_for_any(std::vector<std::future<T>> &vf, std::chrono::steady_clock::dur
     }
 }
 
+// the stock DB queries hand back converted rows so estimate the amount of text the
+// DB sent us: symbol, formatted date and price.
+
+int64_t EstimateFetchedBytes(const std::vector<MultiSymbolDateCloseRecord> &rows, std::string_view date_format)
+{
+    const int64_t date_bytes = date_format == "%F" ? 10 : 24; // 'YYYY-MM-DD' or with time and zone
+    int64_t total_bytes = 0;
+    for (const auto &row : rows)
+    {
+        total_bytes += static_cast<int64_t>(row.symbol_.size() + row.close_.to_sci().size()) + date_bytes;
+    }
+    return total_bytes;
+}
+
+// a checkpoint is only good for the trading day it was made on.
+
+std::chrono::sys_days CurrentSessionDay()
+{
+    const auto local_now = std::chrono::current_zone()->to_local(std::chrono::system_clock::now());
+    return std::chrono::sys_days{std::chrono::floor<std::chrono::days>(local_now).time_since_epoch()};
+}
+
+// it is possible that the update could be empty if there was a problem extracting
+// the data.
+// Also, for now, we want to skip 'dark pool' transactions.
+// AND skip 1-share transactions -- maybe these are algo-traders probing the market.
+
+bool IsChartableUpdate(const RemoteDataSource::PF_Data &update)
+{
+    // last_price_ = -1 means the field was not set
+    // during data extraction.
+
+    return update.last_price_ != -1 && !update.dark_pool_ && update.last_size_ != 1;
+}
+
+// what co-located readers of the shared memory segment see for a chart.
+
+PF_SharedChartState MakeSharedChartState(const PF_Chart &chart, double latest_price, int64_t latest_tick_time_ns)
+{
+    const auto &current_column = chart.back();
+    PF_SharedChartState state{.column_number_ = current_column.GetColumnNumber(),
+                              .direction_ = std::to_underlying(chart.GetCurrentDirection()),
+                              .column_top_ = current_column.IsEmpty() ? 0.0 : current_column.GetTopAsDbl(),
+                              .column_bottom_ = current_column.IsEmpty() ? 0.0 : current_column.GetBottomAsDbl(),
+                              .latest_price_ = latest_price,
+                              .latest_tick_time_ns_ = latest_tick_time_ns};
+    if (const auto signal = chart.GetMostRecentSignal(); signal)
+    {
+        state.last_signal_type_ = std::to_underlying(signal->signal_type_);
+        state.last_signal_category_ = std::to_underlying(signal->signal_category_);
+        state.last_signal_price_ = dec2dbl(signal->signal_price_);
+        state.last_signal_time_ns_ =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(signal->tpt_.time_since_epoch()).count();
+    }
+    return state;
+}
+
 //--------------------------------------------------------------------------------------
 //       Class:  PF_CollectDataApp
 //      Method:  PF_CollectDataApp
@@ -250,9 +320,13 @@ bool PF_CollectDataApp::CheckArgs()
 
     //	let's get our input and output set up
 
-    BOOST_ASSERT_MSG(mode_i_ == "load" || mode_i_ == "update" || mode_i_ == "daily-scan",
-                     std::format("\nMode must be: 'load', 'update' or 'daily-scan': {}", mode_i_).c_str());
-    mode_ = mode_i_ == "load" ? Mode::e_load : mode_i_ == "update" ? Mode::e_update : Mode::e_daily_scan;
+    BOOST_ASSERT_MSG(
+        mode_i_ == "load" || mode_i_ == "update" || mode_i_ == "daily-scan" || mode_i_ == "service",
+        std::format("\nMode must be: 'load', 'update', 'daily-scan' or 'service': {}", mode_i_).c_str());
+    mode_ = mode_i_ == "load"         ? Mode::e_load
+            : mode_i_ == "update"     ? Mode::e_update
+            : mode_i_ == "daily-scan" ? Mode::e_daily_scan
+                                      : Mode::e_service;
 
     // now make sure we can find our data for input and output.
 
@@ -272,7 +346,7 @@ bool PF_CollectDataApp::CheckArgs()
                      std::format("\nData destination must be: 'file' or 'database': {}", destination_i_).c_str());
     destination_ = destination_i_ == "file" ? Destination::e_file : Destination::e_DB;
 
-    if (mode_ == Mode::e_daily_scan || new_data_source_ == Source::e_DB)
+    if (mode_ == Mode::e_daily_scan || mode_ == Mode::e_service || new_data_source_ == Source::e_DB)
     {
         // set up exchange list early.
 
@@ -340,6 +414,27 @@ bool PF_CollectDataApp::CheckArgs()
         return true;
     }
 
+    // the service works on EOD charts in the DB like daily-scan. If it is also to
+    // stream, the streaming options get checked below as usual.
+
+    if (mode_ == Mode::e_service)
+    {
+        BOOST_ASSERT_MSG(!db_params_.user_name_.empty(), "\nMust provide 'db-user' when mode is 'service'.");
+        BOOST_ASSERT_MSG(!db_params_.db_name_.empty(), "\nMust provide 'db-name' when mode is 'service'.");
+        BOOST_ASSERT_MSG(db_params_.PF_db_mode_ == "test" || db_params_.PF_db_mode_ == "live",
+                         "\n'db-mode' must be 'test' or 'live'.");
+        BOOST_ASSERT_MSG(!db_params_.stock_db_data_source_.empty(),
+                         "\n'stock-db-data-source' must be specified when mode is 'service'.");
+        BOOST_ASSERT_MSG(!service_socket_path_.empty(), "\nMust provide 'service-socket' when mode is 'service'.");
+
+        if (new_data_source_ != Source::e_streaming)
+        {
+            new_data_source_ = Source::e_DB;
+            graphics_format_ = GraphicsFormat::e_csv;
+            return true;
+        }
+    }
+
     // do these tests ourselves instead of specifying 'required' on Setup.
     // this is to avoid having to provide unnecessary arguments for daily scan
     // processing.
@@ -477,7 +572,10 @@ bool PF_CollectDataApp::CheckArgs()
         }
     }
 
-    if ((new_data_source_ == Source::e_file && use_ATR_) || new_data_source_ == Source::e_streaming)
+    // a replay doesn't need to prime the charts so it only needs a quote source for ATR.
+
+    if ((new_data_source_ == Source::e_file && use_ATR_) ||
+        (new_data_source_ == Source::e_streaming && (replay_stream_file_.empty() || use_ATR_)))
     {
         BOOST_ASSERT_MSG(quote_data_source_i_ == "Tiingo" || quote_data_source_i_ == "Eodhd",
                          "\nATR quote data source must be either 'Tiingo' or 'Eodhd' when using non-DB ATR.");
@@ -503,17 +601,47 @@ bool PF_CollectDataApp::CheckArgs()
         streaming_data_source_ =
             streaming_data_source_i_ == "Tiingo" ? StreamingSource::e_Tiingo : StreamingSource::e_Eodhd;
 
-        BOOST_ASSERT_MSG(!streaming_host_api_key_.empty(),
-                         "Must specify a streaming source API key file when streaming.");
-        BOOST_ASSERT_MSG(
-            fs::exists(PF_CollectDataConfigDir_ / streaming_host_api_key_),
-            std::format("\nCan't find streaming source api key file: {}", streaming_host_api_key_).c_str());
+        // when replaying, the streaming source just tells us how to parse the captured data.
+
+        if (replay_stream_file_.empty())
+        {
+            BOOST_ASSERT_MSG(!streaming_host_api_key_.empty(),
+                             "Must specify a streaming source API key file when streaming.");
+            BOOST_ASSERT_MSG(
+                fs::exists(PF_CollectDataConfigDir_ / streaming_host_api_key_),
+                std::format("\nCan't find streaming source api key file: {}", streaming_host_api_key_).c_str());
 
-        std::ifstream streaming_key_file(PF_CollectDataConfigDir_ / streaming_host_api_key_);
-        streaming_key_file >> streaming_api_key_;
+            std::ifstream streaming_key_file(PF_CollectDataConfigDir_ / streaming_host_api_key_);
+            streaming_key_file >> streaming_api_key_;
+        }
+        else
+        {
+            BOOST_ASSERT_MSG(fs::exists(replay_stream_file_),
+                             std::format("\nCan't find stream replay file: {}", replay_stream_file_).c_str());
+            BOOST_ASSERT_MSG(capture_stream_file_.empty(), "\nCan't capture a stream while replaying one.");
+            BOOST_ASSERT_MSG(replay_speed_ >= 0.0, "\nreplay-speed must be >= 0.");
+        }
+    }
+    else
+    {
+        BOOST_ASSERT_MSG(capture_stream_file_.empty() && replay_stream_file_.empty(),
+                         "\ncapture-stream and replay-stream can only be used when streaming.");
     }
 
     BOOST_ASSERT_MSG(max_columns_for_graph_ >= -1, "\nmax-graphic-cols must be >= -1.");
+    BOOST_ASSERT_MSG(thread_pool_threads_ > 0, "\nthreads must be > 0.");
+    BOOST_ASSERT_MSG(output_threads_ > 0, "\noutput-threads must be > 0.");
+    BOOST_ASSERT_MSG(metrics_interval_ > 0, "\nmetrics-interval must be > 0.");
+    BOOST_ASSERT_MSG(metrics_port_ >= 0 && metrics_port_ <= 65'535, "\nmetrics-port must be 0 - 65535.");
+    BOOST_ASSERT_MSG(shm_name_.empty() || (shm_name_.size() > 1 && shm_name_.starts_with('/') &&
+                                            shm_name_.find('/', 1) == std::string::npos),
+                     "\nshm-name must be a single '/' followed by a name. Example: /PF_CollectData.");
+    BOOST_ASSERT_MSG(
+        query_socket_path_.empty() || mode_ != Mode::e_service || query_socket_path_ != service_socket_path_,
+        "\nquery-socket and service-socket must be different.");
+    BOOST_ASSERT_MSG(rng::none_of(signal_socket_paths_,
+                                  [this](const auto &path) { return path == query_socket_path_ || path.empty(); }),
+                     "\nsignal-socket must not be empty or the same as query-socket.");
 
     BOOST_ASSERT_MSG(trend_lines_ == "no" || trend_lines_ == "data" || trend_lines_ == "angle",
                      std::format("\nshow-trend-lines must be: 'no' or 'data' or 'angle': {}", trend_lines_).c_str());
@@ -529,6 +657,35 @@ bool PF_CollectDataApp::CheckArgs()
                          .c_str());
     interval_ = which_interval->second;
 
+    if (!price_cache_directory_.empty())
+    {
+        BOOST_ASSERT_MSG(new_data_source_ == Source::e_DB && interval_ == Interval::e_eod,
+                         "\nprice-cache-dir can only be used with EOD data from 'database'.");
+
+        // adjusted prices are rewritten back in time by every split and dividend and
+        // the cache only asks for days it doesn't have.
+
+        BOOST_ASSERT_MSG(!IsAdjustedPriceField(price_fld_name_),
+                         "\nprice-cache-dir can't be used with adjusted prices. Use an unadjusted price-fld-name.");
+    }
+
+    BOOST_ASSERT_MSG(live_db_interval_ >= 0, "\nlive-db-interval must be >= 0.");
+    BOOST_ASSERT_MSG(checkpoint_interval_ > 0, "\ncheckpoint-interval must be > 0.");
+    BOOST_ASSERT_MSG(conflate_above_ >= 0, "\nconflate-above must be >= 0.");
+    BOOST_ASSERT_MSG(streaming_connections_ > 0, "\nstreaming-connections must be > 0.");
+    BOOST_ASSERT_MSG(quote_connections_ > 0, "\nquote-connections must be > 0.");
+    BOOST_ASSERT_MSG(quote_requests_per_second_ >= 0, "\nquote-requests-per-second must be >= 0.");
+    BOOST_ASSERT_MSG(history_cache_ttl_ >= 0, "\nhistory-cache-ttl must be >= 0.");
+    BOOST_ASSERT_MSG(checkpoint_file_.empty() || replay_stream_file_.empty(),
+                     "\nA replay can't be checkpointed. It can simply be run again.");
+    BOOST_ASSERT_MSG(checkpoint_file_.empty() || fs::is_directory(fs::absolute(checkpoint_file_).parent_path()),
+                     "\ncheckpoint-file must be in an existing directory.");
+    if (live_db_interval_ > 0)
+    {
+        BOOST_ASSERT_MSG(new_data_source_ == Source::e_streaming && destination_ == Destination::e_DB,
+                         "\nlive-db-interval can only be used when streaming with destination 'database'.");
+    }
+
     // provide our default value here.
 
     if (scale_i_list_.empty())
@@ -578,7 +735,7 @@ void PF_CollectDataApp::SetupProgramOptions ()
 		("chart-data-source",	po::value<std::string>(&this->chart_data_source_i_)->default_value("file"),	"source for existing chart data: either 'file' or 'database'. Default is 'file'.")
 		("source-format",		po::value<std::string>(&this->source_format_i_)->default_value("csv"),	"source data format: either 'csv' or 'json'. Default is 'csv'.")
 		("graphics-format",		po::value<std::string>(&this->graphics_format_i_)->default_value("svg"),	"Output graphics file format: either 'svg' or 'csv'. Default is 'svg'.")
-		("mode,m",				po::value<std::string>(&this->mode_i_)->default_value("load"),	"mode: either 'load' new data, 'update' existing data or 'daily-scan'. Default is 'load'.")
+		("mode,m",				po::value<std::string>(&this->mode_i_)->default_value("load"),	"mode: either 'load' new data, 'update' existing data, 'daily-scan' or 'service'. Default is 'load'.")
 		("interval,i",			po::value<std::string>(&this->interval_i_)->default_value("eod"),	"interval: 'eod', 'live', '1sec', '5sec', '1min', '5min'. Default is 'eod'.")
 		("scale",				po::value<std::vector<std::string>>(&this->scale_i_list_),	"scale: 'linear', 'percent'. Default is 'linear'.")
 		("price-fld-name",		po::value<std::string>(&this->price_fld_name_)->default_value("Close"),	"price-fld-name: which data field to use for price value. Default is 'Close'.")
@@ -591,18 +748,37 @@ void PF_CollectDataApp::SetupProgramOptions ()
 		("end-date",			po::value<std::string>(&this->end_date_),	"Stop date for extracting data from database source. Default is 'today'.")
 		("output-chart-dir",	po::value<fs::path>(&this->output_chart_directory_),	"output directory for chart [and graphic] files.")
 		("output-graph-dir",	po::value<fs::path>(&this->output_graphs_directory_),	"name of output directory to write generated graphics to.")
+		("price-cache-dir",		po::value<fs::path>(&this->price_cache_directory_),	"directory for local cache of EOD prices from database. Default is: no cache.")
 		("boxsize,b",			po::value<std::vector<std::string>>(&this->box_size_i_list_),   	"box step size. 'n', 'm.n'")
 		("reversal,r",			po::value<std::vector<int32_t>>(&this->reversal_boxes_list_),		"reversal size in number of boxes.")
 		("max-graphic-cols",	po::value<int32_t>(&this->max_columns_for_graph_)->default_value(-1),
 									"maximum number of columns to show in graphic. Use -1 for ALL, 0 to keep existing value, if any, otherwise -1. >0 to specify how many columns.")
 		("show-trend-lines",	po::value<std::string>(&this->trend_lines_)->default_value("no"),	"Show trend lines on graphic. Can be 'data' or 'angle'. Default is 'no'.")
+		("threads",				po::value<int32_t>(&this->thread_pool_threads_)->default_value(8),	"number of symbols to load or update from files at the same time. Default is 8.")
+		("output-threads",		po::value<int32_t>(&this->output_threads_)->default_value(8),	"number of charts to write [with graphics] at the same time at shutdown. Default is 8.")
+		("live-db-interval",	po::value<int32_t>(&this->live_db_interval_)->default_value(0),	"seconds between writes of changed streaming charts to database. Default is 0: only write at shutdown.")
+		("checkpoint-file",		po::value<fs::path>(&this->checkpoint_file_),	"while streaming, save the session to this file so a restart on the same day resumes from it. Default is none.")
+		("checkpoint-interval",	po::value<int32_t>(&this->checkpoint_interval_)->default_value(15),	"seconds between checkpoints of what changed while streaming. Default is 15.")
+		("conflate-above",		po::value<int32_t>(&this->conflate_above_)->default_value(0),	"when more than this many ticks are waiting for a symbol, process only the ones which can change its charts. Default is 0: never.")
+		("metrics-interval",	po::value<int32_t>(&this->metrics_interval_)->default_value(60),	"seconds between streaming latency and throughput reports in the log. Default is 60.")
+		("metrics-port",		po::value<int32_t>(&this->metrics_port_)->default_value(0),	"localhost port to serve streaming metrics on in Prometheus format. Default is 0: no metrics endpoint.")
+		("shm-name",			po::value<std::string>(&this->shm_name_),	"name of a shared memory segment (like /PF_CollectData) to publish live chart state in while streaming. Default is none.")
+		("query-socket",		po::value<fs::path>(&this->query_socket_path_),	"Unix socket to answer chart state and signal queries on while streaming. Default is no query socket.")
+		("signal-journal",		po::value<fs::path>(&this->signal_journal_path_),	"append each new signal found while streaming to this binary journal file. Default is none.")
+		("signal-socket",		po::value<std::vector<fs::path>>(&this->signal_socket_paths_)->composing(),	"send each new signal found while streaming as a datagram to this Unix datagram socket. Can be repeated. Default is none.")
+		("service-socket",		po::value<fs::path>(&this->service_socket_path_)->default_value("/tmp/PF_CollectData.sock"),	"Unix socket the service listens on for commands. Default is '/tmp/PF_CollectData.sock'.")
 		("log-path",            po::value<fs::path>(&log_file_path_name_),	"path name for log file.")
 		("log-level,l",         po::value<std::string>(&logging_level_)->default_value("information"), "logging level. Must be 'none|error|information|debug'. Default is 'information'.")
 
         ("streaming-host",      po::value<std::string>(&this->streaming_host_name_), "web site we stream from.")
         ("streaming-port",          po::value<std::string>(&this->streaming_host_port_)->default_value("443"), "Port number to use for streaming web site. Default is '443'.")
+        ("streaming-connections",   po::value<int32_t>(&this->streaming_connections_)->default_value(1), "number of websocket connections to spread streamed symbols over. Default is 1.")
         ("quote-host",          po::value<std::string>(&this->quote_host_name_), "web site we download from.")
         ("quote-port",          po::value<std::string>(&this->quote_host_port_)->default_value("443"), "Port number to use for quotes web site. Default is '443'.")
+        ("quote-connections",   po::value<int32_t>(&this->quote_connections_)->default_value(4), "most requests to quotes web site at once. Default is 4.")
+        ("quote-requests-per-second",   po::value<int32_t>(&this->quote_requests_per_second_)->default_value(0), "most requests to start each second to quotes web site. Default is 0: no limit.")
+        ("history-cache-dir",   po::value<fs::path>(&this->history_cache_directory_), "directory for local cache of price history from quotes web site. Can be shared by several processes. Default is: no cache.")
+        ("history-cache-ttl",   po::value<int32_t>(&this->history_cache_ttl_)->default_value(900), "seconds to keep cached price history for ranges the provider has not finished. Default is 900.")
 
         ("db-host",             po::value<std::string>(&this->db_params_.host_name_)->default_value("localhost"), "web location where database is running. Default is 'localhost'.")
         ("db-port",             po::value<int32_t>(&this->db_params_.port_number_)->default_value(5432), "Port number to use for database access. Default is '5432'.")
@@ -612,6 +788,9 @@ void PF_CollectDataApp::SetupProgramOptions ()
         ("stock-db-data-source",      po::value<std::string>(&this->db_params_.stock_db_data_source_)->default_value("new_stock_data.current_data"), "table containing symbol data. Default is 'new_stock_data.current_data'.")
         ("quote-data-source",     po::value<std::string>(&this->quote_data_source_i_), "Name of ATR quotes data source.")
         ("streaming-data-source",     po::value<std::string>(&this->streaming_data_source_i_), "Name of streaming data source.")
+        ("capture-stream",      po::value<fs::path>(&this->capture_stream_file_), "record all streamed data to this file for later replay.")
+        ("replay-stream",       po::value<fs::path>(&this->replay_stream_file_), "stream from this capture file instead of the streaming data source.")
+        ("replay-speed",        po::value<double>(&this->replay_speed_)->default_value(1.0), "speed for replay-stream. 1 is recorded pace, N is N times faster, 0 is as fast as possible. Default is 1.")
 
         ("config-dir",         po::value<fs::path>(&this->PF_CollectDataConfigDir_), "Path to config directory PF_CollectData application. Default is environment variable 'PF_COLLECT_DATA_CONFIG_DIR'.")
         ("quote-api-key",     po::value<fs::path>(&this->quote_host_api_key_), "Name of file containing quotes source api key.")
@@ -662,6 +841,12 @@ std::tuple<int, int, int> PF_CollectDataApp::Run()
     // TODO(dpriedel): this should be a program param...
     number_of_days_history_for_ATR_ = 20;
 
+    if (mode_ == Mode::e_service)
+    {
+        Run_Service();
+        return {};
+    }
+
     if (new_data_source_ == Source::e_streaming)
     {
         Run_Streaming();
@@ -701,45 +886,118 @@ std::tuple<int, int, int> PF_CollectDataApp::Run()
 
 void PF_CollectDataApp::Run_Load()
 {
-    auto params = vws::cartesian_product(symbol_list_, box_size_list_, reversal_boxes_list_, scale_list_);
+    // each symbol's data file is read once and used for all of its charts.
 
-    // TODO(dpriedel): move file read out of loop and into a buffer
+    ProcessSymbolsInParallel(&PF_CollectDataApp::LoadChartsForSymbolFromFile);
+} // -----  end of method PF_CollectDataApp::Run_Load  -----
 
-    for (const auto &val : params)
+PF_CollectDataApp::PF_Charts PF_CollectDataApp::LoadChartsForSymbolFromFile(const std::string &symbol) const
+{
+    PF_Charts charts;
+    try
     {
-        const auto &symbol = std::get<PF_Chart::e_symbol>(val);
-        try
+        fs::path symbol_file_name =
+            new_data_input_directory_ / (symbol + '.' + (source_format_ == SourceFormat::e_csv ? "csv" : "json"));
+        BOOST_ASSERT_MSG(fs::exists(symbol_file_name),
+                         std::format("\nCan't find data file: {} for symbol: {}.", symbol_file_name, symbol).c_str());
+        // TODO(dpriedel): add json code
+        BOOST_ASSERT_MSG(source_format_ == SourceFormat::e_csv,
+                         "\nJSON files are not yet supported for loading symbol data.");
+
+        const auto price_data = LoadPriceDataFromCSV(symbol_file_name);
+        auto atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
+
+        std::vector<std::string> the_symbol{symbol};
+        auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
+
+        for (const auto &val : params)
         {
-            fs::path symbol_file_name =
-                new_data_input_directory_ / (symbol + '.' + (source_format_ == SourceFormat::e_csv ? "csv" : "json"));
-            BOOST_ASSERT_MSG(
-                fs::exists(symbol_file_name),
-                std::format("\nCan't find data file: {} for symbol: {}.", symbol_file_name, symbol).c_str());
-            // TODO(dpriedel): add json code
-            BOOST_ASSERT_MSG(source_format_ == SourceFormat::e_csv,
-                             "\nJSON files are not yet supported for loading symbol data.");
-            auto atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
             PF_Chart new_chart;
-            if (use_ATR_)
+            try
             {
-                new_chart = PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                if (use_ATR_)
+                {
+                    new_chart = PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                }
+                else
+                {
+                    new_chart = PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                }
+                for (const auto &[new_date, new_price] : price_data)
+                {
+                    new_chart.AddValue(new_price, new_date);
+                }
+                charts.emplace_back(std::make_pair(symbol, std::move(new_chart)));
             }
-            else
+            catch (const std::exception &e)
             {
-                new_chart = PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                spdlog::error(std::format("Unable to load data for chart: {} from file because: {}.",
+                                          new_chart.MakeChartFileName(interval_i_, ""), e.what()));
             }
-            AddPriceDataToExistingChartCSV(new_chart, symbol_file_name);
-            charts_.emplace_back(std::make_pair(symbol, new_chart));
+        }
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to load data for symbol: {} from file because: {}.", symbol, e.what()));
+    }
+    return charts;
+} // -----  end of method PF_CollectDataApp::LoadChartsForSymbolFromFile  -----
+
+void PF_CollectDataApp::ProcessSymbolsInParallel(
+    PF_Charts (PF_CollectDataApp::*process_symbol)(const std::string &) const)
+{
+    // run up to 'thread_pool_threads_' symbols at a time. As each one finishes, start
+    // the next. Results are kept by symbol so charts_ ends up in the same order as
+    // if we had done this serially.
+
+    std::vector<PF_Charts> results(symbol_list_.size());
+
+    std::vector<std::future<PF_Charts>> tasks;
+    std::vector<size_t> task_symbol_index;
+
+    auto collect_result = [this, &tasks, &task_symbol_index, &results](int which) {
+        try
+        {
+            results[task_symbol_index[which]] = tasks[which].get();
         }
         catch (const std::exception &e)
         {
-            spdlog::error(std::format("Unable to load data for symbol: {} from file because: {}.", symbol, e.what()));
+            spdlog::error(std::format("Unable to process symbol: {} because: {}.",
+                                      symbol_list_[task_symbol_index[which]], e.what()));
+        }
+    };
+
+    for (size_t i = 0; i < symbol_list_.size(); ++i)
+    {
+        if (tasks.size() < static_cast<size_t>(thread_pool_threads_))
+        {
+            tasks.emplace_back(std::async(std::launch::async, process_symbol, this, std::cref(symbol_list_[i])));
+            task_symbol_index.push_back(i);
+            continue;
         }
+        const int ready = wait_for_any(tasks, 10ms);
+        collect_result(ready);
+        tasks[ready] = std::async(std::launch::async, process_symbol, this, std::cref(symbol_list_[i]));
+        task_symbol_index[ready] = i;
     }
-} // -----  end of method PF_CollectDataApp::Run_Load  -----
+    for (int i = 0; i < static_cast<int>(tasks.size()); ++i)
+    {
+        collect_result(i);
+    }
+
+    for (auto &symbol_charts : results)
+    {
+        rng::move(symbol_charts, std::back_inserter(charts_));
+    }
+} // -----  end of method PF_CollectDataApp::ProcessSymbolsInParallel  -----
 
 std::tuple<int, int, int> PF_CollectDataApp::Run_LoadFromDB()
 {
+    PF_TRACE_THREAD_NAME("main");
+    PF_TRACE_SCOPE("phase", "Run_LoadFromDB");
+
+    run_stats_ = std::make_unique<PF_RunStats>("load_from_db");
+
     int32_t total_symbols_processed = 0;
     int32_t total_charts_processed = 0;
     int32_t total_charts_updated = 0;
@@ -751,7 +1009,10 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_LoadFromDB()
     {
         PF_DB pf_db{db_params_};
 
-        exchange_list_ = pf_db.ListExchanges();
+        {
+            PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_list_exchanges};
+            exchange_list_ = pf_db.ListExchanges();
+        }
 
         // eliminate some exchanges we don't want to process
 
@@ -765,7 +1026,13 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_LoadFromDB()
             spdlog::info(std::format("Building charts for symbols on xchng: {} with minimum dollar volume >= {}.",
                                      xchng, min_dollar_volume_));
 
-            auto symbol_list = pf_db.ListSymbolsOnExchange(xchng, min_dollar_volume_);
+            PF_TRACE_SCOPE_ARG("phase", "load_exchange", xchng);
+            run_stats_->SetExchange(xchng);
+
+            const auto symbol_list = [&] {
+                PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_list_exchanges};
+                return pf_db.ListSymbolsOnExchange(xchng, min_dollar_volume_);
+            }();
             const auto counts = ProcessSymbolsFromDB(symbol_list);
             total_symbols_processed += std::get<0>(counts);
             total_charts_processed += std::get<1>(counts);
@@ -774,6 +1041,7 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_LoadFromDB()
                                      "{}.",
                                      xchng, std::get<0>(counts), std::get<1>(counts), std::get<2>(counts)));
         }
+        run_stats_->SetExchange({});
     }
     else
     {
@@ -801,44 +1069,85 @@ std::tuple<int, int, int> PF_CollectDataApp::ProcessSymbolsFromDB(const std::vec
 
     pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
 
-    const auto *dt_format = interval_ == Interval::e_eod ? "%F" : "%F %T%z";
-
-    std::istringstream time_stream;
-    std::chrono::utc_time<std::chrono::utc_clock::duration> tp;
+    const auto dt_format = interval_ == Interval::e_eod ? DateTimeFormat::e_date : DateTimeFormat::e_date_time_zone;
 
     // we know our database contains 'date's, but we need timepoints.
     // we'll handle that in the conversion routine below.
 
-    auto Row2Closing = [dt_format, &time_stream, &tp](const auto &r) {
-        time_stream.clear();
-        time_stream.str(std::string{std::get<0>(r)});
-        std::chrono::from_stream(time_stream, dt_format, tp);
-        std::chrono::utc_time<std::chrono::utc_clock::duration> tp1{tp.time_since_epoch()};
-        DateCloseRecord new_data{.date_ = tp1, .close_ = Decimal{std::get<1>(r)}};
+    // count what comes back from the DB as text before we convert it.
+
+    int64_t bytes_fetched = 0;
+
+    auto Row2Closing = [dt_format, &bytes_fetched](const auto &r) {
+        bytes_fetched += static_cast<int64_t>(std::get<0>(r).size() + std::strlen(std::get<1>(r)));
+        DateCloseRecord new_data{.date_ = ParseUTCTimePoint(dt_format, std::get<0>(r)),
+                                 .close_ = Decimal{std::get<1>(r)}};
         return new_data;
     };
 
+    // if we have a local cache of EOD prices, bring it up to date for all our symbols
+    // at once and then read from it instead of querying the DB for each symbol.
+
+    std::unique_ptr<PF_PriceCache> price_cache;
+    if (!price_cache_directory_.empty())
+    {
+        try
+        {
+            PF_TRACE_SCOPE("db", "refresh_price_cache");
+            PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_fetch_prices};
+            price_cache = std::make_unique<PF_PriceCache>(price_cache_directory_, db_params_, price_fld_name_);
+            price_cache->RefreshSymbols(symbol_list, begin_date_);
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Unable to use price cache in: {} because: {}. Using DB directly.",
+                                      price_cache_directory_, e.what()));
+            price_cache.reset();
+        }
+    }
+
     for (const auto &symbol : symbol_list)
     {
         ++total_symbols_processed;
+        PF_TRACE_SCOPE_ARG("symbol", "load_symbol", symbol);
 
         try
         {
             // first, get ready to retrieve our data from DB.  Do this once per
             // symbol.
 
-            std::string get_symbol_prices_cmd =
-                std::format("SELECT date, {} FROM {} WHERE symbol = {} AND date >= "
-                            "{} ORDER BY date ASC",
-                            price_fld_name_, db_params_.stock_db_data_source_, c.quote(symbol), c.quote(begin_date_));
+            run_stats_->AddSymbols(1);
 
-            const auto closing_prices = pf_db.RunSQLQueryUsingStream<DateCloseRecord, std::string_view, const char *>(
-                get_symbol_prices_cmd, Row2Closing);
+            std::vector<DateCloseRecord> closing_prices;
+            if (price_cache)
+            {
+                PF_TRACE_SCOPE("db", "read_price_cache");
+                PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_fetch_prices};
+                closing_prices = price_cache->GetClosingPrices(symbol, begin_date_);
+            }
+            else
+            {
+                std::string get_symbol_prices_cmd = std::format(
+                    "SELECT date, {} FROM {} WHERE symbol = {} AND date >= "
+                    "{} ORDER BY date ASC",
+                    price_fld_name_, db_params_.stock_db_data_source_, c.quote(symbol), c.quote(begin_date_));
+
+                PF_TRACE_SCOPE("db", "query_prices");
+                PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_fetch_prices};
+                bytes_fetched = 0;
+                closing_prices = pf_db.RunSQLQueryUsingStream<DateCloseRecord, std::string_view, const char *>(
+                    get_symbol_prices_cmd, Row2Closing);
+            }
+            run_stats_->AddRows(static_cast<int64_t>(closing_prices.size()), bytes_fetched);
 
             // only need to compute this once per symbol also
-            auto atr_or_range = use_ATR_       ? ComputeATRForChartFromDB(symbol)
-                                : use_min_max_ ? pf_db.ComputePriceRangeForSymbolFromDB(symbol, begin_date_, end_date_)
-                                               : 0;
+            auto atr_or_range = [&]() -> Decimal {
+                PF_TRACE_SCOPE("db", "compute_atr_or_range");
+                PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_fetch_prices};
+                return use_ATR_       ? ComputeATRForChartFromDB(symbol)
+                       : use_min_max_ ? pf_db.ComputePriceRangeForSymbolFromDB(symbol, begin_date_, end_date_)
+                                      : 0;
+            }();
 
             // There could be thousands of symbols in the database so we don't
             // want to generate combinations for all of them at once. so, make a
@@ -863,12 +1172,15 @@ std::tuple<int, int, int> PF_CollectDataApp::ProcessSymbolsFromDB(const std::vec
                 }
                 try
                 {
+                    PF_TRACE_SCOPE("chart", "apply_prices");
+                    PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_apply};
                     for (const auto &[new_date, new_price] : closing_prices)
                     {
-                        new_chart.AddValue(new_price, std::chrono::clock_cast<std::chrono::utc_clock>(new_date));
+                        new_chart.AddValue(new_price, new_date);
                     }
                     charts_.emplace_back(std::make_pair(symbol, new_chart));
                     ++total_charts_processed;
+                    run_stats_->AddCharts(1, 0);
                 }
                 catch (const std::exception &e)
                 {
@@ -888,14 +1200,44 @@ std::tuple<int, int, int> PF_CollectDataApp::ProcessSymbolsFromDB(const std::vec
 
 void PF_CollectDataApp::Run_Update()
 {
-    auto params = vws::cartesian_product(symbol_list_, box_size_list_, reversal_boxes_list_, scale_list_);
+    // each symbol's update file is read once and applied to all of its charts.
+
+    ProcessSymbolsInParallel(&PF_CollectDataApp::UpdateChartsForSymbolFromFile);
+} // -----  end of method PF_CollectDataApp::Run_Update  -----
+
+PF_CollectDataApp::PF_Charts PF_CollectDataApp::UpdateChartsForSymbolFromFile(const std::string &symbol) const
+{
+    PF_Charts charts;
+
+    std::vector<DateCloseRecord> price_data;
+    try
+    {
+        fs::path update_file_name =
+            new_data_input_directory_ / (symbol + '.' + (source_format_ == SourceFormat::e_csv ? "csv" : "json"));
+        BOOST_ASSERT_MSG(fs::exists(update_file_name),
+                         std::format("\nCan't find data file for symbol: {} for update.", update_file_name).c_str());
+        // TODO(dpriedel): add json code
+        BOOST_ASSERT_MSG(source_format_ == SourceFormat::e_csv,
+                         "\nJSON files are not yet supported for updating symbol data.");
+        price_data = LoadPriceDataFromCSV(update_file_name);
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to load update data for symbol: {} from file because: {}.", symbol,
+                                  e.what()));
+        return charts;
+    }
 
     // look for existing data and load the saved JSON data if we have it.
     // then add the new data to the chart.
 
+    std::optional<decimal::Decimal> atr;
+
+    std::vector<std::string> the_symbol{symbol};
+    auto params = vws::cartesian_product(the_symbol, box_size_list_, reversal_boxes_list_, scale_list_);
+
     for (const auto &val : params)
     {
-        const auto &symbol = std::get<PF_Chart::e_symbol>(val);
         PF_Chart new_chart;
         fs::path existing_data_file_name;
         try
@@ -911,28 +1253,26 @@ void PF_CollectDataApp::Run_Update()
             }
             else
             {
-                // no existing data to update, so make a new chart
+                // no existing data to update, so make a new chart. Only need ATR once per symbol.
 
-                auto atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
+                if (!atr)
+                {
+                    atr = use_ATR_ ? ComputeATRForChart(symbol) : 0;
+                }
                 if (use_ATR_)
                 {
-                    new_chart = PF_Chart{atr, val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                    new_chart = PF_Chart{atr.value(), val, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
                 }
                 else
                 {
-                    new_chart = PF_Chart{val, atr, max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
+                    new_chart = PF_Chart{val, atr.value(), max_columns_for_graph_ < 1 ? -1 : max_columns_for_graph_};
                 }
             }
-            fs::path update_file_name =
-                new_data_input_directory_ / (symbol + '.' + (source_format_ == SourceFormat::e_csv ? "csv" : "json"));
-            BOOST_ASSERT_MSG(
-                fs::exists(update_file_name),
-                std::format("\nCan't find data file for symbol: {} for update.", update_file_name).c_str());
-            // TODO(dpriedel): add json code
-            BOOST_ASSERT_MSG(source_format_ == SourceFormat::e_csv,
-                             "\nJSON files are not yet supported for updating symbol data.");
-            AddPriceDataToExistingChartCSV(new_chart, update_file_name);
-            charts_.emplace_back(std::make_pair(symbol, std::move(new_chart)));
+            for (const auto &[new_date, new_price] : price_data)
+            {
+                new_chart.AddValue(new_price, new_date);
+            }
+            charts.emplace_back(std::make_pair(symbol, std::move(new_chart)));
         }
         catch (const Json::Exception &e)
         {
@@ -945,7 +1285,8 @@ void PF_CollectDataApp::Run_Update()
                                       new_chart.MakeChartFileName(interval_i_, ""), e.what()));
         }
     }
-} // -----  end of method PF_CollectDataApp::Run_Update  -----
+    return charts;
+} // -----  end of method PF_CollectDataApp::UpdateChartsForSymbolFromFile  -----
 
 void PF_CollectDataApp::Run_UpdateFromDB()
 {
@@ -957,10 +1298,16 @@ void PF_CollectDataApp::Run_UpdateFromDB()
     // look for existing data and load the saved JSON data if we have it.
     // then add the new data to the chart.
 
+    PF_TRACE_THREAD_NAME("main");
+    PF_TRACE_SCOPE("phase", "Run_UpdateFromDB");
+
     PF_DB pf_db{db_params_};
 
     const auto *dt_format = interval_ == Interval::e_eod ? "%F" : "%F %T%z";
-    auto db_data = pf_db.GetPriceDataForSymbolsInList(symbol_list_, begin_date_, end_date_, price_fld_name_, dt_format);
+    auto db_data = [&] {
+        PF_TRACE_SCOPE("db", "query_prices");
+        return pf_db.GetPriceDataForSymbolsInList(symbol_list_, begin_date_, end_date_, price_fld_name_, dt_format);
+    }();
     // ranges::for_each(db_data, [](const auto& xx) {std::print("{}, {}, {}\n",
     // xx.symbol, xx.tp, xx.price); });
 
@@ -975,6 +1322,7 @@ void PF_CollectDataApp::Run_UpdateFromDB()
     for (const auto &symbol_rng : db_data | data_for_symbol)
     {
         const auto &symbol = symbol_rng[0].symbol_;
+        PF_TRACE_SCOPE_ARG("symbol", "update_symbol", symbol);
         // std::print("symbol: {}\n", symbol);
         std::vector<std::string> the_symbol{symbol};
 
@@ -1000,6 +1348,7 @@ void PF_CollectDataApp::Run_UpdateFromDB()
                 }
                 else // should only be database here
                 {
+                    PF_TRACE_SCOPE("db", "load_chart");
                     new_chart = PF_Chart::LoadChartFromChartsDB(PF_DB{db_params_}, val, interval_i_);
                 }
                 if (new_chart.empty())
@@ -1019,7 +1368,11 @@ void PF_CollectDataApp::Run_UpdateFromDB()
 
                 // apply new data to chart (which may be empty)
 
-                rng::for_each(symbol_rng, [&new_chart](const auto &row) { new_chart.AddValue(row.close_, row.date_); });
+                {
+                    PF_TRACE_SCOPE("chart", "apply_prices");
+                    rng::for_each(symbol_rng,
+                                  [&new_chart](const auto &row) { new_chart.AddValue(row.close_, row.date_); });
+                }
 
                 charts_.emplace_back(std::make_pair(symbol, std::move(new_chart)));
             }
@@ -1041,13 +1394,16 @@ void PF_CollectDataApp::Run_Streaming()
     auto market_status =
         GetUS_MarketStatus(std::string_view{std::chrono::current_zone()->name()}, current_local_time.get_local_time());
 
-    if (market_status != US_MarketStatus::e_NotOpenYet && market_status != US_MarketStatus::e_OpenForTrading)
+    // a replay can run any time.
+
+    if (replay_stream_file_.empty() && market_status != US_MarketStatus::e_NotOpenYet &&
+        market_status != US_MarketStatus::e_OpenForTrading)
     {
         std::cout << "Market not open for trading now so we can't stream quotes.\n";
         return;
     }
 
-    if (market_status == US_MarketStatus::e_NotOpenYet)
+    if (replay_stream_file_.empty() && market_status == US_MarketStatus::e_NotOpenYet)
     {
         std::cout << "Market not open for trading YET so we'll wait." << std::endl;
     }
@@ -1055,6 +1411,10 @@ void PF_CollectDataApp::Run_Streaming()
     // initialize PF_Charts to be used by streaming code
 
     std::map<std::string, decimal::Decimal> cache; // table for memoization of ATR
+    if (use_ATR_)
+    {
+        cache = ComputeATRForCharts(symbol_list_);
+    }
 
     for (const auto &val : params)
     {
@@ -1088,31 +1448,32 @@ void PF_CollectDataApp::Run_Streaming()
     {
         streamed_prices_[symbol] = {};
         streamed_summary_[symbol] = {};
+        streamed_prices_mtxs_[symbol];
     }
 
     // let's stream !
+    // Today's quotes have nothing to do with a recorded session so we don't prime for a replay.
 
-    PrimeChartsForStreaming();
-
-    // set up time delays between drawing chart updates
-
-    auto now = std::chrono::system_clock::now();
-    for (const auto &symbol : symbol_list_)
+    if (replay_stream_file_.empty())
     {
-        last_draw_times_[symbol] = now;
+        if (checkpoint_file_.empty() || !RestoreFromCheckpoint())
+        {
+            PrimeChartsForStreaming();
+        }
     }
-    last_summary_draw_time_ = now;
 
     CollectStreamingData();
 
 } // -----  end of method PF_CollectDataApp::Run_Streaming  -----
 
-void PF_CollectDataApp::AddPriceDataToExistingChartCSV(PF_Chart &new_chart, const fs::path &update_file_name) const
+std::vector<DateCloseRecord> PF_CollectDataApp::LoadPriceDataFromCSV(const fs::path &price_file_name) const
 {
-    const std::string file_content = LoadDataFileForUse(update_file_name);
+    const MappedFile file_content{price_file_name, MappedFile::Access::e_Sequential};
 
-    const auto symbol_data_records = split_string<std::string_view>(file_content, "\n");
-    const auto header_record = symbol_data_records.front();
+    CSVScanner scanner{file_content.AsStringView(), ','};
+    const bool have_header = scanner.NextRecord();
+    BOOST_ASSERT_MSG(have_header, std::format("\nNo data in file: {}.", price_file_name).c_str());
+    const auto header_record = scanner.Record();
 
     auto date_column = FindColumnIndex(header_record, "date", ",");
     BOOST_ASSERT_MSG(date_column.has_value(),
@@ -1123,19 +1484,22 @@ void PF_CollectDataApp::AddPriceDataToExistingChartCSV(PF_Chart &new_chart, cons
         close_column.has_value(),
         std::format("\nCan't find price field: {} in header record: {}.", price_fld_name_, header_record).c_str());
 
-    rng::for_each(
-        symbol_data_records | vws::drop(1),
-        [this, &new_chart, close_col = close_column.value(), date_col = date_column.value()](const auto record) {
-            const auto fields = split_string<std::string_view>(record, ",");
-            const auto *dt_format = interval_ == Interval::e_eod ? "%F" : "%F %T%z";
-            new_chart.AddValue(sv2dec(fields[close_col]), StringToUTCTimePoint(dt_format, fields[date_col]));
-        });
+    const auto date_col = static_cast<size_t>(date_column.value());
+    const auto close_col = static_cast<size_t>(close_column.value());
+    const auto dt_format = interval_ == Interval::e_eod ? DateTimeFormat::e_date : DateTimeFormat::e_date_time_zone;
 
-} // -----  end of method PF_CollectDataApp::AddPriceDataToExistingChartCSV
-  // -----
+    std::vector<DateCloseRecord> price_data;
+    while (scanner.NextRecord())
+    {
+        price_data.emplace_back(DateCloseRecord{.date_ = ParseUTCTimePoint(dt_format, scanner.Field(date_col)),
+                                                .close_ = FieldToDecimal(scanner.Field(close_col))});
+    }
+    return price_data;
+} // -----  end of method PF_CollectDataApp::LoadPriceDataFromCSV  -----
 
 PF_Chart PF_CollectDataApp::LoadAndParsePriceDataJSON(const fs::path &symbol_file_name)
 {
+    PF_TRACE_SCOPE("json", "parse_chart_file");
     PF_Chart new_chart;
     PF_Chart::LoadChartFromJSONPF_ChartFile(new_chart, symbol_file_name);
     return new_chart;
@@ -1166,21 +1530,53 @@ std::optional<int> PF_CollectDataApp::FindColumnIndex(std::string_view header, s
 
 } // -----  end of method PF_CollectDataApp::FindColumnIndex  -----
 
+RemoteDataSource &PF_CollectDataApp::QuoteSource() const
+{
+    std::call_once(quote_source_once_, [this] {
+        if (quote_data_source_ == QuoteDataSource::e_Eodhd)
+        {
+            quote_source_ = std::make_unique<Eodhd>(Eodhd::Host{quote_host_name_}, Eodhd::Port{quote_host_port_},
+                                                    Eodhd::APIKey{quotes_api_key_}, Eodhd::Prefix{});
+        }
+        else
+        {
+            // just 2 options for now
+            quote_source_ = std::make_unique<Tiingo>(Tiingo::Host{quote_host_name_}, Tiingo::Port{quote_host_port_},
+                                                     Tiingo::APIKey{quotes_api_key_}, Tiingo::Prefix{"/iex"});
+        }
+        quote_source_->UseRequestLimits(quote_connections_, quote_requests_per_second_);
+
+        // like the price cache, if we can't use it we just go without.
+
+        if (!history_cache_directory_.empty())
+        {
+            try
+            {
+                quote_source_->UseHistoryCache(std::make_unique<PF_HistoryCache>(
+                    history_cache_directory_, quote_data_source_i_, std::chrono::seconds{history_cache_ttl_}));
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error(std::format("Unable to use history cache in: {} because: {}. Requesting all history.",
+                                          history_cache_directory_, e.what()));
+            }
+        }
+    });
+    return *quote_source_;
+} // -----  end of method PF_CollectDataApp::QuoteSource  -----
+
 Decimal PF_CollectDataApp::ComputeATRForChart(const std::string &symbol) const
 {
-    std::unique_ptr<RemoteDataSource> history_getter;
-    if (quote_data_source_ == QuoteDataSource::e_Eodhd)
-    {
-        history_getter = std::make_unique<Eodhd>(Eodhd::Host{quote_host_name_}, Eodhd::Port{quote_host_port_},
-                                                 Eodhd::APIKey{quotes_api_key_}, Eodhd::Prefix{});
-    }
-    else
+    auto atr = ComputeATRForCharts({symbol});
+    if (!atr.contains(symbol))
     {
-        // just 2 options for now
-        history_getter = std::make_unique<Tiingo>(Tiingo::Host{quote_host_name_}, Tiingo::Port{quote_host_port_},
-                                                  Tiingo::APIKey{quotes_api_key_}, Tiingo::Prefix{});
+        throw std::runtime_error(std::format("No recent price history to compute ATR for: {}", symbol));
     }
+    return atr[symbol];
+} // -----  end of method PF_CollectDataApp::ComputeBoxSizeUsingATR  -----
 
+std::map<std::string, Decimal> PF_CollectDataApp::ComputeATRForCharts(const std::vector<std::string> &symbols) const
+{
     // we need to start from yesterday since we won't get history data for today
     // since we are doing this while the market is open
 
@@ -1193,13 +1589,23 @@ Decimal PF_CollectDataApp::ComputeATRForChart(const std::string &symbol) const
     auto holidays = MakeHolidayList(today.year());
     rng::copy(MakeHolidayList(--(today.year())), std::back_inserter(holidays));
 
-    const auto history = history_getter->GetMostRecentTickerData(symbol, today, number_of_days_history_for_ATR_ + 1,
-                                                                 UseAdjusted::e_Yes, &holidays);
+    const auto histories = QuoteSource().GetMostRecentTickerDataForSymbols(
+        symbols, today, number_of_days_history_for_ATR_ + 1, UseAdjusted::e_Yes, &holidays);
 
-    auto atr = ComputeATR(symbol, history, number_of_days_history_for_ATR_);
-
-    return atr;
-} // -----  end of method PF_CollectDataApp::ComputeBoxSizeUsingATR  -----
+    std::map<std::string, Decimal> atrs;
+    for (const auto &[symbol, history] : histories)
+    {
+        try
+        {
+            atrs[symbol] = ComputeATR(symbol, history, number_of_days_history_for_ATR_);
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Unable to compute ATR for: '{}' because: {}.", symbol, e.what()));
+        }
+    }
+    return atrs;
+} // -----  end of method PF_CollectDataApp::ComputeATRForCharts  -----
 
 Decimal PF_CollectDataApp::ComputeATRForChartFromDB(const std::string &symbol) const
 {
@@ -1220,6 +1626,58 @@ Decimal PF_CollectDataApp::ComputeATRForChartFromDB(const std::string &symbol) c
     return atr;
 } // -----  end of method PF_CollectDataApp::ComputeATRUsingDB  -----
 
+bool PF_CollectDataApp::RestoreFromCheckpoint()
+{
+    // after a restart, the checkpoint has everything priming would give us plus
+    // every tick up to the checkpoint. We only use it if it has every chart we are
+    // about to stream. Otherwise we'd have some charts primed and some not.
+
+    const auto started_at = std::chrono::steady_clock::now();
+    std::optional<PF_Checkpoint::Contents> contents;
+    try
+    {
+        contents = PF_Checkpoint::Load(checkpoint_file_, CurrentSessionDay());
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to load checkpoint: {} because: {}", checkpoint_file_, e.what()));
+    }
+    if (!contents)
+    {
+        return false;
+    }
+    const auto missing = rng::find_if(charts_, [&contents](const auto &symbol_and_chart) {
+        return !contents->charts_.contains(symbol_and_chart.second.GetChartBaseName());
+    });
+    if (missing != charts_.end())
+    {
+        spdlog::info(std::format("Checkpoint: {} has no chart: {}. Starting the session from scratch.",
+                                 checkpoint_file_, missing->second.GetChartBaseName()));
+        return false;
+    }
+
+    for (auto &[symbol, chart] : charts_)
+    {
+        chart = std::move(contents->charts_.at(chart.GetChartBaseName()));
+    }
+    for (const auto &symbol : symbol_list_)
+    {
+        if (auto prices = contents->streamed_prices_.find(symbol); prices != contents->streamed_prices_.end())
+        {
+            streamed_prices_[symbol] = std::move(prices->second);
+        }
+        if (auto summary = contents->streamed_summary_.find(symbol); summary != contents->streamed_summary_.end())
+        {
+            streamed_summary_[symbol] = summary->second;
+        }
+    }
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started_at);
+    spdlog::info(std::format("Resumed {} charts from checkpoint: {} saved at: {:%T} in {}.", charts_.size(),
+                             checkpoint_file_, std::chrono::floor<std::chrono::seconds>(contents->saved_at_), elapsed));
+    return true;
+} // -----  end of method PF_CollectDataApp::RestoreFromCheckpoint  -----
+
 void PF_CollectDataApp::PrimeChartsForStreaming()
 {
     // for streaming, we want to retrieve the previous day's close and, if the
@@ -1239,35 +1697,26 @@ void PF_CollectDataApp::PrimeChartsForStreaming()
     auto market_status =
         GetUS_MarketStatus(std::string_view{std::chrono::current_zone()->name()}, current_local_time.get_local_time());
 
-    std::unique_ptr<RemoteDataSource> history_getter;
-    if (quote_data_source_ == QuoteDataSource::e_Eodhd)
-    {
-        history_getter = std::make_unique<Eodhd>(Eodhd::Host{quote_host_name_}, Eodhd::Port{quote_host_port_},
-                                                 Eodhd::APIKey{quotes_api_key_}, Eodhd::Prefix{});
-    }
-    else
-    {
-        // just 2 options for now
-        history_getter = std::make_unique<Tiingo>(Tiingo::Host{quote_host_name_}, Tiingo::Port{quote_host_port_},
-                                                  Tiingo::APIKey{quotes_api_key_}, Tiingo::Prefix{"/iex"});
-    }
+    auto &history_getter = QuoteSource();
 
     if (market_status == US_MarketStatus::e_NotOpenYet)
     {
         // just prior day's close
 
-        std::map<std::string, std::vector<StockDataRecord>> cache;
+        // symbols we can't get a close for just start with their first streamed price.
+
+        auto cache = history_getter.GetMostRecentTickerDataForSymbols(
+            symbol_list_, today, 2, IsAdjustedPriceField(price_fld_name_) ? UseAdjusted::e_Yes : UseAdjusted::e_No,
+            &holidays);
+        std::erase_if(cache, [](const auto &symbol_and_history) { return symbol_and_history.second.empty(); });
 
         for (auto &[symbol, chart] : charts_)
         {
-            const auto history =
-                cache.contains(symbol)
-                    ? cache[symbol]
-                    : (cache[symbol] = history_getter->GetMostRecentTickerData(
-                           symbol, today, 2,
-                           price_fld_name_.starts_with("adj") ? UseAdjusted::e_Yes : UseAdjusted::e_No, &holidays));
-            chart.AddValue(history[0].close_,
-                           std::chrono::clock_cast<std::chrono::utc_clock>(current_local_time.get_sys_time()));
+            if (const auto history = cache.find(symbol); history != cache.end())
+            {
+                chart.AddValue(history->second[0].close_,
+                               std::chrono::clock_cast<std::chrono::utc_clock>(current_local_time.get_sys_time()));
+            }
         }
         // initialize our streaming summary 'opening' price (really prior day's close)
 
@@ -1289,8 +1738,8 @@ void PF_CollectDataApp::PrimeChartsForStreaming()
     }
     else if (market_status == US_MarketStatus::e_OpenForTrading)
     {
-        history_getter->UseSymbols(symbol_list_);
-        auto history = history_getter->GetTopOfBookAndLastClose();
+        history_getter.UseSymbols(symbol_list_);
+        auto history = history_getter.GetTopOfBookAndLastClose();
 
         const auto close_time_stamp = std::chrono::clock_cast<std::chrono::utc_clock>(
             GetUS_MarketOpenTime(today).get_sys_time() - std::chrono::seconds{60});
@@ -1385,8 +1834,34 @@ void PF_CollectDataApp::CollectStreamingData()
     auto local_market_close =
         std::chrono::zoned_seconds(std::chrono::current_zone(), GetUS_MarketCloseTime(today).get_sys_time() + 2min);
 
-    // this is for the websocket thread
-    RemoteDataSource::StreamerContext streamer_context;
+    // symbols are dealt out to the websocket connections so a symbol is only ever on
+    // 1 connection and its ticks stay in order. A replay is 1 capture so it has 1 stream.
+
+    int32_t connections = 1;
+    if (replay_stream_file_.empty())
+    {
+        connections = std::max(1, std::min(streaming_connections_, static_cast<int32_t>(symbol_list_.size())));
+    }
+    std::vector<std::vector<std::string>> connection_symbols(connections);
+    for (size_t i = 0; i < symbol_list_.size(); ++i)
+    {
+        connection_symbols[i % connections].push_back(symbol_list_[i]);
+    }
+    if (connections > 1)
+    {
+        spdlog::info(std::format("Streaming {} symbols over {} connections.", symbol_list_.size(), connections));
+    }
+
+    // everything below which records metrics (signal bus, parsers, processors, file
+    // sink) must see this session's metrics so they are set up first.
+
+    streaming_metrics_ = std::make_unique<PF_StreamingMetrics>(symbol_list_, connections);
+    streaming_metrics_->Start(std::chrono::seconds{metrics_interval_}, metrics_port_);
+
+    // these are for the websocket threads. Each connection has its own parser.
+    std::vector<RemoteDataSource::StreamerContext> streamer_contexts(connections);
+    PF_streamers_.clear();
+    PF_streamers_.resize(connections);
 
     // data structure to manage processing data extracted from stream.
     // Because the context struct includes a mutux and a condition_variable which are
@@ -1406,43 +1881,180 @@ void PF_CollectDataApp::CollectStreamingData()
     // the new part -- use a thread for the low level processing tasks which are the most
     // time-consuming part. add a task for each symbol we are processing data for.
 
-    std::vector<std::thread> processor_threads;
-    for (auto &context : processor_contexts)
+    // queries are answered from the same chart copies we hand to the render thread so
+    // they never touch the charts the processor threads are updating.
+
+    if (!query_socket_path_.empty())
+    {
+        chart_query_ = std::make_unique<PF_ChartQuery>();
+        rng::for_each(charts_,
+                      [this](const auto &symbol_and_chart) { chart_query_->AddChart(symbol_and_chart.second); });
+        chart_query_->Start(query_socket_path_);
+    }
+
+    // co-located processes can poll chart state from shared memory. Each slot is
+    // written only by the processor thread for its chart's symbol.
+
+    if (!shm_name_.empty())
+    {
+        std::vector<PF_SharedStateWriter::SlotName> slot_names;
+        rng::for_each(charts_, [&slot_names](const auto &symbol_and_chart) {
+            slot_names.push_back(
+                {.symbol_ = symbol_and_chart.first, .chart_name_ = symbol_and_chart.second.GetChartBaseName()});
+        });
+        shared_state_ = std::make_unique<PF_SharedStateWriter>(shm_name_, slot_names);
+        for (size_t slot = 0; slot < charts_.size(); ++slot)
+        {
+            shared_state_->Publish(slot, MakeSharedChartState(charts_[slot].second, 0.0, 0));
+        }
+        spdlog::info(std::format("Publishing state of {} charts in shared memory: {}", charts_.size(), shm_name_));
+    }
+
+    // the first checkpoint has everything. After that, only what changed is encoded again.
+
+    if (!checkpoint_file_.empty())
+    {
+        checkpoint_ = std::make_unique<PF_Checkpoint>(checkpoint_file_, CurrentSessionDay());
+        rng::for_each(charts_,
+                      [this](const auto &symbol_and_chart) { checkpoint_->UpdateChart(symbol_and_chart.second); });
+        for (const auto &symbol : symbol_list_)
+        {
+            checkpoint_->UpdateSymbol(symbol, streamed_prices_.at(symbol), streamed_summary_.at(symbol));
+        }
+        checkpoint_->Save();
+    }
+
+    // each subscriber gets its own thread so a slow one can't hold up the
+    // processor threads or the other subscribers.
+
+    if (!signal_journal_path_.empty() || !signal_socket_paths_.empty())
+    {
+        signal_bus_ = std::make_unique<PF_SignalBus>(4096, streaming_metrics_.get());
+        if (!signal_journal_path_.empty())
+        {
+            signal_bus_->AddSink(std::make_unique<PF_SignalJournalSink>(signal_journal_path_));
+        }
+        for (const auto &socket_path : signal_socket_paths_)
+        {
+            signal_bus_->AddSink(std::make_unique<PF_SignalDatagramSink>(socket_path));
+        }
+        signal_bus_->Start();
+    }
+
+    if (conflate_above_ > 0)
+    {
+        for (const auto &[symbol, chart] : charts_)
+        {
+            if (chart.GetReversalboxes() == 1)
+            {
+                spdlog::info(std::format("Ticks for: {} won't be conflated. Chart: {} has a 1-box reversal.", symbol,
+                                         chart.GetChartBaseName()));
+            }
+        }
+    }
+
+    std::vector<std::thread> processor_threads;
+    for (auto &context : processor_contexts)
     {
         processor_threads.emplace_back(&PF_CollectDataApp::ProcessUpdatesForSymbol, this, std::ref(context));
     }
 
-    auto parsing_task =
-        std::async(std::launch::async, &PF_CollectDataApp::StreamedDataParser, this, std::ref(streamer_context),
-                   std::ref(processor_contexts), std::ref(symbol_to_context_map));
+    std::vector<std::future<void>> parsing_tasks;
+    for (int32_t connection = 0; connection < connections; ++connection)
+    {
+        parsing_tasks.push_back(std::async(std::launch::async, &PF_CollectDataApp::StreamedDataParser, this,
+                                           connection, std::ref(streamer_contexts[connection]),
+                                           std::ref(processor_contexts), std::ref(symbol_to_context_map)));
+    }
     // py::gil_scoped_release gil{};
 
-    auto timer_task = std::async(std::launch::async, &PF_CollectDataApp::WaitForTimer, local_market_close);
+    // a replay ends when the capture does.
+
+    std::future<void> timer_task;
+    if (replay_stream_file_.empty())
+    {
+        timer_task = std::async(std::launch::async, &PF_CollectDataApp::WaitForTimer, local_market_close);
+    }
+
+    // graphics and chart files are written on their own thread so a slow draw doesn't
+    // hold up processing of new data.
+
+    // the render thread only generates the output. The file sink writes it.
+
+    file_sink_ = std::make_unique<PF_FileSink>(minimum_delay_);
+
+    file_sink_->UseMetrics(streaming_metrics_.get());
+
+    render_context_.done_ = false;
+    auto render_task = std::async(std::launch::async, &PF_CollectDataApp::RenderStreamedCharts, this);
+
+    // if asked, changed charts are also written to the database while we stream.
+
+    std::future<void> persist_task;
+    if (live_db_interval_ > 0)
+    {
+        persist_context_.done_ = false;
+        persist_task = std::async(std::launch::async, &PF_CollectDataApp::PersistStreamedCharts, this);
+    }
+
+    std::future<void> checkpoint_task;
+    if (checkpoint_)
+    {
+        checkpoint_context_.done_ = false;
+        checkpoint_task = std::async(std::launch::async, &PF_CollectDataApp::CheckpointStreamingSession, this);
+    }
 
     // the websock streamer (RemoteDataSource) handles reconnect situations so no need to do it here.
+    // Each connection reconnects on its own.
 
+    std::vector<std::future<void>> streaming_tasks;
     try
     {
-        // std::unique_ptr<RemoteDataSource> streaming;
-        if (streaming_data_source_ == StreamingSource::e_Eodhd)
+        // all connections record into the same capture.
+
+        std::shared_ptr<StreamCaptureWriter> stream_capture;
+        if (replay_stream_file_.empty() && !capture_stream_file_.empty())
+        {
+            stream_capture = std::make_shared<StreamCaptureWriter>(capture_stream_file_);
+        }
+
+        for (int32_t connection = 0; connection < connections; ++connection)
         {
-            PF_streamer_ = std::make_unique<Eodhd>(Eodhd::Host{streaming_host_name_}, Eodhd::Port{streaming_host_port_},
+            std::unique_ptr<RemoteDataSource> streamer;
+            if (streaming_data_source_ == StreamingSource::e_Eodhd)
+            {
+                streamer = std::make_unique<Eodhd>(Eodhd::Host{streaming_host_name_}, Eodhd::Port{streaming_host_port_},
                                                    Eodhd::APIKey{streaming_api_key_},
                                                    Eodhd::Prefix{"/ws/us?api_token="s + streaming_api_key_});
+            }
+            else
+            {
+                // just 2 options for now
+                streamer =
+                    std::make_unique<Tiingo>(Tiingo::Host{streaming_host_name_}, Tiingo::Port{streaming_host_port_},
+                                             Tiingo::APIKey{streaming_api_key_}, Tiingo::Prefix{"/iex"});
+            }
+
+            if (!replay_stream_file_.empty())
+            {
+                streamer = std::make_unique<ReplayDataSource>(std::move(streamer), replay_stream_file_, replay_speed_);
+            }
+            else if (stream_capture)
+            {
+                streamer->CaptureStreamTo(stream_capture);
+            }
+
+            streamer->UseSymbols(connection_symbols[connection]);
+            streamer->UseConnectionMetrics(&streaming_metrics_->Connection(connection));
+            PF_streamers_[connection] = std::move(streamer);
         }
-        else
+
+        for (int32_t connection = 0; connection < connections; ++connection)
         {
-            // just 2 options for now
-            PF_streamer_ =
-                std::make_unique<Tiingo>(Tiingo::Host{streaming_host_name_}, Tiingo::Port{streaming_host_port_},
-                                         Tiingo::APIKey{streaming_api_key_}, Tiingo::Prefix{"/iex"});
+            streaming_tasks.push_back(std::async(std::launch::async, &RemoteDataSource::StreamData,
+                                                 PF_streamers_[connection].get(), &PF_CollectDataApp::had_signal_,
+                                                 std::ref(streamer_contexts[connection])));
         }
-
-        PF_streamer_->UseSymbols(symbol_list_);
-
-        auto streaming_task = std::async(std::launch::async, &RemoteDataSource::StreamData, PF_streamer_.get(),
-                                         &PF_CollectDataApp::had_signal_, std::ref(streamer_context));
-        streaming_task.get();
     }
     catch (std::exception &e)
     {
@@ -1452,11 +2064,61 @@ void PF_CollectDataApp::CollectStreamingData()
         had_signal_ = true;
     }
 
-    // PF_streamer_.reset();
+    // the session ends for all connections when any one of them ends (closed normally,
+    // gave up reconnecting or failed), on a signal or the market close timer, or when
+    // the service asks us to stop (even while we were still priming). A quiet
+    // connection might not look at had_signal_ for a while so each one is told to stop.
 
-    streamer_context.done_ = true;
-    streamer_context.cv_.notify_one();
-    parsing_task.get();
+    const auto is_done = [](const auto &task) { return task.wait_for(0s) == std::future_status::ready; };
+    bool stop_requested = false;
+    while (true)
+    {
+        const auto still_running = rng::find_if_not(streaming_tasks, is_done);
+        if (still_running == streaming_tasks.end())
+        {
+            break;
+        }
+        if (!stop_requested && (had_signal_ || stop_streaming_requested_ || rng::any_of(streaming_tasks, is_done)))
+        {
+            stop_requested = true;
+            had_signal_ = true;
+            rng::for_each(PF_streamers_, [](const auto &streamer) {
+                if (streamer)
+                {
+                    streamer->RequestStop();
+                }
+            });
+        }
+        still_running->wait_for(1s);
+    }
+
+    for (auto &streaming_task : streaming_tasks)
+    {
+        try
+        {
+            streaming_task.get();
+        }
+        catch (std::exception &e)
+        {
+            spdlog::error(std::format("Problem with {} streaming. Message: {}",
+                                      streaming_data_source_ == StreamingSource::e_Eodhd ? "Eodhd" : "Tiingo",
+                                      e.what()));
+            had_signal_ = true;
+        }
+    }
+
+    for (auto &streamer_context : streamer_contexts)
+    {
+        {
+            std::lock_guard<std::mutex> lock(streamer_context.mtx_);
+            streamer_context.done_ = true;
+        }
+        streamer_context.cv_.notify_one();
+    }
+    for (auto &parsing_task : parsing_tasks)
+    {
+        parsing_task.get();
+    }
 
     for (auto &context : processor_contexts)
     {
@@ -1469,7 +2131,64 @@ void PF_CollectDataApp::CollectStreamingData()
         thread.join();
     }
 
-    timer_task.get();
+    if (chart_query_)
+    {
+        chart_query_->Stop();
+        chart_query_.reset();
+    }
+    shared_state_.reset();
+
+    // delivers anything still queued.
+
+    if (signal_bus_)
+    {
+        signal_bus_->Stop();
+        signal_bus_.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(render_context_.mtx_);
+        render_context_.done_ = true;
+    }
+    render_context_.cv_.notify_one();
+    render_task.get();
+
+    // the render thread was the only one writing through the sink. Shutdown output
+    // is written directly.
+
+    file_sink_->Close();
+    spdlog::info(std::format("Wrote {} streamed output files.", file_sink_->FilesWritten()));
+    file_sink_.reset();
+
+    if (persist_task.valid())
+    {
+        {
+            std::lock_guard<std::mutex> lock(persist_context_.mtx_);
+            persist_context_.done_ = true;
+        }
+        persist_context_.cv_.notify_one();
+        persist_task.get();
+    }
+
+    if (checkpoint_task.valid())
+    {
+        {
+            std::lock_guard<std::mutex> lock(checkpoint_context_.mtx_);
+            checkpoint_context_.done_ = true;
+        }
+        checkpoint_context_.cv_.notify_one();
+        checkpoint_task.get();
+        checkpoint_.reset();
+    }
+
+    if (timer_task.valid())
+    {
+        timer_task.get();
+    }
+
+    // the file sink keeps timing writes until it is closed at shutdown.
+
+    streaming_metrics_->Stop();
 
     spdlog::debug("got here after timer expired");
 
@@ -1478,13 +2197,17 @@ void PF_CollectDataApp::CollectStreamingData()
 // here's a task to parse the streamed buffer of data and xlate it to a PF_Data struct.
 // and then add it to the appropriate processor_contexts buffer for processing.
 
-void PF_CollectDataApp::StreamedDataParser(RemoteDataSource::StreamerContext &streamer_context,
+void PF_CollectDataApp::StreamedDataParser(int32_t connection, RemoteDataSource::StreamerContext &streamer_context,
                                            std::vector<RemoteDataSource::ProcessorContext> &processor_contexts,
                                            std::map<std::string, int> &symbol_to_context_map)
 {
+    // we take everything waiting at once by swapping vectors. The frames go back to
+    // the pool as soon as they are parsed.
+
+    std::vector<RemoteDataSource::StreamedFrame> frames;
     while (true)
     {
-        std::string new_data;
+        frames.clear();
         {
             std::unique_lock<std::mutex> lock(streamer_context.mtx_);
 
@@ -1502,32 +2225,47 @@ void PF_CollectDataApp::StreamedDataParser(RemoteDataSource::StreamerContext &st
             {
                 continue;
             }
-            new_data = std::move(streamer_context.streamed_data_.front());
-            streamer_context.streamed_data_.pop();
+            frames.swap(streamer_context.streamed_data_);
         }
 
-        try
+        for (auto remaining = std::ssize(frames); auto &frame : frames)
         {
-            const RemoteDataSource::PF_Data extracted_data = PF_streamer_->ExtractStreamedData(new_data);
-            if (extracted_data.ticker_.empty())
+            streaming_metrics_->SetParseQueueDepth(connection, --remaining);
+            streaming_metrics_->RecordSince(PF_StreamingMetrics::Stage::e_parse_queue, frame.received_at_);
+
+            auto new_data = std::move(frame.data_);
+            try
             {
-                // Tiingo sends 'heartbeat' messages with no data
-                continue;
-            }
-            auto &processor_ctx = processor_contexts[symbol_to_context_map.at(extracted_data.ticker_)];
+                const auto parse_started_at = std::chrono::steady_clock::now();
+                RemoteDataSource::PF_Data extracted_data =
+                    PF_streamers_[connection]->ExtractStreamedData(new_data.View());
+                extracted_data.received_at_ = frame.received_at_;
+                extracted_data.parsed_at_ = std::chrono::steady_clock::now();
+                streaming_metrics_->Record(PF_StreamingMetrics::Stage::e_parse,
+                                           extracted_data.parsed_at_ - parse_started_at);
+                if (extracted_data.ticker_.empty())
+                {
+                    // Tiingo sends 'heartbeat' messages with no data
+                    continue;
+                }
+                auto &processor_ctx = processor_contexts[symbol_to_context_map.at(extracted_data.ticker_)];
+                streaming_metrics_->CountTick(extracted_data.ticker_);
 
-            // push our data on to the next step
+                // push our data on to the next step
 
+                {
+                    std::lock_guard<std::mutex> lock(processor_ctx.mtx_);
+                    processor_ctx.extracted_data_.emplace(extracted_data);
+                    streaming_metrics_->SetSymbolQueueDepth(extracted_data.ticker_,
+                                                            std::ssize(processor_ctx.extracted_data_));
+                }
+
+                processor_ctx.cv_.notify_one();
+            }
+            catch (const std::exception &e)
             {
-                std::lock_guard<std::mutex> lock(processor_ctx.mtx_);
-                processor_ctx.extracted_data_.emplace(extracted_data);
+                spdlog::error("Error parsing websocket data: {}\n{}", new_data.View(), e.what());
             }
-
-            processor_ctx.cv_.notify_one();
-        }
-        catch (const std::exception &e)
-        {
-            spdlog::error("Error parsing websocket data: {}\n{}", new_data, e.what());
         }
     }
 };
@@ -1539,7 +2277,7 @@ void PF_CollectDataApp::ProcessUpdatesForSymbol(RemoteDataSource::ProcessorConte
 
     while (true)
     {
-        RemoteDataSource::PF_Data pf_data;
+        std::vector<RemoteDataSource::PF_Data> updates;
         {
             std::unique_lock<std::mutex> lock(processor_context.mtx_);
 
@@ -1557,55 +2295,83 @@ void PF_CollectDataApp::ProcessUpdatesForSymbol(RemoteDataSource::ProcessorConte
             {
                 continue;
             }
-            pf_data = std::move(processor_context.extracted_data_.front());
-            processor_context.extracted_data_.pop();
+
+            // if we have fallen too far behind, take the whole backlog at once.
+
+            auto &waiting = processor_context.extracted_data_;
+            const bool take_all = conflate_above_ > 0 && std::ssize(waiting) > conflate_above_ &&
+                                  CanConflateTicksFor(waiting.front().ticker_);
+            do
+            {
+                updates.push_back(std::move(waiting.front()));
+                waiting.pop();
+            } while (take_all && !waiting.empty());
+            streaming_metrics_->SetSymbolQueueDepth(updates.front().ticker_, std::ssize(waiting));
         }
+        streaming_metrics_->RecordSince(PF_StreamingMetrics::Stage::e_process_queue, updates.front().parsed_at_);
 
-        // our PF_Data contains data for just 1 transaction for 1 symbol
-        try
+        if (updates.size() > 1)
         {
-            Do_ProcessUpdatesForSymbol(pf_data);
+            const auto backlog = updates.size();
+            std::erase_if(updates, [](const auto &update) { return !IsChartableUpdate(update); });
+            updates = ConflateTicks(std::move(updates), [](const auto &update) -> const decimal::Decimal & {
+                return update.last_price_;
+            });
+            if (!updates.empty())
+            {
+                streaming_metrics_->CountConflated(updates.front().ticker_, backlog - updates.size());
+            }
         }
-        catch (std::system_error &e)
+
+        // our PF_Data contains data for just 1 transaction for 1 symbol
+        for (const auto &pf_data : updates)
         {
-            // any system problems, we eventually abort, but only
-            // after finishing work in process.
+            try
+            {
+                Do_ProcessUpdatesForSymbol(pf_data);
+            }
+            catch (std::system_error &e)
+            {
+                // any system problems, we eventually abort, but only
+                // after finishing work in process.
 
-            spdlog::error(e.what());
-            auto ec = e.code();
-            spdlog::error("Category: {}. Value: {}. Message: {}.", ec.category().name(), ec.value(), ec.message());
+                spdlog::error(e.what());
+                auto ec = e.code();
+                spdlog::error("Category: {}. Value: {}. Message: {}.", ec.category().name(), ec.value(),
+                              ec.message());
 
-            // OK, let's remember our first time here.
+                // OK, let's remember our first time here.
 
-            if (!ep)
-            {
-                ep = std::current_exception();
+                if (!ep)
+                {
+                    ep = std::current_exception();
+                }
+                continue;
             }
-            continue;
-        }
-        catch (std::exception &e)
-        {
-            // any problems, we'll document them and continue.
+            catch (std::exception &e)
+            {
+                // any problems, we'll document them and continue.
 
-            spdlog::error(e.what());
+                spdlog::error(e.what());
 
-            if (!ep)
-            {
-                ep = std::current_exception();
+                if (!ep)
+                {
+                    ep = std::current_exception();
+                }
+                continue;
             }
-            continue;
-        }
-        catch (...)
-        {
-            // any problems, we'll document them and continue.
+            catch (...)
+            {
+                // any problems, we'll document them and continue.
 
-            spdlog::error("Unknown problem with an async download process");
+                spdlog::error("Unknown problem with an async download process");
 
-            if (!ep)
-            {
-                ep = std::current_exception();
+                if (!ep)
+                {
+                    ep = std::current_exception();
+                }
+                continue;
             }
-            continue;
         }
     }
     if (ep)
@@ -1615,23 +2381,32 @@ void PF_CollectDataApp::ProcessUpdatesForSymbol(RemoteDataSource::ProcessorConte
 
 } // -----  end of method PF_CollectDataApp::ProcessEodhdStreamedData  -----
 
-void PF_CollectDataApp::Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Data &update)
+bool PF_CollectDataApp::CanConflateTicksFor(const std::string &symbol) const
 {
-    // it is possible that the update could be empty if there was a problem extracting
-    // the data.
-    // Also, for now, we want to skip 'dark pool' transactions.
-    // AND skip 1-share transactions -- maybe these are algo-traders probing the market.
+    // only this symbol's processor changes its charts so we can look at them without a lock.
+    // See ConflateTicks() for why these charts can't be conflated.
+
+    return rng::all_of(charts_ | vws::filter([&symbol](const auto &symbol_and_chart) {
+                           return symbol_and_chart.first == symbol;
+                       }),
+                       [](const auto &symbol_and_chart) {
+                           return symbol_and_chart.second.GetReversalboxes() > 1 &&
+                                  symbol_and_chart.second.GetCurrentDirection() != PF_Column::Direction::e_Unknown;
+                       });
+} // -----  end of method PF_CollectDataApp::CanConflateTicksFor  -----
 
-    if (update.last_price_ == -1 || update.dark_pool_ || update.last_size_ == 1)
+void PF_CollectDataApp::Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Data &update)
+{
+    if (!IsChartableUpdate(update))
     {
-        // last_price_ = -1 means the field was not set
-        // during data extraction.
         return;
     }
 
     std::vector<PF_Chart *> need_to_update_graph;
     PF_SignalType new_signal{PF_SignalType::e_unknown};
 
+    const auto apply_started_at = std::chrono::steady_clock::now();
+
     // since we can have multiple charts for each symbol, we need to pass the
     // new value to all appropriate charts so we find all the charts for each
     // symbol and give each a chance at the new data.
@@ -1644,12 +2419,24 @@ void PF_CollectDataApp::Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Da
             {
                 auto chart_changed = symbol_and_chart.second.AddValue(
                     update.last_price_, PF_Column::TmPt{update.time_stamp_nanoseconds_utc_});
+                if (shared_state_)
+                {
+                    shared_state_->Publish(
+                        static_cast<size_t>(&symbol_and_chart - charts_.data()),
+                        MakeSharedChartState(symbol_and_chart.second, dec2dbl(update.last_price_),
+                                             update.time_stamp_nanoseconds_utc_.time_since_epoch().count()));
+                }
                 if (chart_changed != PF_Column::Status::e_Ignored)
                 {
                     need_to_update_graph.push_back(&symbol_and_chart.second);
                     if (chart_changed == PF_Column::Status::e_AcceptedWithSignal)
                     {
-                        new_signal = symbol_and_chart.second.GetMostRecentSignal().value().signal_type_;
+                        const auto signal = symbol_and_chart.second.GetMostRecentSignal().value();
+                        new_signal = signal.signal_type_;
+                        if (signal_bus_)
+                        {
+                            signal_bus_->Publish(MakeSignalEvent(symbol_and_chart.second, signal, update.received_at_));
+                        }
                     }
                 }
             }
@@ -1660,6 +2447,12 @@ void PF_CollectDataApp::Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Da
             }
         });
 
+    streaming_metrics_->RecordSince(PF_StreamingMetrics::Stage::e_chart_apply, apply_started_at);
+    if (new_signal != PF_SignalType::e_unknown)
+    {
+        streaming_metrics_->RecordSince(PF_StreamingMetrics::Stage::e_tick_to_signal, update.received_at_);
+    }
+
     // we only need to collect this data once per symbol.
     // we'll share it when we do graphics for each PF_Chart.
 
@@ -1672,36 +2465,52 @@ void PF_CollectDataApp::Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Da
     const auto [first, last] = rng::unique(need_to_update_graph);
     need_to_update_graph.erase(first, last);
 
-    auto now = std::chrono::system_clock::now();
+    // hand off copies of the changed charts for drawing. If the previous copy hasn't
+    // been drawn yet, we don't need it any more.
+
+    std::vector<std::pair<std::string, std::shared_ptr<const PF_Chart>>> snapshots;
+    snapshots.reserve(need_to_update_graph.size());
     for (const PF_Chart *chart : need_to_update_graph)
     {
-        auto last_drawn = last_draw_times_.at(chart->GetSymbol());
-        if (now < last_drawn + minimum_delay_)
+        snapshots.emplace_back(chart->GetChartBaseName(), std::make_shared<const PF_Chart>(*chart));
+    }
+    if (chart_query_)
+    {
+        for (const auto &[chart_name, snapshot] : snapshots)
         {
-            continue;
+            chart_query_->Publish(chart_name, snapshot);
         }
-        try
-        {
-            fs::path graph_file_path = output_graphs_directory_ / (chart->MakeChartFileName("", "svg"));
-            ConstructCDPFChartGraphicAndWriteToFile(*chart, graph_file_path, streamed_prices_[chart->GetSymbol()],
-                                                    trend_lines_, X_AxisFormat::e_show_time);
-
-            fs::path chart_file_path = output_chart_directory_ / (chart->MakeChartFileName("", "json"));
-            chart->ConvertChartToJsonAndWriteToFile(chart_file_path);
-            last_draw_times_.at(chart->GetSymbol()) = now;
-        }
-        catch (std::exception &e)
+    }
+    auto publish = [&snapshots, &update](ChartSnapshotContext &context) {
+        for (const auto &[chart_name, snapshot] : snapshots)
         {
-            spdlog::error("Problem creating graphic for updated streamed value: "s += chart->GetChartBaseName() +=
-                          " "s += e.what());
+            auto [dirty, inserted] =
+                context.dirty_charts_.try_emplace(chart_name, ChartSnapshot{snapshot, update.received_at_});
+            if (!inserted)
+            {
+                dirty->second.chart_ = snapshot;
+            }
         }
+    };
+    {
+        std::lock_guard<std::mutex> lock(render_context_.mtx_);
+        publish(render_context_);
+        render_context_.summary_dirty_ = true;
+        streaming_metrics_->SetQueueDepth(PF_StreamingMetrics::Queue::e_render,
+                                          std::ssize(render_context_.dirty_charts_));
     }
-
-    if (now > last_summary_draw_time_ + minimum_delay_)
+    if (live_db_interval_ > 0)
+    {
+        std::lock_guard<std::mutex> lock(persist_context_.mtx_);
+        publish(persist_context_);
+        streaming_metrics_->SetQueueDepth(PF_StreamingMetrics::Queue::e_persist,
+                                          std::ssize(persist_context_.dirty_charts_));
+    }
+    if (checkpoint_)
     {
-        fs::path summary_graphic_path = output_graphs_directory_ / "PF_StreamingSummary.svg";
-        ConstructCDSummaryGraphic(streamed_summary_, summary_graphic_path);
-        last_summary_draw_time_ = now;
+        std::lock_guard<std::mutex> lock(checkpoint_context_.mtx_);
+        publish(checkpoint_context_);
+        checkpoint_context_.dirty_symbols_.insert(update.ticker_);
     }
 } // -----  end of method PF_CollectDataApp::ProcessUpdatesForEodhdSymbol  -----
 
@@ -1713,6 +2522,8 @@ void PF_CollectDataApp::CollectStreamedData(const RemoteDataSource::PF_Data &upd
 
     const auto new_time_stamp =
         std::chrono::duration_cast<std::chrono::seconds>(update.time_stamp_nanoseconds_utc_.time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> prices_lock(streamed_prices_mtxs_.at(update.ticker_));
     if (!streamed_prices_[update.ticker_].timestamp_seconds_.empty())
     {
         if (new_time_stamp > streamed_prices_[update.ticker_].timestamp_seconds_.back())
@@ -1741,10 +2552,223 @@ void PF_CollectDataApp::CollectStreamedData(const RemoteDataSource::PF_Data &upd
 
     // simple update for summary
 
+    std::lock_guard<std::mutex> summary_lock(streamed_summary_mtx_);
     streamed_summary_[update.ticker_].latest_price_ = dec2dbl(update.last_price_);
 
+    // charts which were not primed (replays) start from their first streamed price.
+
+    if (streamed_summary_[update.ticker_].opening_price_ == 0.0)
+    {
+        streamed_summary_[update.ticker_].opening_price_ = streamed_summary_[update.ticker_].latest_price_;
+    }
+
 } // -----  end of method PF_CollectDataApp::CollectEodhdStreamedData  -----
 
+void PF_CollectDataApp::RenderStreamedCharts()
+{
+    // each pass draws everything which has changed since the last pass then waits
+    // so no chart is drawn more often than once every minimum_delay_.
+
+    while (true)
+    {
+        std::map<std::string, ChartSnapshot> dirty_charts;
+        bool summary_dirty = false;
+        bool done = false;
+        {
+            std::unique_lock<std::mutex> lock(render_context_.mtx_);
+            render_context_.cv_.wait_for(lock, minimum_delay_, [this] { return render_context_.done_; });
+
+            dirty_charts.swap(render_context_.dirty_charts_);
+            std::swap(summary_dirty, render_context_.summary_dirty_);
+            done = render_context_.done_;
+        }
+        streaming_metrics_->SetQueueDepth(PF_StreamingMetrics::Queue::e_render, 0);
+
+        // we need the streamed prices for each symbol, but only once per pass.
+
+        std::map<std::string, StreamedPrices> prices_for_symbols;
+
+        for (const auto &[chart_name, snapshot] : dirty_charts)
+        {
+            try
+            {
+                const auto render_started_at = std::chrono::steady_clock::now();
+                const auto &chart = snapshot.chart_;
+                const auto &symbol = chart->GetSymbol();
+                auto prices = prices_for_symbols.find(symbol);
+                if (prices == prices_for_symbols.end())
+                {
+                    std::lock_guard<std::mutex> prices_lock(streamed_prices_mtxs_.at(symbol));
+                    prices = prices_for_symbols.emplace(symbol, streamed_prices_.at(symbol)).first;
+                }
+
+                fs::path graph_file_path = output_graphs_directory_ / (chart->MakeChartFileName("", "svg"));
+                auto graphic =
+                    ConstructCDPFChartGraphicAsSVG(*chart, prices->second, trend_lines_, X_AxisFormat::e_show_time);
+
+                fs::path chart_file_path = output_chart_directory_ / (chart->MakeChartFileName("", "json"));
+                std::ostringstream chart_json;
+                chart->ConvertChartToJsonAndWriteToStream(chart_json);
+
+                streaming_metrics_->RecordSince(PF_StreamingMetrics::Stage::e_render, render_started_at);
+                streaming_metrics_->RecordSince(PF_StreamingMetrics::Stage::e_tick_to_render, snapshot.received_at_);
+
+                // only the graphic is timed to disk. The JSON goes out with it.
+
+                file_sink_->Write(graph_file_path, std::move(graphic), snapshot.received_at_);
+                file_sink_->Write(chart_file_path, std::move(chart_json).str());
+            }
+            catch (std::exception &e)
+            {
+                spdlog::error(
+                    std::format("Problem creating graphic for updated streamed value: {} {}", chart_name, e.what()));
+            }
+        }
+
+        if (summary_dirty)
+        {
+            try
+            {
+                PF_StreamedSummary summary;
+                {
+                    std::lock_guard<std::mutex> summary_lock(streamed_summary_mtx_);
+                    summary = streamed_summary_;
+                }
+                fs::path summary_graphic_path = output_graphs_directory_ / "PF_StreamingSummary.svg";
+                file_sink_->Write(summary_graphic_path, ConstructCDSummaryGraphicAsSVG(summary));
+            }
+            catch (std::exception &e)
+            {
+                spdlog::error(std::format("Problem creating streaming summary graphic: {}", e.what()));
+            }
+        }
+
+        if (done)
+        {
+            break;
+        }
+    }
+} // -----  end of method PF_CollectDataApp::RenderStreamedCharts  -----
+
+void PF_CollectDataApp::PersistStreamedCharts()
+{
+    // however many times a chart changes during an interval, we write it only once
+    // and all the charts which changed go in a single transaction. That keeps the load
+    // on the database the same no matter how busy the market is.
+
+    const std::chrono::seconds interval{live_db_interval_};
+    PF_DB pf_db{db_params_};
+
+    while (true)
+    {
+        std::map<std::string, ChartSnapshot> dirty_charts;
+        bool done = false;
+        {
+            std::unique_lock<std::mutex> lock(persist_context_.mtx_);
+            persist_context_.cv_.wait_for(lock, interval, [this] { return persist_context_.done_; });
+
+            dirty_charts.swap(persist_context_.dirty_charts_);
+            done = persist_context_.done_;
+        }
+        streaming_metrics_->SetQueueDepth(PF_StreamingMetrics::Queue::e_persist, 0);
+
+        // at the end, shutdown will store everything so no need to do it here.
+
+        if (done)
+        {
+            break;
+        }
+        if (dirty_charts.empty())
+        {
+            continue;
+        }
+
+        std::vector<const PF_Chart *> charts;
+        charts.reserve(dirty_charts.size());
+        for (const auto &[chart_name, snapshot] : dirty_charts)
+        {
+            charts.push_back(snapshot.chart_.get());
+        }
+
+        try
+        {
+            PF_Chart::UpsertChartsInChartsDB(pf_db, charts, interval_i_, X_AxisFormat::e_show_time,
+                                             graphics_format_ == GraphicsFormat::e_csv);
+            spdlog::debug(std::format("Stored {} changed streamed charts in DB.", charts.size()));
+        }
+        catch (std::exception &e)
+        {
+            // put back what we didn't store unless there is a newer version already.
+
+            spdlog::error(std::format("Problem storing {} streamed charts in DB: {}", charts.size(), e.what()));
+            std::lock_guard<std::mutex> lock(persist_context_.mtx_);
+            persist_context_.dirty_charts_.merge(dirty_charts);
+        }
+    }
+} // -----  end of method PF_CollectDataApp::PersistStreamedCharts  -----
+
+void PF_CollectDataApp::CheckpointStreamingSession()
+{
+    // unlike the DB, the checkpoint is also written at the end so a restart later in
+    // the day has every tick we saw.
+
+    PF_TRACE_THREAD_NAME("checkpoint");
+
+    const std::chrono::seconds interval{checkpoint_interval_};
+    bool done = false;
+    while (!done)
+    {
+        std::map<std::string, ChartSnapshot> dirty_charts;
+        std::set<std::string> dirty_symbols;
+        {
+            std::unique_lock<std::mutex> lock(checkpoint_context_.mtx_);
+            checkpoint_context_.cv_.wait_for(lock, interval, [this] { return checkpoint_context_.done_; });
+
+            dirty_charts.swap(checkpoint_context_.dirty_charts_);
+            dirty_symbols.swap(checkpoint_context_.dirty_symbols_);
+            done = checkpoint_context_.done_;
+        }
+        if (dirty_charts.empty() && dirty_symbols.empty())
+        {
+            continue;
+        }
+
+        const auto started_at = std::chrono::steady_clock::now();
+        try
+        {
+            for (const auto &[chart_name, snapshot] : dirty_charts)
+            {
+                checkpoint_->UpdateChart(*snapshot.chart_);
+            }
+            for (const auto &symbol : dirty_symbols)
+            {
+                StreamedPrices prices;
+                {
+                    std::lock_guard<std::mutex> prices_lock(streamed_prices_mtxs_.at(symbol));
+                    prices = streamed_prices_.at(symbol);
+                }
+                PF_Checkpoint::SymbolSummary summary;
+                {
+                    std::lock_guard<std::mutex> summary_lock(streamed_summary_mtx_);
+                    summary = streamed_summary_.at(symbol);
+                }
+                checkpoint_->UpdateSymbol(symbol, prices, summary);
+            }
+            const auto bytes = checkpoint_->Save();
+            spdlog::debug(std::format("Checkpoint of {} changed charts and {} symbols. {} bytes in {}.",
+                                      dirty_charts.size(), dirty_symbols.size(), bytes,
+                                      std::chrono::duration_cast<std::chrono::milliseconds>(
+                                          std::chrono::steady_clock::now() - started_at)));
+        }
+        catch (const std::exception &e)
+        {
+            // the records we did update are kept so the next checkpoint still has them.
+
+            spdlog::error(std::format("Problem writing checkpoint: {}: {}", checkpoint_file_, e.what()));
+        }
+    }
+} // -----  end of method PF_CollectDataApp::CheckpointStreamingSession  -----
+
 std::tuple<int, int, int> PF_CollectDataApp::Run_DailyScan()
 {
     // I expect this will be run fairly often so that the amount of data
@@ -1756,11 +2780,17 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_DailyScan()
     int32_t total_charts_processed = 0;
     int32_t total_charts_updated = 0;
 
+    PF_TRACE_THREAD_NAME("main");
+    PF_TRACE_SCOPE("phase", "Run_DailyScan");
+
+    run_stats_ = std::make_unique<PF_RunStats>("daily_scan");
+
     PF_DB pf_db{db_params_};
     const auto *dt_format = "%F";
 
     if (exchange_list_.empty())
     {
+        PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_list_exchanges};
         exchange_list_ = pf_db.ListExchanges();
 
         // eliminate some exchanges we don't want to process
@@ -1785,8 +2815,16 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_DailyScan()
         int32_t exchange_charts_processed = 0;
         int32_t exchange_charts_updated = 0;
 
-        auto db_data = pf_db.GetPriceDataForSymbolsOnExchange(xchng, begin_date_, end_date_, price_fld_name_, dt_format,
-                                                              min_dollar_volume_);
+        PF_TRACE_SCOPE_ARG("phase", "scan_exchange", xchng);
+        run_stats_->SetExchange(xchng);
+
+        auto db_data = [&] {
+            PF_TRACE_SCOPE("db", "query_prices");
+            PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_fetch_prices};
+            return pf_db.GetPriceDataForSymbolsOnExchange(xchng, begin_date_, end_date_, price_fld_name_, dt_format,
+                                                          min_dollar_volume_);
+        }();
+        run_stats_->AddRows(static_cast<int64_t>(db_data.size()), EstimateFetchedBytes(db_data, dt_format));
         // ranges::for_each(db_data, [](const auto& xx) {std::print("{}, {},
         // {}\n", xx.symbol, xx.tp, xx.price); });
 
@@ -1798,9 +2836,15 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_DailyScan()
             const auto &symbol = symbol_rng[0].symbol_;
             exchange_symbols_processed += 1;
 
+            PF_TRACE_SCOPE_ARG("symbol", "scan_symbol", symbol);
+
             // std::print("symbol: {}\n", symbol);
 
-            auto charts_for_symbol = pf_db.RetrieveAllEODChartsForSymbol(symbol);
+            auto charts_for_symbol = [&] {
+                PF_TRACE_SCOPE("db", "load_charts");
+                PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_retrieve_charts};
+                return pf_db.RetrieveAllEODChartsForSymbol(symbol);
+            }();
 
             for (auto &chart : charts_for_symbol)
             {
@@ -1810,13 +2854,19 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_DailyScan()
                 bool chart_needs_update = false;
                 try
                 {
-                    rng::for_each(symbol_rng, [&chart, &chart_needs_update](const auto &row) {
-                        auto status = chart.AddValue(row.close_, row.date_);
-                        chart_needs_update |= status == PF_Column::Status::e_Accepted ? 1 : 0;
-                    });
+                    {
+                        PF_TRACE_SCOPE("chart", "apply_prices");
+                        PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_apply};
+                        rng::for_each(symbol_rng, [&chart, &chart_needs_update](const auto &row) {
+                            auto status = chart.AddValue(row.close_, row.date_);
+                            chart_needs_update |= status == PF_Column::Status::e_Accepted ? 1 : 0;
+                        });
+                    }
                     if (chart_needs_update)
                     {
                         // we are only doing EOD charts in this routine.
+                        PF_TRACE_SCOPE("db", "update_chart");
+                        PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_write};
                         chart.UpdateChartInChartsDB(pf_db, interval_i_, X_AxisFormat::e_show_date,
                                                     graphics_format_ == GraphicsFormat::e_csv);
                         exchange_charts_updated += 1;
@@ -1839,11 +2889,20 @@ std::tuple<int, int, int> PF_CollectDataApp::Run_DailyScan()
                                  xchng, exchange_symbols_processed, exchange_charts_processed,
                                  exchange_charts_updated));
 
-        pf_db.UpdateLastCheckedDateInChartsDB(xchng, end_date_);
+        run_stats_->AddSymbols(exchange_symbols_processed);
+        run_stats_->AddCharts(exchange_charts_processed, exchange_charts_updated);
+        {
+            PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_write};
+            pf_db.UpdateLastCheckedDateInChartsDB(xchng, end_date_);
+        }
+        run_stats_->SetExchange({});
     }
 
     // just collect some stats on overall effect of running the scan
 
+    PF_TRACE_SCOPE("db", "count_trends");
+    PF_RunStats::PhaseTimer stats_timer{run_stats_.get(), PF_RunStats::Phase::e_stats_queries};
+
     const auto [ups1, downs1] = CountChartReversalsUpAndDown();
 
     const auto [ups2, downs2] = CountChartTrendsContinueUpAndDown();
@@ -1916,17 +2975,502 @@ std::pair<int, int> PF_CollectDataApp::CountChartTrendsUnanimousUpAndDown() cons
     return std::make_pair(charts_up, charts_down);
 } // -----  end of method PF_CollectDataApp::CountChartTrendsUnanimousUpAndDown----
 
+void PF_CollectDataApp::Run_Service()
+{
+    // keep going until told to stop by a 'shutdown' command or a signal.
+
+    InstallSignalHandlers();
+
+    LoadResidentCharts();
+
+    UnixSocketServer server{service_socket_path_, [this](std::string_view request, UnixSocketServer::Reply reply) {
+                                HandleServiceRequest(request, std::move(reply));
+                            }};
+    server.Start();
+
+    while (true)
+    {
+        ServiceCommand command;
+        {
+            // a signal handler can't notify us so check for one every so often.
+
+            std::unique_lock<std::mutex> lock(service_context_.mtx_);
+            service_context_.cv_.wait_for(lock, 1s, [this] {
+                return !service_context_.commands_.empty() || service_context_.done_ || stop_service_;
+            });
+            if (service_context_.done_ || stop_service_)
+            {
+                break;
+            }
+            if (service_context_.commands_.empty())
+            {
+                continue;
+            }
+            command = std::move(service_context_.commands_.front());
+            service_context_.commands_.pop();
+        }
+        service_busy_ = true;
+        command.reply_(DoServiceCommand(command.request_));
+        service_busy_ = false;
+    }
+
+    // anything still waiting won't be done. Nothing new is accepted once done_ is set.
+
+    {
+        std::lock_guard<std::mutex> lock(service_context_.mtx_);
+        service_context_.done_ = true;
+        for (; !service_context_.commands_.empty(); service_context_.commands_.pop())
+        {
+            service_context_.commands_.front().reply_(R"({"status":"error","message":"service is stopping"})");
+        }
+    }
+
+    if (service_streaming_task_.valid())
+    {
+        stop_streaming_requested_ = true;
+        service_streaming_task_.get();
+    }
+
+    server.Stop();
+    spdlog::info("Service stopped.");
+} // -----  end of method PF_CollectDataApp::Run_Service  -----
+
+void PF_CollectDataApp::LoadResidentCharts()
+{
+    PF_TRACE_SCOPE("db", "load_resident_charts");
+
+    const auto started_at = std::chrono::steady_clock::now();
+
+    PF_DB pf_db{db_params_};
+    resident_charts_ = pf_db.RetrieveAllEODCharts();
+    unsaved_symbols_.clear();
+
+    const auto chart_count = rng::fold_left(resident_charts_ | vws::values | vws::transform(rng::size), int64_t{0},
+                                            std::plus<int64_t>());
+    resident_symbol_count_ = static_cast<int64_t>(resident_charts_.size());
+    resident_chart_count_ = chart_count;
+
+    spdlog::info(std::format("Loaded {} EOD charts for {} symbols in {:%S} seconds.", chart_count,
+                             resident_charts_.size(),
+                             std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                   started_at)));
+} // -----  end of method PF_CollectDataApp::LoadResidentCharts  -----
+
+void PF_CollectDataApp::HandleServiceRequest(std::string_view request, UnixSocketServer::Reply reply)
+{
+    // this runs on the socket server's thread. Quick questions are answered here,
+    // anything which changes charts is queued for the service thread.
+
+    auto to_text = [](const Json::Value &response) {
+        Json::StreamWriterBuilder builder;
+        builder["indentation"] = ""; // compact printing and string formatting
+        return Json::writeString(builder, response);
+    };
+
+    const auto command = request.substr(0, request.find(' '));
+
+    Json::Value response;
+    response["command"] = std::string{command};
+    response["status"] = "ok";
+
+    if (command == "status")
+    {
+        std::lock_guard<std::mutex> lock(service_context_.mtx_);
+        response["symbols"] = Json::Int64{resident_symbol_count_};
+        response["charts"] = Json::Int64{resident_chart_count_};
+        response["queued"] = static_cast<Json::UInt64>(service_context_.commands_.size());
+        response["busy"] = service_busy_.load();
+        response["streaming"] = service_streaming_.load();
+        reply(to_text(response));
+        return;
+    }
+    if (command == "help")
+    {
+        response["commands"] =
+            "status | daily-scan [begin-date [end-date]] | update SYMBOL[,SYMBOL...] [begin-date [end-date]] | "
+            "reload | stream-start | stream-stop | shutdown";
+        reply(to_text(response));
+        return;
+    }
+    if (command == "stream-stop")
+    {
+        if (service_streaming_)
+        {
+            stop_streaming_requested_ = true;
+            response["message"] = "streaming will stop and its charts will be saved";
+        }
+        else
+        {
+            response["status"] = "error";
+            response["message"] = "not streaming";
+        }
+        reply(to_text(response));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(service_context_.mtx_);
+    if (service_context_.done_)
+    {
+        response["status"] = "error";
+        response["message"] = "service is stopping";
+        reply(to_text(response));
+        return;
+    }
+    if (command == "shutdown")
+    {
+        service_context_.done_ = true;
+        response["message"] = "stopping";
+        reply(to_text(response));
+    }
+    else
+    {
+        service_context_.commands_.push(ServiceCommand{.request_ = std::string{request}, .reply_ = std::move(reply)});
+    }
+    service_context_.cv_.notify_one();
+} // -----  end of method PF_CollectDataApp::HandleServiceRequest  -----
+
+std::string PF_CollectDataApp::DoServiceCommand(const std::string &request)
+{
+    std::vector<std::string> args;
+    rng::for_each(split_string<std::string>(request, " "), [&args](const auto &arg) {
+        if (!arg.empty())
+        {
+            args.push_back(arg);
+        }
+    });
+    const std::string command = args.empty() ? "" : args.front();
+    if (!args.empty())
+    {
+        args.erase(args.begin());
+    }
+
+    Json::Value response;
+    try
+    {
+        if (command == "daily-scan")
+        {
+            response = ServiceDailyScan(args);
+        }
+        else if (command == "update")
+        {
+            response = ServiceUpdateSymbols(args);
+        }
+        else if (command == "reload")
+        {
+            LoadResidentCharts();
+            response["symbols"] = Json::Int64{resident_symbol_count_};
+            response["charts"] = Json::Int64{resident_chart_count_};
+        }
+        else if (command == "stream-start")
+        {
+            response = ServiceStartStreaming();
+        }
+        else
+        {
+            response["status"] = "error";
+            response["message"] = std::format("unknown command: '{}'. Try 'help'.", command);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Service command: '{}' failed because: {}", request, e.what()));
+        response = Json::Value{};
+        response["status"] = "error";
+        response["message"] = e.what();
+    }
+    response["command"] = command;
+    if (!response.isMember("status"))
+    {
+        response["status"] = "ok";
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = ""; // compact printing and string formatting
+    return Json::writeString(builder, response);
+} // -----  end of method PF_CollectDataApp::DoServiceCommand  -----
+
+Json::Value PF_CollectDataApp::ServiceDailyScan(const std::vector<std::string> &args)
+{
+    PF_TRACE_SCOPE("phase", "ServiceDailyScan");
+
+    // same defaults as a daily-scan run: through yesterday, starting at 'begin-date' if given.
+
+    std::chrono::year_month_day yesterday{--floor<std::chrono::days>(std::chrono::system_clock::now())};
+    const std::string end_date = args.size() > 1 ? args[1] : std::format("{:%Y-%m-%d}", yesterday);
+    const std::string begin_date = !args.empty() ? args[0] : !begin_date_.empty() ? begin_date_ : end_date;
+    StringToDateYMD("%F", begin_date);
+    StringToDateYMD("%F", end_date);
+
+    PF_RunStats stats{"service_daily_scan"};
+    PF_DB pf_db{db_params_};
+
+    std::vector<std::string> exchanges = exchange_list_;
+    if (exchanges.empty())
+    {
+        PF_RunStats::PhaseTimer timer{&stats, PF_RunStats::Phase::e_list_exchanges};
+        exchanges = pf_db.ListExchanges();
+
+        // eliminate some exchanges we don't want to process
+
+        auto dont_use = [](const auto &xchng) { return xchng == "NMFQS" || xchng == "INDX" || xchng == "US"; };
+        const auto [first, last] = rng::remove_if(exchanges, dont_use);
+        exchanges.erase(first, last);
+    }
+
+    Json::Value results{Json::objectValue};
+    for (const auto &xchng : exchanges)
+    {
+        stats.SetExchange(xchng);
+        auto db_data = [&] {
+            PF_RunStats::PhaseTimer timer{&stats, PF_RunStats::Phase::e_fetch_prices};
+            return pf_db.GetPriceDataForSymbolsOnExchange(xchng, begin_date, end_date, price_fld_name_, "%F",
+                                                          min_dollar_volume_);
+        }();
+        stats.AddRows(static_cast<int64_t>(db_data.size()), EstimateFetchedBytes(db_data, "%F"));
+
+        results[xchng] = ApplyPricesToResidentCharts(db_data, end_date, stats);
+
+        PF_RunStats::PhaseTimer timer{&stats, PF_RunStats::Phase::e_write};
+        pf_db.UpdateLastCheckedDateInChartsDB(xchng, end_date);
+    }
+    stats.SetExchange({});
+
+    Json::Value response;
+    response["begin_date"] = begin_date;
+    response["end_date"] = end_date;
+    response["exchanges"] = results;
+    response["stats"] = stats.ToJSON();
+    return response;
+} // -----  end of method PF_CollectDataApp::ServiceDailyScan  -----
+
+Json::Value PF_CollectDataApp::ServiceUpdateSymbols(const std::vector<std::string> &args)
+{
+    PF_TRACE_SCOPE("phase", "ServiceUpdateSymbols");
+
+    Json::Value response;
+    if (args.empty())
+    {
+        response["status"] = "error";
+        response["message"] = "usage: update SYMBOL[,SYMBOL...] [begin-date [end-date]]";
+        return response;
+    }
+
+    std::vector<std::string> symbols;
+    rng::for_each(split_string<std::string>(args[0], ","), [&symbols](auto symbol) {
+        rng::for_each(symbol, [](char &c) { c = std::toupper(c); });
+        symbols.push_back(std::move(symbol));
+    });
+    rng::sort(symbols);
+    const auto [first, last] = rng::unique(symbols);
+    symbols.erase(first, last);
+
+    std::chrono::year_month_day yesterday{--floor<std::chrono::days>(std::chrono::system_clock::now())};
+    const std::string end_date = args.size() > 2 ? args[2] : std::format("{:%Y-%m-%d}", yesterday);
+    const std::string begin_date = args.size() > 1 ? args[1] : !begin_date_.empty() ? begin_date_ : end_date;
+    StringToDateYMD("%F", begin_date);
+    StringToDateYMD("%F", end_date);
+
+    PF_RunStats stats{"service_update"};
+    PF_DB pf_db{db_params_};
+
+    auto db_data = [&] {
+        PF_RunStats::PhaseTimer timer{&stats, PF_RunStats::Phase::e_fetch_prices};
+        return pf_db.GetPriceDataForSymbolsInList(symbols, begin_date, end_date, price_fld_name_, "%F");
+    }();
+    stats.AddRows(static_cast<int64_t>(db_data.size()), EstimateFetchedBytes(db_data, "%F"));
+
+    response = ApplyPricesToResidentCharts(db_data, end_date, stats);
+    response["begin_date"] = begin_date;
+    response["end_date"] = end_date;
+    response["stats"] = stats.ToJSON();
+    return response;
+} // -----  end of method PF_CollectDataApp::ServiceUpdateSymbols  -----
+
+Json::Value PF_CollectDataApp::ApplyPricesToResidentCharts(const std::vector<MultiSymbolDateCloseRecord> &db_data,
+                                                           const std::string &end_date, PF_RunStats &stats)
+{
+    // our data from the DB is grouped by symbol so we split it into sub-ranges
+    // by symbol below.
+
+    auto data_for_symbol = vws::chunk_by([](const auto &a, const auto &b) { return a.symbol_ == b.symbol_; });
+
+    int64_t symbols_processed = 0;
+    int64_t charts_processed = 0;
+    int64_t charts_updated = 0;
+    Json::Value not_resident{Json::arrayValue};
+
+    // we only store the charts which changed (plus any which we couldn't store last time).
+
+    std::set<std::string, std::less<>> changed_symbols;
+    std::vector<const PF_Chart *> changed_charts;
+
+    for (const auto &symbol_rng : db_data | data_for_symbol)
+    {
+        const auto &symbol = symbol_rng[0].symbol_;
+        auto found = resident_charts_.find(symbol);
+        if (found == resident_charts_.end())
+        {
+            not_resident.append(symbol);
+            continue;
+        }
+        ++symbols_processed;
+
+        PF_RunStats::PhaseTimer timer{&stats, PF_RunStats::Phase::e_apply};
+        for (auto &chart : found->second)
+        {
+            ++charts_processed;
+            bool chart_needs_update = false;
+            try
+            {
+                rng::for_each(symbol_rng, [&chart, &chart_needs_update](const auto &row) {
+                    auto status = chart.AddValue(row.close_, row.date_);
+                    chart_needs_update |= status == PF_Column::Status::e_Accepted ? 1 : 0;
+                });
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error(std::format("Unable to update resident chart: {} because: {}.",
+                                          chart.MakeChartFileName("eod", ""), e.what()));
+            }
+            if (chart_needs_update)
+            {
+                changed_charts.push_back(&chart);
+                changed_symbols.insert(symbol);
+                ++charts_updated;
+            }
+        }
+    }
+    for (const auto &symbol : unsaved_symbols_)
+    {
+        if (!changed_symbols.contains(symbol))
+        {
+            rng::for_each(resident_charts_.at(symbol),
+                          [&changed_charts](const auto &chart) { changed_charts.push_back(&chart); });
+            changed_symbols.insert(symbol);
+        }
+    }
+    stats.AddSymbols(symbols_processed);
+    stats.AddCharts(charts_processed, charts_updated);
+
+    Json::Value response;
+    try
+    {
+        PF_RunStats::PhaseTimer timer{&stats, PF_RunStats::Phase::e_write};
+        if (!changed_charts.empty())
+        {
+            PF_Chart::UpsertChartsInChartsDB(PF_DB{db_params_}, changed_charts, "eod", X_AxisFormat::e_show_date,
+                                             graphics_format_ == GraphicsFormat::e_csv);
+        }
+        unsaved_symbols_.clear();
+        response["charts_stored"] = static_cast<Json::UInt64>(changed_charts.size());
+    }
+    catch (const std::exception &e)
+    {
+        // keep the changes in memory and try again next time.
+
+        spdlog::error(std::format("Unable to store {} changed resident charts because: {}. Will retry.",
+                                  changed_charts.size(), e.what()));
+        unsaved_symbols_.merge(changed_symbols);
+        response["store_error"] = e.what();
+    }
+
+    response["symbols"] = Json::Int64{symbols_processed};
+    response["charts_scanned"] = Json::Int64{charts_processed};
+    response["charts_updated"] = Json::Int64{charts_updated};
+    response["charts_unsaved"] = static_cast<Json::UInt64>(unsaved_symbols_.size());
+    if (!not_resident.empty())
+    {
+        response["symbols_without_charts"] = not_resident;
+    }
+    return response;
+} // -----  end of method PF_CollectDataApp::ApplyPricesToResidentCharts  -----
+
+Json::Value PF_CollectDataApp::ServiceStartStreaming()
+{
+    Json::Value response;
+    if (new_data_source_ != Source::e_streaming)
+    {
+        response["status"] = "error";
+        response["message"] = "start the service with --new-data-source streaming to be able to stream";
+        return response;
+    }
+    if (service_streaming_)
+    {
+        response["status"] = "error";
+        response["message"] = "already streaming";
+        return response;
+    }
+    if (service_streaming_task_.valid())
+    {
+        service_streaming_task_.get();
+    }
+    service_streaming_ = true;
+    stop_streaming_requested_ = false;
+    service_streaming_task_ = std::async(std::launch::async, &PF_CollectDataApp::ServiceStreaming, this);
+    response["message"] = std::format("streaming {} symbols", symbol_list_.size());
+    return response;
+} // -----  end of method PF_CollectDataApp::ServiceStartStreaming  -----
+
+void PF_CollectDataApp::ServiceStreaming()
+{
+    // runs a normal streaming session, saves its charts as a streaming run's shutdown
+    // would and then clears everything out for the next session.
+
+    // the websocket streamer catches SIGINT and SIGTERM itself while it runs and
+    // leaves them at their defaults when it's done so we take them back right away.
+
+    try
+    {
+        Run_Streaming();
+        InstallSignalHandlers();
+
+        if (destination_ == Destination::e_file)
+        {
+            ShutdownAndStoreOutputInFiles();
+        }
+        else
+        {
+            ShutdownAndStoreOutputInDB();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        InstallSignalHandlers();
+        spdlog::error(std::format("Problem streaming from service: {}", e.what()));
+    }
+
+    charts_.clear();
+    streamed_prices_.clear();
+    streamed_summary_.clear();
+    streamed_prices_mtxs_.clear();
+
+    had_signal_ = false;
+    service_streaming_ = false;
+    spdlog::info("Service streaming session ended.");
+} // -----  end of method PF_CollectDataApp::ServiceStreaming  -----
+
 void PF_CollectDataApp::Shutdown()
 {
     // py::gil_scoped_acquire gil{};
 
-    if (destination_ == Destination::e_file)
+    PF_TRACE_SCOPE("phase", "Shutdown");
+
     {
-        ShutdownAndStoreOutputInFiles();
+        PF_RunStats::PhaseTimer timer{run_stats_.get(), PF_RunStats::Phase::e_write};
+
+        if (destination_ == Destination::e_file)
+        {
+            ShutdownAndStoreOutputInFiles();
+        }
+        else
+        {
+            ShutdownAndStoreOutputInDB();
+        }
     }
-    else
+
+    if (run_stats_)
     {
-        ShutdownAndStoreOutputInDB();
+        run_stats_->LogSummary();
     }
 
     spdlog::info(std::format("\n\n*** End run {}  ***\n",
@@ -1938,34 +3482,42 @@ void PF_CollectDataApp::Shutdown()
 
 void PF_CollectDataApp::ShutdownAndStoreOutputInFiles()
 {
-    for (const auto &[symbol, chart] : charts_)
-    {
+    // streaming is finished by now so workers can safely read streamed_prices_
+    // (but must not use operator[] on it).
+
+    const auto interval = new_data_source_ == Source::e_streaming ? std::string{} : interval_i_;
+    const auto x_axis_format = interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date;
+
+    auto output_chart = [this, &interval, x_axis_format](const PF_Chart &chart) {
+        PF_TRACE_SCOPE_ARG("symbol", "output_chart", chart.GetSymbol());
         try
         {
-            fs::path output_file_name =
-                output_chart_directory_ /
-                chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "json");
-            chart.ConvertChartToJsonAndWriteToFile(output_file_name);
+            fs::path output_file_name = output_chart_directory_ / chart.MakeChartFileName(interval, "json");
+            std::ostringstream chart_json;
+            {
+                PF_TRACE_SCOPE("json", "chart_to_json");
+                chart.ConvertChartToJsonAndWriteToStream(chart_json);
+            }
+            ReplaceFile(output_file_name, std::move(chart_json).str(), false);
 
             if (graphics_format_ == GraphicsFormat::e_svg)
             {
-                fs::path graph_file_path =
-                    output_graphs_directory_ /
-                    (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "svg"));
-                ConstructCDPFChartGraphicAndWriteToFile(
-                    chart, graph_file_path,
-                    (new_data_source_ == Source::e_streaming ? streamed_prices_[chart.GetSymbol()] : StreamedPrices{}),
-                    trend_lines_, interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date);
+                PF_TRACE_SCOPE("render", "chart_to_svg");
+                fs::path graph_file_path = output_graphs_directory_ / (chart.MakeChartFileName(interval, "svg"));
+                ReplaceFile(graph_file_path,
+                            ConstructCDPFChartGraphicAsSVG(chart, FindStreamedPrices(chart.GetSymbol()), trend_lines_,
+                                                           x_axis_format),
+                            false);
             }
             else
             {
-                fs::path graph_file_path =
-                    output_graphs_directory_ /
-                    (chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "csv"));
-                chart.ConvertChartToTableAndWriteToFile(graph_file_path, interval_ != Interval::e_eod
-                                                                             ? X_AxisFormat::e_show_time
-                                                                             : X_AxisFormat::e_show_date);
+                PF_TRACE_SCOPE("render", "chart_to_csv");
+                fs::path graph_file_path = output_graphs_directory_ / (chart.MakeChartFileName(interval, "csv"));
+                std::ostringstream chart_table;
+                chart.ConvertChartToTableAndWriteToStream(chart_table, x_axis_format);
+                ReplaceFile(graph_file_path, std::move(chart_table).str(), false);
             }
+            return true;
         }
         catch (const std::exception &e)
         {
@@ -1973,38 +3525,49 @@ void PF_CollectDataApp::ShutdownAndStoreOutputInFiles()
                 "Problem in shutdown: {} for chart: {}.\nTrying to "
                 "complete "
                 "shutdown.",
-                e.what(), chart.MakeChartFileName((new_data_source_ == Source::e_streaming ? "" : interval_i_), "")));
+                e.what(), chart.MakeChartFileName(interval, "")));
         }
-    }
+        return false;
+    };
+
+    const int32_t chart_count = OutputChartsInParallel(output_chart);
+    spdlog::info(std::format("Wrote {} charts to files.", chart_count));
 
     if (new_data_source_ == Source::e_streaming && graphics_format_ == GraphicsFormat::e_svg)
     {
-        fs::path summary_graphic_path = output_graphs_directory_ / "PF_StreamingSummary.svg";
-        ConstructCDSummaryGraphic(streamed_summary_, summary_graphic_path);
+        try
+        {
+            fs::path summary_graphic_path = output_graphs_directory_ / "PF_StreamingSummary.svg";
+            ReplaceFile(summary_graphic_path, ConstructCDSummaryGraphicAsSVG(streamed_summary_), false);
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Problem in shutdown: {} for streaming summary.", e.what()));
+        }
     }
 } // -----  end of method PF_CollectDataApp::ShutdownStoreOutputInFiles  -----
 
 void PF_CollectDataApp::ShutdownAndStoreOutputInDB()
 {
-    int32_t chart_count = 0;
-    PF_DB pf_db{db_params_};
-    for (const auto &[symbol, chart] : charts_)
-    {
+    const auto x_axis_format = interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date;
+
+    auto output_chart = [this, x_axis_format](const PF_Chart &chart) {
+        PF_TRACE_SCOPE_ARG("symbol", "output_chart", chart.GetSymbol());
         try
         {
             if (graphics_format_ == GraphicsFormat::e_svg)
             {
+                PF_TRACE_SCOPE("render", "chart_to_svg");
                 fs::path graph_file_path = output_graphs_directory_ / (chart.MakeChartFileName(interval_i_, "svg"));
-                ConstructCDPFChartGraphicAndWriteToFile(
-                    chart, graph_file_path,
-                    (new_data_source_ == Source::e_streaming ? streamed_prices_[chart.GetSymbol()] : StreamedPrices{}),
-                    trend_lines_, interval_ != Interval::e_eod ? X_AxisFormat::e_show_time : X_AxisFormat::e_show_date);
+                ReplaceFile(graph_file_path,
+                            ConstructCDPFChartGraphicAsSVG(chart, FindStreamedPrices(chart.GetSymbol()), trend_lines_,
+                                                           x_axis_format),
+                            false);
             }
-            chart.StoreChartInChartsDB(pf_db, interval_i_,
-                                       interval_ != Interval::e_eod ? X_AxisFormat::e_show_time
-                                                                    : X_AxisFormat::e_show_date,
-                                       graphics_format_ == GraphicsFormat::e_csv);
-            ++chart_count;
+            PF_TRACE_SCOPE("db", "store_chart");
+            PF_DB pf_db{db_params_};
+            chart.StoreChartInChartsDB(pf_db, interval_i_, x_axis_format, graphics_format_ == GraphicsFormat::e_csv);
+            return true;
         }
         catch (const std::exception &e)
         {
@@ -2012,11 +3575,61 @@ void PF_CollectDataApp::ShutdownAndStoreOutputInDB()
                                       "{}.\nTrying to complete shutdown.",
                                       e.what(), chart.MakeChartFileName(interval_i_, "")));
         }
-    }
+        return false;
+    };
+
+    const int32_t chart_count = OutputChartsInParallel(output_chart);
     spdlog::info(std::format("Stored {} charts in DB.", chart_count));
 
 } // -----  end of method PF_CollectDataApp::ShutdownStoreOutputInDB  -----
 
+int32_t PF_CollectDataApp::OutputChartsInParallel(const std::function<bool(const PF_Chart &)> &output_chart) const
+{
+    // each worker takes the next chart which hasn't been done yet so a few slow
+    // charts don't hold up the rest. ChartDirector objects are created inside each
+    // call so workers don't share any of them.
+
+    std::atomic<size_t> next_chart{0};
+    std::atomic<int32_t> charts_done{0};
+
+    auto output_worker = [this, &output_chart, &next_chart, &charts_done]() {
+        PF_TRACE_THREAD_NAME("output worker");
+        for (size_t which = next_chart++; which < charts_.size(); which = next_chart++)
+        {
+            if (output_chart(charts_[which].second))
+            {
+                ++charts_done;
+            }
+        }
+    };
+
+    const auto worker_count = std::min(charts_.size(), static_cast<size_t>(output_threads_));
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, output_worker));
+    }
+    for (auto &worker : workers)
+    {
+        worker.get();
+    }
+    return charts_done;
+} // -----  end of method PF_CollectDataApp::OutputChartsInParallel  -----
+
+const StreamedPrices &PF_CollectDataApp::FindStreamedPrices(const std::string &symbol) const
+{
+    static const StreamedPrices kNoStreamedPrices{};
+
+    if (new_data_source_ != Source::e_streaming)
+    {
+        return kNoStreamedPrices;
+    }
+    const auto found = streamed_prices_.find(symbol);
+    return found != streamed_prices_.end() ? found->second : kNoStreamedPrices;
+} // -----  end of method PF_CollectDataApp::FindStreamedPrices  -----
+
 void PF_CollectDataApp::WaitForTimer(const std::chrono::zoned_seconds &stop_at)
 {
     while (true)
@@ -2033,7 +3646,7 @@ void PF_CollectDataApp::WaitForTimer(const std::chrono::zoned_seconds &stop_at)
             std::chrono::current_zone(), floor<std::chrono::seconds>(std::chrono::system_clock::now()));
         if (now.get_sys_time() < stop_at.get_sys_time())
         {
-            std::this_thread::sleep_for(1min);
+            std::this_thread::sleep_for(1s);
         }
         else
         {
@@ -2050,5 +3663,12 @@ void PF_CollectDataApp::HandleSignal(int signal)
     // only thing we need to do
 
     PF_CollectDataApp::had_signal_ = true;
+    PF_CollectDataApp::stop_service_ = true;
 
 } /* -----  end of method PF_CollectDataApp::HandleSignal  ----- */
+
+void PF_CollectDataApp::InstallSignalHandlers()
+{
+    std::signal(SIGINT, &PF_CollectDataApp::HandleSignal);
+    std::signal(SIGTERM, &PF_CollectDataApp::HandleSignal);
+} // -----  end of method PF_CollectDataApp::InstallSignalHandlers  -----
@@ -34,11 +34,18 @@
 #ifndef PF_COLLECTDATAAPP_INC
 #define PF_COLLECTDATAAPP_INC
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <queue>
+#include <set>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -56,9 +63,17 @@ namespace po = boost::program_options;
 #include <spdlog/spdlog.h>
 
 #include "Boxes.h"
+#include "PF_Checkpoint.h"
 #include "PF_Chart.h"
+#include "PF_ChartQuery.h"
+#include "PF_FileSink.h"
+#include "PF_RunStats.h"
+#include "PF_SharedState.h"
+#include "PF_SignalBus.h"
+#include "PF_StreamingMetrics.h"
 #include "PointAndFigureDB.h"
 #include "Streamer.h"
+#include "UnixSocketServer.h"
 #include "utilities.h"
 
 // =====================================================================================
@@ -130,40 +145,65 @@ protected:
     void Run_UpdateFromDB();
     void Run_Streaming();
     std::tuple<int, int, int> Run_DailyScan();
+    void Run_Service();
 
     void Do_Quit();
 
     [[nodiscard]] static PF_Chart LoadAndParsePriceDataJSON(const fs::path &symbol_file_name);
-    void AddPriceDataToExistingChartCSV(PF_Chart &new_chart, const fs::path &update_file_name) const;
+    [[nodiscard]] std::vector<DateCloseRecord> LoadPriceDataFromCSV(const fs::path &price_file_name) const;
     [[nodiscard]] static std::optional<int> FindColumnIndex(std::string_view header, std::string_view column_name,
                                                             std::string_view delim);
 
     void PrimeChartsForStreaming();
+    [[nodiscard]] bool RestoreFromCheckpoint();
     void CollectStreamingData();
 
     [[nodiscard]] decimal::Decimal ComputeATRForChart(const std::string &symbol) const;
+    [[nodiscard]] std::map<std::string, decimal::Decimal> ComputeATRForCharts(
+        const std::vector<std::string> &symbols) const;
+    [[nodiscard]] RemoteDataSource &QuoteSource() const;
     [[nodiscard]] decimal::Decimal ComputeATRForChartFromDB(const std::string &symbol) const;
 
     void ShutdownAndStoreOutputInFiles();
     void ShutdownAndStoreOutputInDB();
+    int32_t OutputChartsInParallel(const std::function<bool(const PF_Chart &)> &output_chart) const;
+    [[nodiscard]] const StreamedPrices &FindStreamedPrices(const std::string &symbol) const;
 
     // ====================  DATA MEMBERS
     // =======================================
 
 private:
     static void HandleSignal(int signal);
+    static void InstallSignalHandlers();
 
     void CollectStreamedData(const RemoteDataSource::PF_Data &update, PF_SignalType new_signal);
-    void StreamedDataParser(RemoteDataSource::StreamerContext &streamer_context,
+    void StreamedDataParser(int32_t connection, RemoteDataSource::StreamerContext &streamer_context,
                             std::vector<RemoteDataSource::ProcessorContext> &processor_contexts,
                             std::map<std::string, int> &symbol_to_context_map);
     void ProcessUpdatesForSymbol(RemoteDataSource::ProcessorContext &processor_context);
     void Do_ProcessUpdatesForSymbol(const RemoteDataSource::PF_Data &update);
+    [[nodiscard]] bool CanConflateTicksFor(const std::string &symbol) const;
+    void RenderStreamedCharts();
+    void PersistStreamedCharts();
+    void CheckpointStreamingSession();
     std::tuple<int, int, int> ProcessSymbolsFromDB(const std::vector<std::string> &symbol_list);
+    [[nodiscard]] PF_Charts LoadChartsForSymbolFromFile(const std::string &symbol) const;
+    [[nodiscard]] PF_Charts UpdateChartsForSymbolFromFile(const std::string &symbol) const;
+    void ProcessSymbolsInParallel(PF_Charts (PF_CollectDataApp::*process_symbol)(const std::string &) const);
     [[nodiscard]] std::pair<int, int> CountChartReversalsUpAndDown() const;
     [[nodiscard]] std::pair<int, int> CountChartTrendsContinueUpAndDown() const;
     [[nodiscard]] std::pair<int, int> CountChartTrendsUnanimousUpAndDown() const;
 
+    void LoadResidentCharts();
+    void HandleServiceRequest(std::string_view request, UnixSocketServer::Reply reply);
+    [[nodiscard]] std::string DoServiceCommand(const std::string &request);
+    Json::Value ServiceDailyScan(const std::vector<std::string> &args);
+    Json::Value ServiceUpdateSymbols(const std::vector<std::string> &args);
+    Json::Value ServiceStartStreaming();
+    void ServiceStreaming();
+    Json::Value ApplyPricesToResidentCharts(const std::vector<MultiSymbolDateCloseRecord> &db_data,
+                                            const std::string &end_date, PF_RunStats &stats);
+
     // ====================  DATA MEMBERS
     // =======================================
 
@@ -172,11 +212,108 @@ private:
     PF_StreamedPrices streamed_prices_;
     PF_StreamedSummary streamed_summary_;
 
+    // while streaming, each symbol's processor thread updates its own streamed prices.
+    // The render thread needs to copy them so we need a lock for each symbol.
+    // The summary is shared by everyone.
+
+    std::map<std::string, std::mutex> streamed_prices_mtxs_;
+    std::mutex streamed_summary_mtx_;
+
     PF_Charts charts_;
 
+    // processor threads publish a snapshot of each chart they change. The render
+    // thread draws whatever is newest for each chart, no more often than
+    // minimum_delay_. Older snapshots which were never drawn are just replaced.
+    // The DB persister works the same way on its own schedule.
+    // Each snapshot keeps when its oldest not yet handled tick arrived.
+
+    struct ChartSnapshot
+    {
+        std::shared_ptr<const PF_Chart> chart_;
+        std::chrono::steady_clock::time_point received_at_;
+    };
+
+    struct ChartSnapshotContext
+    {
+        std::condition_variable cv_;
+        std::mutex mtx_;
+        std::map<std::string, ChartSnapshot> dirty_charts_;
+        std::set<std::string> dirty_symbols_; // streamed prices changed. Only checkpoints need this.
+        bool summary_dirty_ = false;
+        bool done_ = false;
+    };
+
+    ChartSnapshotContext render_context_;
+    ChartSnapshotContext persist_context_;
+    ChartSnapshotContext checkpoint_context_;
+
+    // lets a restart during the session pick up where we left off.
+
+    std::unique_ptr<PF_Checkpoint> checkpoint_;
+
+    // while streaming, chart and graphic files go through here so they are replaced
+    // atomically and written in the background.
+
+    std::unique_ptr<PF_FileSink> file_sink_;
+
+    // where the time goes while streaming.
+
+    std::unique_ptr<PF_StreamingMetrics> streaming_metrics_;
+
+    // newest copy of each streamed chart for anyone asking over the query socket.
+
+    std::unique_ptr<PF_ChartQuery> chart_query_;
+
+    // live chart state for other processes on this machine.
+
+    std::unique_ptr<PF_SharedStateWriter> shared_state_;
+
+    // new signals for subscribers as soon as they are found.
+
+    std::unique_ptr<PF_SignalBus> signal_bus_;
+
+    // where the time goes in a database load or daily scan. Logged at shutdown.
+
+    std::unique_ptr<PF_RunStats> run_stats_;
+
+    // one for the whole run so all our quote requests share its connections.
+
+    mutable std::once_flag quote_source_once_;
+    mutable std::unique_ptr<RemoteDataSource> quote_source_;
+
+    // service mode keeps every EOD chart loaded between commands. Commands which
+    // change them run one at a time on the service thread and only that thread
+    // touches the resident charts. Charts whose changes couldn't be stored are
+    // tried again with the next change.
+
+    struct ServiceCommand
+    {
+        std::string request_;
+        UnixSocketServer::Reply reply_;
+    };
+
+    struct ServiceContext
+    {
+        std::condition_variable cv_;
+        std::mutex mtx_;
+        std::queue<ServiceCommand> commands_;
+        bool done_ = false;
+    };
+
+    ServiceContext service_context_;
+    std::map<std::string, std::vector<PF_Chart>, std::less<>> resident_charts_;
+    std::set<std::string, std::less<>> unsaved_symbols_;
+    std::future<void> service_streaming_task_;
+    std::atomic<int64_t> resident_symbol_count_ = 0;
+    std::atomic<int64_t> resident_chart_count_ = 0;
+    std::atomic<bool> service_busy_ = false;
+    std::atomic<bool> service_streaming_ = false;
+
+    // 'stream-stop' and service shutdown. Unlike had_signal_, streaming never clears
+    // this so a request made while a session is still starting isn't lost.
+    std::atomic<bool> stop_streaming_requested_ = false;
+
     // don't draw updated charts too frequently
-    std::chrono::time_point<std::chrono::system_clock> last_summary_draw_time_;
-    std::map<std::string, std::chrono::time_point<std::chrono::system_clock>> last_draw_times_;
     const std::chrono::seconds minimum_delay_ = 2s;
 
     po::positional_options_description positional_;       //	old style
@@ -186,9 +323,10 @@ private:
 
     // make this a class member because we need to access it
     // from an async task and this avoids passing an extra argument down
-    // the calling chain. Alos, there will only be 1 of these per run.
+    // the calling chain. Alos, there will only be 1 set of these per run.
+    // 1 streamer per websocket connection. Each has its own share of the symbols.
 
-    std::unique_ptr<RemoteDataSource> PF_streamer_;
+    std::vector<std::unique_ptr<RemoteDataSource>> PF_streamers_;
 
     int argc_ = 0;
     char **argv_ = nullptr;
@@ -200,7 +338,16 @@ private:
     fs::path new_data_input_directory_;
     fs::path output_chart_directory_;
     fs::path output_graphs_directory_;
+    fs::path price_cache_directory_;
+    fs::path capture_stream_file_;
+    fs::path replay_stream_file_;
     fs::path PF_CollectDataConfigDir_;
+    fs::path service_socket_path_;
+    fs::path query_socket_path_;
+    fs::path checkpoint_file_;
+    fs::path history_cache_directory_;
+    fs::path signal_journal_path_;
+    std::vector<fs::path> signal_socket_paths_;
 
     std::string streaming_host_name_;
     fs::path streaming_host_api_key_;
@@ -234,7 +381,8 @@ private:
         e_unknown,
         e_load,
         e_update,
-        e_daily_scan
+        e_daily_scan,
+        e_service
     };
     enum class Source : int32_t
     {
@@ -317,10 +465,23 @@ private:
     std::string begin_date_;
     std::string end_date_;
     std::string min_dollar_volume_;
+    std::string shm_name_;
 
     int64_t min_close_volume_ = 100'000;
 
+    double replay_speed_ = 1.0;
+
     int32_t thread_pool_threads_ = 8;
+    int32_t output_threads_ = 8;
+    int32_t live_db_interval_ = 0;
+    int32_t checkpoint_interval_ = 15;
+    int32_t conflate_above_ = 0;
+    int32_t streaming_connections_ = 1;
+    int32_t quote_connections_ = 4;
+    int32_t quote_requests_per_second_ = 0;
+    int32_t history_cache_ttl_ = 900;
+    int32_t metrics_interval_ = 60;
+    int32_t metrics_port_ = 0;
     int32_t max_columns_for_graph_ = -1;
     int32_t number_of_days_history_for_ATR_ = 0;
     bool input_is_path_ = false;
@@ -328,7 +489,8 @@ private:
     bool use_ATR_ = false;
     bool use_min_max_ = false;
 
-    static bool had_signal_;
+    static std::atomic<bool> had_signal_;
+    static std::atomic<bool> stop_service_;
 }; // -----  end of class PF_CollectDataApp  -----
 
 #endif // ----- #ifndef PF_COLLECTDATAAPP_INC  -----
@@ -0,0 +1,94 @@
+// =====================================================================================
+//
+//       Filename:  PF_Conflation.h
+//
+//    Description:  fold a backlog of ticks down to the ones which can change a
+//    Point & Figure chart.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 11:55 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _PF_CONFLATION_INC_
+#define _PF_CONFLATION_INC_
+
+#include <vector>
+
+// =====================================================================================
+//  ConflateTicks: keeps the first and last ticks and every tick where the price
+//  turns around, in their original order. Ticks part way through a run up or down
+//  are dropped. If the price turns no more than twice in the backlog, that is at
+//  most first, high, low and last.
+//
+//  A column only grows to the extreme of a run and a reversal column is filled
+//  out to the value which started it, so for reversal > 1 a chart fed the
+//  conflated ticks has exactly the same columns as one fed all of them. There
+//  are 2 exceptions so don't conflate for charts like these:
+//
+//  - 1-box reversal: a single box column reverses in place by just 1 box however
+//    far the price moved, so skipping ticks there can lose boxes.
+//  - a chart whose first column has no direction yet: finding the direction
+//    rounds down to a box but extending down rounds up, so where that column
+//    ends up depends on which ticks it saw.
+//
+//  Keeping only first/max/min/last would not be enough: a backlog with several
+//  swings in it can have several reversals.
+//
+//  What does change: a signal found part way through a run is found at the end
+//  of it instead and column times are those of the ticks we kept.
+// =====================================================================================
+
+template <typename Tick, typename PriceFn>
+std::vector<Tick> ConflateTicks(std::vector<Tick> ticks, PriceFn price)
+{
+    std::vector<Tick> kept;
+    kept.reserve(ticks.size());
+    for (auto &tick : ticks)
+    {
+        if (kept.size() < 2)
+        {
+            kept.push_back(std::move(tick));
+            continue;
+        }
+
+        // if the last tick we kept is between the one before it and this one, it was
+        // not a turning point after all.
+
+        const auto &before = price(kept[kept.size() - 2]);
+        const auto &last = price(kept.back());
+        const auto &next = price(tick);
+        if ((before <= last && last <= next) || (before >= last && last >= next))
+        {
+            kept.back() = std::move(tick);
+        }
+        else
+        {
+            kept.push_back(std::move(tick));
+        }
+    }
+    return kept;
+}
+
+#endif // ----- #ifndef _PF_CONFLATION_INC_  -----
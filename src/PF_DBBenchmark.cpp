@@ -0,0 +1,373 @@
+// =====================================================================================
+//
+//       Filename:  PF_DBBenchmark.cpp
+//
+//    Description:  Run PF_CollectData's database modes against a database
+//    (usually one filled by PF_GenerateStockDB) and report throughput and
+//    where the time went.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 04:40 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+// Each mode runs PF_CollectData as a child process so its numbers are its own:
+//
+//      load        --mode load --new-data-source database --symbol-list ALL over all the data
+//      update      --mode update --new-data-source database for 'update-symbols' symbols over the
+//                  last 'recent-days' days
+//      daily-scan  --mode daily-scan over the last 'recent-days' days
+//
+// update and daily-scan work on the charts load stores so run load first.
+//
+// For each mode we report:
+//
+//      wall        elapsed time
+//      cpu         user + system time of PF_CollectData (from wait4)
+//      off-cpu     wall - cpu. Mostly time spent waiting on the database.
+//      db active   time Postgres spent running statements (pg_stat_database.active_time)
+//      rows        price rows the mode reads, counted up front, and rows/sec
+//      charts      rows inserted or updated in <db-mode>_point_and_figure.pf_charts and charts/sec.
+//                  For daily-scan this includes the 'last checked' date update for every chart.
+//      sessions    new database connections (pg_stat_database.sessions). May include 1 of our own.
+//
+// active_time and sessions need Postgres 14 or later.
+//
+// PF_CollectData's own output goes to 'child-log'.
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <pqxx/pqxx>
+
+extern char **environ;
+
+namespace po = boost::program_options;
+namespace rng = std::ranges;
+namespace vws = std::ranges::views;
+
+namespace
+{
+struct BenchmarkOptions
+{
+    std::string collector_ = "./PF_CollectData";
+    std::string db_name_;
+    std::string db_user_;
+    std::string db_mode_ = "test";
+    std::string data_table_ = "new_stock_data.current_data";
+    std::string modes_ = "load,update,daily-scan";
+    std::string box_size_ = "0.01";
+    std::string reversal_ = "3";
+    std::string scale_ = "percent";
+    std::string min_dollar_volume_ = "100000";
+    std::string extra_args_;
+    std::string child_log_ = "PF_DBBenchmark.log";
+    int32_t update_symbols_ = 100;
+    int32_t recent_days_ = 5;
+};
+
+struct DBStats
+{
+    int64_t sessions_ = 0;
+    double active_ms_ = 0.0;
+    int64_t chart_rows_written_ = 0;
+};
+
+struct ChildResult
+{
+    int exit_status_ = -1;
+    double cpu_secs_ = 0.0;
+};
+
+std::vector<std::string> SplitOn(std::string_view text, char delim)
+{
+    std::vector<std::string> pieces;
+    for (const auto piece : text | vws::split(delim))
+    {
+        if (!piece.empty())
+        {
+            pieces.emplace_back(piece.begin(), piece.end());
+        }
+    }
+    return pieces;
+}
+
+// a new connection each time so we see the current stats, not a cached snapshot.
+
+DBStats ReadDBStats(const BenchmarkOptions &options)
+{
+    pqxx::connection c{std::format("dbname={} user={}", options.db_name_, options.db_user_)};
+    pqxx::work trxn{c};
+
+    const auto row = trxn.exec1(std::format(
+        "SELECT sessions, active_time, (SELECT COALESCE(SUM(n_tup_ins + n_tup_upd), 0) FROM pg_stat_user_tables "
+        "WHERE schemaname = {} AND relname = 'pf_charts') FROM pg_stat_database WHERE datname = current_database()",
+        trxn.quote(options.db_mode_ + "_point_and_figure")));
+
+    return {.sessions_ = row[0].as<int64_t>(),
+            .active_ms_ = row[1].as<double>(),
+            .chart_rows_written_ = row[2].as<int64_t>()};
+}
+
+template <typename T>
+T QueryValue(const BenchmarkOptions &options, const std::string &query)
+{
+    pqxx::connection c{std::format("dbname={} user={}", options.db_name_, options.db_user_)};
+    pqxx::work trxn{c};
+    return trxn.query_value<T>(query);
+}
+
+std::vector<std::string> QuerySymbols(const BenchmarkOptions &options, int32_t how_many)
+{
+    pqxx::connection c{std::format("dbname={} user={}", options.db_name_, options.db_user_)};
+    pqxx::work trxn{c};
+
+    std::vector<std::string> symbols;
+    for (const auto &[symbol] : trxn.query<std::string>(
+             std::format("SELECT symbol FROM new_stock_data.names_and_symbols ORDER BY symbol LIMIT {}", how_many)))
+    {
+        symbols.push_back(symbol);
+    }
+    return symbols;
+}
+
+ChildResult RunCollector(const BenchmarkOptions &options, const std::vector<std::string> &args)
+{
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(options.collector_.c_str()));
+    rng::for_each(args, [&argv](const auto &arg) { argv.push_back(const_cast<char *>(arg.c_str())); });
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, options.child_log_.c_str(),
+                                     O_WRONLY | O_CREAT | O_APPEND, 0644);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+    pid_t pid = 0;
+    const auto spawn_result = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (spawn_result != 0)
+    {
+        throw std::system_error(spawn_result, std::generic_category(),
+                                std::format("Unable to run: {}", options.collector_));
+    }
+
+    int status = 0;
+    rusage usage{};
+    if (wait4(pid, &status, 0, &usage) < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "wait4 failed");
+    }
+
+    auto to_secs = [](const timeval &tv) { return static_cast<double>(tv.tv_sec) + tv.tv_usec / 1'000'000.0; };
+    return {.exit_status_ = WIFEXITED(status) ? WEXITSTATUS(status) : -1,
+            .cpu_secs_ = to_secs(usage.ru_utime) + to_secs(usage.ru_stime)};
+}
+
+void RunMode(const BenchmarkOptions &options, std::string_view mode, const std::vector<std::string> &args,
+             int64_t rows_to_read)
+{
+    const auto before = ReadDBStats(options);
+    const auto started_at = std::chrono::steady_clock::now();
+
+    const auto result = RunCollector(options, args);
+
+    const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - started_at;
+    const auto after = ReadDBStats(options);
+
+    const double wall_secs = wall.count();
+    const auto charts = after.chart_rows_written_ - before.chart_rows_written_;
+
+    std::cout << std::format(
+        "{:<10}  wall: {:7.2f}s  cpu: {:7.2f}s ({:3.0f}%)  off-cpu: {:7.2f}s  db active: {:7.2f}s  "
+        "rows: {} ({:.0f}/s)  charts: {} ({:.1f}/s)  sessions: {}  exit: {}\n",
+        mode, wall_secs, result.cpu_secs_, 100.0 * result.cpu_secs_ / wall_secs,
+        std::max(0.0, wall_secs - result.cpu_secs_), (after.active_ms_ - before.active_ms_) / 1000.0, rows_to_read,
+        rows_to_read / wall_secs, charts, charts / wall_secs, after.sessions_ - before.sessions_, result.exit_status_);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+
+    // clang-format off
+    po::options_description desc{"PF_DBBenchmark options"};
+    desc.add_options()
+        ("help,h",                  "produce help message")
+        ("collector",               po::value<std::string>(&options.collector_)->default_value("./PF_CollectData"), "PF_CollectData program to run. Default is './PF_CollectData'.")
+        ("db-name",                 po::value<std::string>(&options.db_name_)->required(), "name of database to use.")
+        ("db-user",                 po::value<std::string>(&options.db_user_)->required(), "database user name.")
+        ("db-mode",                 po::value<std::string>(&options.db_mode_)->default_value("test"), "'test' or 'live' charts schema to use. Default is 'test'.")
+        ("stock-db-data-source",    po::value<std::string>(&options.data_table_)->default_value("new_stock_data.current_data"), "table containing price data. Default is 'new_stock_data.current_data'.")
+        ("modes",                   po::value<std::string>(&options.modes_)->default_value("load,update,daily-scan"), "comma-delimited list of modes to run, in order. Default is 'load,update,daily-scan'.")
+        ("boxsize",                 po::value<std::string>(&options.box_size_)->default_value("0.01"), "box size for charts. Default is 0.01.")
+        ("reversal",                po::value<std::string>(&options.reversal_)->default_value("3"), "reversal boxes for charts. Default is 3.")
+        ("scale",                   po::value<std::string>(&options.scale_)->default_value("percent"), "'linear' or 'percent'. Default is 'percent'.")
+        ("min-dollar-volume",       po::value<std::string>(&options.min_dollar_volume_)->default_value("100000"), "passed to PF_CollectData. Default is 100000.")
+        ("update-symbols",          po::value<int32_t>(&options.update_symbols_)->default_value(100), "number of symbols for 'update' mode. Default is 100.")
+        ("recent-days",             po::value<int32_t>(&options.recent_days_)->default_value(5), "trading days of data for 'update' and 'daily-scan'. Default is 5.")
+        ("extra-args",              po::value<std::string>(&options.extra_args_), "space-delimited arguments added to every PF_CollectData run (e.g. '--threads 16').")
+        ("child-log",               po::value<std::string>(&options.child_log_)->default_value("PF_DBBenchmark.log"), "file for PF_CollectData output. Default is 'PF_DBBenchmark.log'.")
+        ;
+    // clang-format on
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.contains("help"))
+        {
+            std::cout << desc << '\n';
+            return 0;
+        }
+        po::notify(vm);
+
+        if (options.update_symbols_ < 1 || options.recent_days_ < 1)
+        {
+            std::cerr << "update-symbols and recent-days must be > 0.\n";
+            return 1;
+        }
+
+        const auto modes = SplitOn(options.modes_, ',');
+        for (const auto &mode : modes)
+        {
+            if (mode != "load" && mode != "update" && mode != "daily-scan")
+            {
+                std::cerr << std::format("Unknown mode: {}. Must be 'load', 'update' or 'daily-scan'.\n", mode);
+                return 1;
+            }
+        }
+
+        // work out the dates and symbols from what is in the database.
+
+        const auto first_date =
+            QueryValue<std::string>(options, std::format("SELECT MIN(date)::TEXT FROM {}", options.data_table_));
+        const auto last_date =
+            QueryValue<std::string>(options, std::format("SELECT MAX(date)::TEXT FROM {}", options.data_table_));
+        const auto recent_date = QueryValue<std::string>(
+            options, std::format("SELECT MIN(date)::TEXT FROM (SELECT DISTINCT date FROM {} ORDER BY date DESC "
+                                 "LIMIT {}) AS d",
+                                 options.data_table_, options.recent_days_));
+
+        const std::vector<std::string> common_args{"--db-name",
+                                                   options.db_name_,
+                                                   "--db-user",
+                                                   options.db_user_,
+                                                   "--db-mode",
+                                                   options.db_mode_,
+                                                   "--stock-db-data-source",
+                                                   options.data_table_,
+                                                   "--end-date",
+                                                   last_date,
+                                                   "--min-dollar-volume",
+                                                   options.min_dollar_volume_};
+        const std::vector<std::string> chart_args{"--boxsize",         options.box_size_, "--reversal",
+                                                  options.reversal_,   "--scale",         options.scale_,
+                                                  "--graphics-format", "csv",             "--destination",
+                                                  "database"};
+        const auto extra_args = SplitOn(options.extra_args_, ' ');
+
+        // the same symbols PF_CollectData will pick with 'ALL' or a daily scan.
+
+        const auto symbols_on_exchanges = std::format(
+            "SELECT new_stock_data.find_symbols_gte_min_dollar_volume(exchange, '{}') FROM (SELECT DISTINCT exchange "
+            "FROM new_stock_data.names_and_symbols WHERE exchange NOT IN ('NMFQS', 'INDX', 'US')) AS x",
+            options.min_dollar_volume_);
+
+        std::cout << std::format("Data: {} to {}. Recent days start: {}. Output from {} goes to: {}.\n", first_date,
+                                 last_date, recent_date, options.collector_, options.child_log_);
+
+        for (const auto &mode : modes)
+        {
+            std::vector<std::string> args{"--mode", mode, "--begin-date", mode == "load" ? first_date : recent_date};
+            args.append_range(common_args);
+            int64_t rows_to_read = 0;
+
+            if (mode == "load")
+            {
+                args.append_range(std::vector<std::string>{"--new-data-source", "database", "--symbol-list", "ALL"});
+                args.append_range(chart_args);
+                rows_to_read = QueryValue<int64_t>(
+                    options, std::format("SELECT COUNT(*) FROM {} WHERE date >= '{}' AND symbol IN ({})",
+                                         options.data_table_, first_date, symbols_on_exchanges));
+            }
+            else if (mode == "update")
+            {
+                const auto symbols = QuerySymbols(options, options.update_symbols_);
+                std::string symbol_list;
+                for (const auto &symbol : symbols)
+                {
+                    symbol_list += symbol_list.empty() ? symbol : "," + symbol;
+                }
+                std::string quoted_list;
+                for (const auto &symbol : symbols)
+                {
+                    quoted_list += std::format("{}'{}'", quoted_list.empty() ? "" : ", ", symbol);
+                }
+                args.append_range(std::vector<std::string>{"--new-data-source", "database", "--chart-data-source",
+                                                           "database", "--symbol-list", symbol_list});
+                args.append_range(chart_args);
+                rows_to_read = QueryValue<int64_t>(
+                    options, std::format("SELECT COUNT(*) FROM {} WHERE date BETWEEN '{}' AND '{}' AND symbol IN ({})",
+                                         options.data_table_, recent_date, last_date, quoted_list));
+            }
+            else
+            {
+                rows_to_read = QueryValue<int64_t>(
+                    options, std::format("SELECT COUNT(*) FROM {} WHERE date BETWEEN '{}' AND '{}' AND symbol IN ({})",
+                                         options.data_table_, recent_date, last_date, symbols_on_exchanges));
+            }
+            args.append_range(extra_args);
+
+            RunMode(options, mode, args, rows_to_read);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "PF_DBBenchmark: " << e.what() << '\n';
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,229 @@
+// =====================================================================================
+//
+//       Filename:  PF_FileSink.cpp
+//
+//    Description:  Write-behind output for chart, graphic and table files.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 02:20 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <system_error>
+
+#include <spdlog/spdlog.h>
+
+#include "PF_FileSink.h"
+#include "PF_StreamingMetrics.h"
+#include "PF_Trace.h"
+
+namespace
+{
+void WriteAll(int fd, const std::string &contents, const fs::path &file_name)
+{
+    const char *next = contents.data();
+    size_t remaining = contents.size();
+    while (remaining > 0)
+    {
+        const ssize_t written = ::write(fd, next, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "Unable to write file: " + file_name.string());
+        }
+        next += written;
+        remaining -= static_cast<size_t>(written);
+    }
+}
+} // namespace
+
+// write to '<name>.tmp' then rename over the real file. Rename within a directory is atomic.
+
+void ReplaceFile(const fs::path &file_name, const std::string &contents, bool durable)
+{
+    fs::path temp_name{file_name};
+    temp_name += ".tmp";
+
+    const int fd = ::open(temp_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "Unable to open file: " + temp_name.string());
+    }
+    try
+    {
+        WriteAll(fd, contents, temp_name);
+        if (durable && ::fsync(fd) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Unable to sync file: " + temp_name.string());
+        }
+    }
+    catch (...)
+    {
+        ::close(fd);
+        ::unlink(temp_name.c_str());
+        throw;
+    }
+    ::close(fd);
+
+    if (::rename(temp_name.c_str(), file_name.c_str()) != 0)
+    {
+        const int save_errno = errno;
+        ::unlink(temp_name.c_str());
+        throw std::system_error(save_errno, std::generic_category(), "Unable to rename file: " + temp_name.string());
+    }
+}
+
+// the rename itself is only durable once the directory is synced.
+
+void SyncDirectory(const fs::path &directory)
+{
+    const int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "Unable to open directory: " + directory.string());
+    }
+    const int result = ::fsync(fd);
+    const int save_errno = errno;
+    ::close(fd);
+    if (result != 0)
+    {
+        throw std::system_error(save_errno, std::generic_category(), "Unable to sync directory: " + directory.string());
+    }
+}
+
+PF_FileSink::PF_FileSink(std::chrono::milliseconds flush_interval) : flush_interval_{flush_interval}
+{
+    flusher_ = std::thread{&PF_FileSink::FlushTask, this};
+} // -----  end of method PF_FileSink::PF_FileSink  (constructor)  -----
+
+PF_FileSink::~PF_FileSink()
+{
+    try
+    {
+        Close();
+    }
+    catch (std::exception &e)
+    {
+        spdlog::error(std::format("Problem closing file sink: {}", e.what()));
+    }
+} // -----  end of method PF_FileSink::~PF_FileSink  (destructor)  -----
+
+void PF_FileSink::Write(const fs::path &file_name, std::string contents,
+                        std::chrono::steady_clock::time_point received_at)
+{
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (closed_)
+    {
+        // too late to queue it so write it now.
+
+        ReplaceFile(file_name, contents, false);
+        return;
+    }
+    auto [pending, inserted] =
+        pending_files_.try_emplace(file_name, PendingFile{.contents_ = {}, .received_at_ = received_at});
+    pending->second.contents_ = std::move(contents);
+    if (!inserted && pending->second.received_at_ == std::chrono::steady_clock::time_point{})
+    {
+        pending->second.received_at_ = received_at;
+    }
+} // -----  end of method PF_FileSink::Write  -----
+
+void PF_FileSink::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (closed_)
+        {
+            return;
+        }
+        done_ = true;
+    }
+    cv_.notify_one();
+    flusher_.join();
+
+    // the flusher has stopped so we do the last flush here.
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::map<fs::path, PendingFile> files;
+    files.swap(pending_files_);
+    WriteFiles(files);
+    closed_ = true;
+} // -----  end of method PF_FileSink::Close  -----
+
+void PF_FileSink::FlushTask()
+{
+    PF_TRACE_THREAD_NAME("file sink");
+
+    while (true)
+    {
+        std::map<fs::path, PendingFile> files;
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_.wait_for(lock, flush_interval_, [this] { return done_; });
+            if (done_)
+            {
+                break;
+            }
+            files.swap(pending_files_);
+        }
+        WriteFiles(files);
+    }
+} // -----  end of method PF_FileSink::FlushTask  -----
+
+void PF_FileSink::WriteFiles(const std::map<fs::path, PendingFile> &files)
+{
+    PF_TRACE_SCOPE("write", "write_files");
+
+    for (const auto &[file_name, pending] : files)
+    {
+        try
+        {
+            PF_TRACE_SCOPE_ARG("write", "replace_file", file_name.filename().string());
+            const auto started_at = std::chrono::steady_clock::now();
+            ReplaceFile(file_name, pending.contents_, false);
+            ++files_written_;
+            if (metrics_ != nullptr)
+            {
+                metrics_->RecordSince(PF_StreamingMetrics::Stage::e_file_write, started_at);
+                if (pending.received_at_ != std::chrono::steady_clock::time_point{})
+                {
+                    metrics_->RecordSince(PF_StreamingMetrics::Stage::e_tick_to_disk, pending.received_at_);
+                }
+            }
+        }
+        catch (std::exception &e)
+        {
+            spdlog::error(std::format("Problem writing output file: {}", e.what()));
+        }
+    }
+} // -----  end of method PF_FileSink::WriteFiles  -----
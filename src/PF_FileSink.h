@@ -0,0 +1,140 @@
+// =====================================================================================
+//
+//       Filename:  PF_FileSink.h
+//
+//    Description:  Write-behind output for chart, graphic and table files.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 02:20 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _PF_FILESINK_INC_
+#define _PF_FILESINK_INC_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+class PF_StreamingMetrics;
+
+// replace file_name's contents so anyone opening it sees either the old or the new
+// file, never a mix. If durable, the new contents are synced before the rename.
+
+void ReplaceFile(const fs::path &file_name, const std::string &contents, bool durable);
+
+// makes renames within directory durable.
+
+void SyncDirectory(const fs::path &directory);
+
+// =====================================================================================
+//        Class:  PF_FileSink
+//  Description:  keeps only the latest contents for each output file and writes
+//  them from a background thread every flush interval. Each file is written to a
+//  temporary file in the same directory and then renamed so readers never see a
+//  partial file.
+//
+//  Close() writes whatever is left. Nothing is synced: all of this output is
+//  rebuilt from the charts. Checkpoints, which a restart needs, sync themselves.
+//
+//  If given metrics, each file write is timed and files written with the time
+//  their data was received also record how long it took to get to disk.
+// =====================================================================================
+
+class PF_FileSink
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    explicit PF_FileSink(std::chrono::milliseconds flush_interval);
+
+    PF_FileSink(const PF_FileSink &rhs) = delete;
+    PF_FileSink(PF_FileSink &&rhs) = delete;
+
+    ~PF_FileSink();
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] int64_t FilesWritten() const
+    {
+        return files_written_;
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    // replaces anything not yet written for the same file. If the replaced contents
+    // had a received time, that older time is kept.
+
+    void Write(const fs::path &file_name, std::string contents,
+               std::chrono::steady_clock::time_point received_at = {});
+
+    void UseMetrics(PF_StreamingMetrics *metrics)
+    {
+        metrics_ = metrics;
+    }
+
+    void Close();
+
+    // ====================  OPERATORS     =======================================
+
+    PF_FileSink &operator=(const PF_FileSink &rhs) = delete;
+    PF_FileSink &operator=(PF_FileSink &&rhs) = delete;
+
+private:
+    struct PendingFile
+    {
+        std::string contents_;
+        std::chrono::steady_clock::time_point received_at_;
+    };
+
+    void FlushTask();
+    void WriteFiles(const std::map<fs::path, PendingFile> &files);
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::map<fs::path, PendingFile> pending_files_;
+
+    std::condition_variable cv_;
+    std::mutex mtx_;
+    std::thread flusher_;
+
+    std::chrono::milliseconds flush_interval_;
+
+    PF_StreamingMetrics *metrics_ = nullptr;
+
+    std::atomic<int64_t> files_written_ = 0;
+    bool done_ = false;
+    bool closed_ = false;
+
+}; // -----  end of class PF_FileSink  -----
+
+#endif // ----- #ifndef _PF_FILESINK_INC_  -----
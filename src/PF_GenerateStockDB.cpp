@@ -0,0 +1,419 @@
+// =====================================================================================
+//
+//       Filename:  PF_GenerateStockDB.cpp
+//
+//    Description:  Fill a local Postgres database with made up EOD stock
+//    prices so the database modes of PF_CollectData can be benchmarked
+//    without production data.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 04:40 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+// Creates N exchanges x M symbols x D trading days of OHLCV data in the same
+// layout PF_CollectData reads:
+//
+//      new_stock_data.names_and_symbols            exchange, symbol, name
+//      <stock-db-data-source>                      symbol, date, open..close, adj_*, split_adj_*,
+//                                                  volume, dollar_volume
+//      new_stock_data.find_symbols_gte_min_dollar_volume(exchange, min_dollar_volume)
+//
+// Closing prices follow a geometric Brownian motion with per symbol drift and
+// volatility. Open, high and low are scattered around the close and volume is
+// log-normal so the min-dollar-volume filter drops a realistic share of symbols.
+// A few symbols split so raw and split adjusted prices differ.
+//
+// The same seed always makes the same database.
+//
+// Point this at a scratch database. It refuses to add to a data table which
+// already has rows unless '--replace' is given, which drops and rebuilds it.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <pqxx/pqxx>
+#include <pqxx/stream_to>
+
+#include "SyntheticPrices.h"
+
+namespace po = boost::program_options;
+
+namespace
+{
+// the exchange names PF_CollectData accepts in 'exchange-list'.
+
+const std::vector<std::string> kExchanges{"NYSE",  "NASDAQ",  "AMEX", "BATS",  "OTCQX",
+                                          "OTCQB", "OTCMKTS", "PINK", "OTCCE", "OTCGREY"};
+
+constexpr double kTradingDaysPerYear = 252.0;
+constexpr double kSplitChancePerDay = 0.0004;
+constexpr int64_t kSplitAbovePriceCents = 20'000;
+constexpr int32_t kSymbolLetters = 4;
+
+struct GeneratorOptions
+{
+    std::string db_name_;
+    std::string db_user_;
+    std::string data_table_ = "new_stock_data.current_data";
+    std::string end_date_;
+    int32_t exchange_count_ = 3;
+    int32_t symbols_per_exchange_ = 500;
+    int32_t trading_days_ = 1'000;
+    uint64_t seed_ = 12345;
+    bool replace_ = false;
+};
+
+struct DailyBar
+{
+    int64_t open_;
+    int64_t high_;
+    int64_t low_;
+    int64_t close_;
+    int64_t volume_;
+};
+
+// 'AAAA', 'AAAB', ... unique across all exchanges.
+
+std::string MakeSymbol(int32_t symbol_number)
+{
+    std::string symbol(kSymbolLetters, 'A');
+    for (auto &letter : symbol | std::views::reverse)
+    {
+        letter = static_cast<char>('A' + symbol_number % 26);
+        symbol_number /= 26;
+    }
+    return symbol;
+}
+
+// the last 'how_many' weekdays up to and including 'last_day', oldest first.
+// Holidays are ignored -- the chart code doesn't care.
+
+std::vector<std::string> MakeTradingDays(std::chrono::sys_days last_day, int32_t how_many)
+{
+    std::vector<std::string> days;
+    days.reserve(how_many);
+    for (auto day = last_day; std::ssize(days) < how_many; day -= std::chrono::days{1})
+    {
+        const std::chrono::weekday wd{day};
+        if (wd != std::chrono::Saturday && wd != std::chrono::Sunday)
+        {
+            days.push_back(std::format("{:%F}", day));
+        }
+    }
+    std::ranges::reverse(days);
+    return days;
+}
+
+// generate split adjusted bars for one symbol. Returns the bars and the split
+// ratio which takes effect on each day (1 for no split).
+
+std::pair<std::vector<DailyBar>, std::vector<int32_t>> MakeBarsForSymbol(int32_t how_many_days, uint64_t seed)
+{
+    std::mt19937_64 engine{seed};
+    std::normal_distribution<double> normal{0.0, 1.0};
+    std::uniform_real_distribution<double> drift_dist{-0.10, 0.25};
+    std::uniform_real_distribution<double> volatility_dist{0.15, 0.80};
+    std::bernoulli_distribution split_dist{kSplitChancePerDay};
+
+    const double start_price = std::clamp(std::exp(std::log(40.0) + normal(engine)), 1.0, 2'000.0);
+    const double volatility = volatility_dist(engine);
+    const double daily_volatility = volatility / std::sqrt(kTradingDaysPerYear);
+    const double base_volume = std::exp(std::log(500'000.0) + 1.5 * normal(engine));
+
+    GBMPrices closes{start_price, drift_dist(engine), volatility, kTradingDaysPerYear, seed ^ 0x9E3779B97F4A7C15ULL};
+
+    std::vector<DailyBar> bars;
+    bars.reserve(how_many_days);
+    std::vector<int32_t> splits(how_many_days, 1);
+
+    int64_t prev_close = std::llround(start_price * 100.0);
+    for (int32_t day = 0; day < how_many_days; ++day)
+    {
+        const int64_t close = closes.NextPriceCents();
+        const int64_t open =
+            std::max<int64_t>(1, std::llround(prev_close * std::exp(0.3 * daily_volatility * normal(engine))));
+        const double upper_wick = std::abs(normal(engine)) * 0.5 * daily_volatility;
+        const double lower_wick = std::abs(normal(engine)) * 0.5 * daily_volatility;
+        const int64_t high = std::llround(std::max(open, close) * (1.0 + upper_wick));
+        const int64_t low = std::max<int64_t>(1, std::llround(std::min(open, close) * (1.0 - lower_wick)));
+
+        // volume picks up on big moves.
+
+        const double move = std::abs(std::log(static_cast<double>(close) / prev_close));
+        const auto volume = std::max<int64_t>(
+            100, std::llround(base_volume * std::exp(0.4 * normal(engine)) * (1.0 + 5.0 * move / daily_volatility)));
+
+        bars.push_back({.open_ = open, .high_ = high, .low_ = low, .close_ = close, .volume_ = volume});
+
+        if (day > 0 && close > kSplitAbovePriceCents && split_dist(engine))
+        {
+            splits[day] = 2;
+        }
+        prev_close = close;
+    }
+    return {std::move(bars), std::move(splits)};
+}
+
+void CreateSchema(pqxx::connection &c, const GeneratorOptions &options)
+{
+    const auto dot = options.data_table_.find('.');
+    const std::string table_only = dot == std::string::npos ? options.data_table_ : options.data_table_.substr(dot + 1);
+
+    pqxx::work trxn{c};
+
+    trxn.exec("CREATE SCHEMA IF NOT EXISTS new_stock_data");
+
+    if (options.replace_)
+    {
+        trxn.exec(std::format("DROP TABLE IF EXISTS {} CASCADE", options.data_table_));
+        trxn.exec("DROP TABLE IF EXISTS new_stock_data.names_and_symbols CASCADE");
+    }
+
+    trxn.exec(
+        "CREATE TABLE IF NOT EXISTS new_stock_data.names_and_symbols "
+        "(exchange TEXT NOT NULL, symbol TEXT NOT NULL, name TEXT, PRIMARY KEY (symbol))");
+
+    trxn.exec(std::format(
+        "CREATE TABLE IF NOT EXISTS {} (symbol TEXT NOT NULL, date DATE NOT NULL, "
+        "open NUMERIC(12, 4), high NUMERIC(12, 4), low NUMERIC(12, 4), close NUMERIC(12, 4), "
+        "adj_open NUMERIC(12, 4), adj_high NUMERIC(12, 4), adj_low NUMERIC(12, 4), adj_close NUMERIC(12, 4), "
+        "split_adj_open NUMERIC(12, 4), split_adj_high NUMERIC(12, 4), split_adj_low NUMERIC(12, 4), "
+        "split_adj_close NUMERIC(12, 4), volume BIGINT, dollar_volume NUMERIC(20, 2), PRIMARY KEY (symbol, date))",
+        options.data_table_));
+    trxn.exec(std::format("CREATE INDEX IF NOT EXISTS {}_date_idx ON {} (date)", table_only, options.data_table_));
+
+    // average dollar volume over about the last month of data.
+
+    trxn.exec(std::format(
+        "CREATE OR REPLACE FUNCTION new_stock_data.find_symbols_gte_min_dollar_volume(xchng TEXT, min_dollar_volume "
+        "NUMERIC) RETURNS SETOF TEXT LANGUAGE sql STABLE AS $$ "
+        "SELECT d.symbol FROM {0} AS d JOIN new_stock_data.names_and_symbols AS n ON n.symbol = d.symbol "
+        "WHERE n.exchange = xchng AND d.date > (SELECT MAX(date) FROM {0}) - 30 "
+        "GROUP BY d.symbol HAVING AVG(d.dollar_volume) >= min_dollar_volume ORDER BY d.symbol $$",
+        options.data_table_));
+
+    trxn.commit();
+}
+
+// 0 if the table doesn't exist yet.
+
+int64_t CountRows(pqxx::connection &c, std::string_view table)
+{
+    pqxx::work trxn{c};
+    if (trxn.query_value<std::optional<std::string>>(std::format("SELECT to_regclass({})", trxn.quote(table))))
+    {
+        return trxn.query_value<int64_t>(std::format("SELECT COUNT(*) FROM {}", table));
+    }
+    return 0;
+}
+
+// one transaction per exchange so a large load commits as it goes.
+
+int64_t LoadExchange(pqxx::connection &c, const GeneratorOptions &options, int32_t which_exchange,
+                     const std::vector<std::string> &trading_days)
+{
+    const auto &exchange = kExchanges[which_exchange];
+
+    pqxx::work trxn{c};
+
+    {
+        auto names = pqxx::stream_to::raw_table(trxn, "new_stock_data.names_and_symbols", "exchange, symbol, name");
+        for (int32_t i = 0; i < options.symbols_per_exchange_; ++i)
+        {
+            const auto symbol = MakeSymbol(which_exchange * options.symbols_per_exchange_ + i);
+            names.write_values(exchange, symbol, std::format("{} Synthetic Corp.", symbol));
+        }
+        names.complete();
+    }
+
+    int64_t rows = 0;
+    auto prices = pqxx::stream_to::raw_table(
+        trxn, options.data_table_,
+        "symbol, date, open, high, low, close, adj_open, adj_high, adj_low, adj_close, split_adj_open, "
+        "split_adj_high, split_adj_low, split_adj_close, volume, dollar_volume");
+
+    for (int32_t i = 0; i < options.symbols_per_exchange_; ++i)
+    {
+        const int32_t symbol_number = which_exchange * options.symbols_per_exchange_ + i;
+        const auto symbol = MakeSymbol(symbol_number);
+        const auto [bars, splits] =
+            MakeBarsForSymbol(static_cast<int32_t>(trading_days.size()), options.seed_ + symbol_number);
+
+        // the bars are split adjusted. Raw prices before a split are higher by the
+        // product of all later split ratios so walk backwards.
+
+        int64_t split_factor = 1;
+        for (auto day = std::ssize(bars) - 1; day >= 0; --day)
+        {
+            const auto &bar = bars[day];
+            const auto adj_open = CentsToPriceString(bar.open_);
+            const auto adj_high = CentsToPriceString(bar.high_);
+            const auto adj_low = CentsToPriceString(bar.low_);
+            const auto adj_close = CentsToPriceString(bar.close_);
+            const int64_t raw_volume = std::max<int64_t>(1, bar.volume_ / split_factor);
+
+            prices.write_values(symbol, trading_days[day], CentsToPriceString(bar.open_ * split_factor),
+                                CentsToPriceString(bar.high_ * split_factor),
+                                CentsToPriceString(bar.low_ * split_factor),
+                                CentsToPriceString(bar.close_ * split_factor), adj_open, adj_high, adj_low, adj_close,
+                                adj_open, adj_high, adj_low, adj_close, raw_volume,
+                                CentsToPriceString(bar.close_ * split_factor * raw_volume));
+            ++rows;
+
+            split_factor *= splits[day];
+        }
+    }
+    prices.complete();
+    trxn.commit();
+
+    return rows;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    GeneratorOptions options;
+
+    // clang-format off
+    po::options_description desc{"PF_GenerateStockDB options"};
+    desc.add_options()
+        ("help,h",                  "produce help message")
+        ("db-name",                 po::value<std::string>(&options.db_name_)->required(), "name of scratch database to fill.")
+        ("db-user",                 po::value<std::string>(&options.db_user_)->required(), "database user name.")
+        ("stock-db-data-source",    po::value<std::string>(&options.data_table_)->default_value("new_stock_data.current_data"), "table to put price data in. Default is 'new_stock_data.current_data'.")
+        ("exchanges",               po::value<int32_t>(&options.exchange_count_)->default_value(3), "number of exchanges: 1 - 10. Default is 3.")
+        ("symbols",                 po::value<int32_t>(&options.symbols_per_exchange_)->default_value(500), "symbols per exchange. Default is 500.")
+        ("days",                    po::value<int32_t>(&options.trading_days_)->default_value(1'000), "trading days of data for each symbol. Default is 1000.")
+        ("end-date",                po::value<std::string>(&options.end_date_), "last day of data. Default is 'yesterday'.")
+        ("seed",                    po::value<uint64_t>(&options.seed_)->default_value(12345), "random number seed. Default is 12345.")
+        ("replace",                 po::value<bool>(&options.replace_)->default_value(false)->implicit_value(true), "drop and rebuild the price and symbol tables.")
+        ;
+    // clang-format on
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        if (vm.contains("help"))
+        {
+            std::cout << desc << '\n';
+            return 0;
+        }
+        po::notify(vm);
+
+        if (options.exchange_count_ < 1 || options.exchange_count_ > std::ssize(kExchanges))
+        {
+            std::cerr << std::format("exchanges must be 1 - {}.\n", kExchanges.size());
+            return 1;
+        }
+        if (options.symbols_per_exchange_ < 1 || options.trading_days_ < 1)
+        {
+            std::cerr << "symbols and days must be > 0.\n";
+            return 1;
+        }
+        const int64_t total_symbols = static_cast<int64_t>(options.exchange_count_) * options.symbols_per_exchange_;
+        if (total_symbols > static_cast<int64_t>(std::pow(26, kSymbolLetters)))
+        {
+            std::cerr << "Too many symbols.\n";
+            return 1;
+        }
+
+        std::chrono::sys_days last_day;
+        if (options.end_date_.empty())
+        {
+            last_day = floor<std::chrono::days>(std::chrono::system_clock::now()) - std::chrono::days{1};
+        }
+        else
+        {
+            std::chrono::year_month_day ymd;
+            std::istringstream date_stream{options.end_date_};
+            date_stream >> std::chrono::parse("%F", ymd);
+            if (date_stream.fail())
+            {
+                std::cerr << std::format("Unable to parse end-date: {}\n", options.end_date_);
+                return 1;
+            }
+            last_day = ymd;
+        }
+        const auto trading_days = MakeTradingDays(last_day, options.trading_days_);
+
+        pqxx::connection c{std::format("dbname={} user={}", options.db_name_, options.db_user_)};
+
+        // check before touching anything in case this is not a scratch database.
+
+        if (const auto existing_rows = options.replace_ ? 0 : CountRows(c, options.data_table_); existing_rows > 0)
+        {
+            std::cerr << std::format("{} already has {} rows. Use '--replace' to rebuild it.\n", options.data_table_,
+                                     existing_rows);
+            return 1;
+        }
+        CreateSchema(c, options);
+
+        std::cout << std::format("Generating {} exchanges x {} symbols x {} days: {} to {} into: {}.\n",
+                                 options.exchange_count_, options.symbols_per_exchange_, options.trading_days_,
+                                 trading_days.front(), trading_days.back(), options.data_table_);
+
+        const auto started_at = std::chrono::steady_clock::now();
+        int64_t total_rows = 0;
+
+        for (int32_t which_exchange = 0; which_exchange < options.exchange_count_; ++which_exchange)
+        {
+            const auto rows = LoadExchange(c, options, which_exchange, trading_days);
+            total_rows += rows;
+            std::cout << std::format("{}: {} rows.\n", kExchanges[which_exchange], rows);
+        }
+
+        {
+            pqxx::nontransaction trxn{c};
+            trxn.exec(std::format("ANALYZE {}", options.data_table_));
+            trxn.exec("ANALYZE new_stock_data.names_and_symbols");
+        }
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started_at;
+        std::cout << std::format("Loaded {} rows in {:.1f}s: {:.0f} rows/sec.\n", total_rows, elapsed.count(),
+                                 static_cast<double>(total_rows) / elapsed.count());
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "PF_GenerateStockDB: " << e.what() << '\n';
+        return 2;
+    }
+    return 0;
+}
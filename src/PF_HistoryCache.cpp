@@ -0,0 +1,229 @@
+// =====================================================================================
+//
+//       Filename:  PF_HistoryCache.cpp
+//
+//    Description:  local cache of daily price history from our quote source so
+//    repeated runs don't have to ask for it again.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 11:50 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+
+#include <spdlog/spdlog.h>
+
+#include "PF_HistoryCache.h"
+
+namespace rng = std::ranges;
+
+namespace
+{
+constexpr std::string_view kMagic = "PF_HIST";
+constexpr int32_t kVersion = 1;
+
+template <typename T>
+bool ParseNumber(std::string_view text, T &value)
+{
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && ptr == text.data() + text.size();
+}
+
+int64_t SecondsNow()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// splits and dividends take effect when the market opens so that is the next
+// time adjusted prices for days which have closed can change. We don't bother
+// skipping weekends and holidays. That just costs an extra fetch.
+
+int64_t SecondsAtNextMarketOpen()
+{
+    using namespace std::chrono;
+    using namespace std::chrono_literals;
+
+    const auto *new_york = locate_zone("America/New_York");
+    const auto local_now = new_york->to_local(system_clock::now());
+    auto next_open = floor<days>(local_now) + 9h + 30min;
+    if (next_open <= local_now)
+    {
+        next_open += days{1};
+    }
+    return duration_cast<seconds>(new_york->to_sys(next_open, choose::earliest).time_since_epoch()).count();
+}
+} // namespace
+
+PF_HistoryCache::PF_HistoryCache(const fs::path &cache_directory, const std::string &provider,
+                                 std::chrono::seconds current_day_ttl)
+    : provider_directory_{cache_directory / provider}, current_day_ttl_{current_day_ttl}
+{
+    fs::create_directories(provider_directory_);
+    RemoveOldEntries();
+} // -----  end of method PF_HistoryCache::PF_HistoryCache  (constructor)  -----
+
+fs::path PF_HistoryCache::EntryFileName(const std::string &symbol, std::chrono::year_month_day first_day,
+                                        std::chrono::year_month_day last_day, UseAdjusted use_adjusted) const
+{
+    // some symbols have a '/' in them (share classes) which we can't have in a file name.
+
+    std::string file_symbol{symbol};
+    rng::replace(file_symbol, '/', '-');
+    return provider_directory_ / std::format("{}_{}_{}_{}.csv", file_symbol, first_day, last_day,
+                                             use_adjusted == UseAdjusted::e_Yes ? "adj" : "raw");
+} // -----  end of method PF_HistoryCache::EntryFileName  -----
+
+std::optional<std::vector<StockDataRecord>> PF_HistoryCache::Find(const std::string &symbol,
+                                                                  std::chrono::year_month_day first_day,
+                                                                  std::chrono::year_month_day last_day,
+                                                                  UseAdjusted use_adjusted) const
+{
+    const auto entry_file_name = EntryFileName(symbol, first_day, last_day, use_adjusted);
+
+    std::ifstream entry_file{entry_file_name, std::ios::in | std::ios::binary};
+    if (!entry_file)
+    {
+        ++misses_;
+        return std::nullopt;
+    }
+    const std::string contents{std::istreambuf_iterator<char>{entry_file}, std::istreambuf_iterator<char>{}};
+
+    // anything we don't like is just a miss. We'll fetch it again and replace it.
+
+    const auto lines = split_string<std::string_view>(contents, "\n");
+    const auto header = lines.empty() ? std::vector<std::string_view>{} : split_string<std::string_view>(lines[0], ",");
+    int32_t version = 0;
+    int64_t expires_at = 0;
+    size_t row_count = 0;
+    if (header.size() != 4 || header[0] != kMagic || !ParseNumber(header[1], version) || version != kVersion ||
+        !ParseNumber(header[2], expires_at) || !ParseNumber(header[3], row_count) || lines.size() < row_count + 1)
+    {
+        spdlog::debug(std::format("History cache entry: {} is not usable. Ignoring it.", entry_file_name));
+        ++misses_;
+        return std::nullopt;
+    }
+    if (expires_at != 0 && expires_at <= SecondsNow())
+    {
+        ++misses_;
+        return std::nullopt;
+    }
+
+    std::vector<StockDataRecord> history;
+    history.reserve(row_count);
+    for (const auto row : lines | std::views::drop(1) | std::views::take(row_count))
+    {
+        const auto fields = split_string<std::string_view>(row, ",");
+        if (fields.size() != 5)
+        {
+            ++misses_;
+            return std::nullopt;
+        }
+        history.push_back(StockDataRecord{.date_ = std::string{fields[0]},
+                                          .symbol_ = symbol,
+                                          .open_ = sv2dec(fields[1]),
+                                          .high_ = sv2dec(fields[2]),
+                                          .low_ = sv2dec(fields[3]),
+                                          .close_ = sv2dec(fields[4])});
+    }
+    ++hits_;
+    return history;
+} // -----  end of method PF_HistoryCache::Find  -----
+
+void PF_HistoryCache::Store(const std::string &symbol, std::chrono::year_month_day first_day,
+                            std::chrono::year_month_day last_day, UseAdjusted use_adjusted,
+                            const std::vector<StockDataRecord> &history)
+{
+    // if the range is over and we have its last day, it won't change. Unless it's
+    // adjusted: the next split or dividend rewrites adjusted prices back in time.
+
+    const std::chrono::year_month_day today{std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now())};
+    const auto last_day_text = std::format("{}", last_day);
+    const bool is_complete =
+        std::chrono::sys_days{last_day} < std::chrono::sys_days{today} &&
+        rng::any_of(history, [&](const auto &day) { return day.date_.starts_with(last_day_text); });
+
+    int64_t expires_at = SecondsNow() + current_day_ttl_.count();
+    if (is_complete)
+    {
+        expires_at = use_adjusted == UseAdjusted::e_No ? 0 : SecondsAtNextMarketOpen();
+    }
+
+    std::string contents = std::format("{},{},{},{}\n", kMagic, kVersion, expires_at, history.size());
+    for (const auto &day : history)
+    {
+        std::format_to(std::back_inserter(contents), "{},{},{},{},{}\n", day.date_, day.open_.format("f"),
+                       day.high_.format("f"), day.low_.format("f"), day.close_.format("f"));
+    }
+
+    // the pid keeps 2 processes storing the same entry from writing to the same temporary.
+
+    const auto entry_file_name = EntryFileName(symbol, first_day, last_day, use_adjusted);
+    const fs::path temp_file_name = fs::path{entry_file_name}.concat(std::format(".{}.tmp", ::getpid()));
+    try
+    {
+        {
+            std::ofstream entry_file{temp_file_name, std::ios::out | std::ios::binary | std::ios::trunc};
+            entry_file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+            if (!entry_file)
+            {
+                throw std::runtime_error(std::format("Unable to write: {}", temp_file_name));
+            }
+        }
+        fs::rename(temp_file_name, entry_file_name);
+    }
+    catch (const std::exception &e)
+    {
+        spdlog::error(std::format("Unable to store history for: {} in cache because: {}", symbol, e.what()));
+        std::error_code ec;
+        fs::remove(temp_file_name, ec);
+    }
+} // -----  end of method PF_HistoryCache::Store  -----
+
+void PF_HistoryCache::RemoveOldEntries() const
+{
+    // another process may be doing the same thing so we ignore files which vanish on us.
+
+    const auto oldest_to_keep = fs::file_time_type::clock::now() - kKeepFor;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator{provider_directory_, ec})
+    {
+        std::error_code entry_ec;
+        if (entry.is_regular_file(entry_ec) && entry.last_write_time(entry_ec) < oldest_to_keep && !entry_ec)
+        {
+            fs::remove(entry.path(), entry_ec);
+        }
+    }
+} // -----  end of method PF_HistoryCache::RemoveOldEntries  -----
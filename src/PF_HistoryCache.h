@@ -0,0 +1,136 @@
+// =====================================================================================
+//
+//       Filename:  PF_HistoryCache.h
+//
+//    Description:  local cache of daily price history from our quote source so
+//    repeated runs don't have to ask for it again.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 11:50 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _PF_HISTORYCACHE_INC_
+#define _PF_HISTORYCACHE_INC_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "utilities.h"
+
+namespace fs = std::filesystem;
+
+// =====================================================================================
+//        Class:  PF_HistoryCache
+//  Description:  daily price history by (provider, symbol, first day, last day,
+//  adjusted or not).
+//
+//  A day's prices don't change once it has closed so an unadjusted range which
+//  ends before today and includes its last day is kept for good. The same range
+//  of adjusted prices is kept until the next market open since that is when a
+//  split or dividend can rewrite them. A range the provider hasn't finished yet
+//  expires after current_day_ttl.
+//
+//  Each entry is its own small file under '<cache directory>/<provider>/':
+//  1 header line (version, expiry, row count) then 1 'date,open,high,low,close'
+//  line per day. Entries are written to a temporary file and renamed into place
+//  so any number of processes can share a cache directory without locking. At
+//  worst, 2 processes both fetch and write the same entry.
+//
+//  Our ranges move forward a day at a time so old entries are rarely asked for
+//  again. Entries written more than kKeepFor ago are removed when the cache is
+//  opened.
+// =====================================================================================
+
+class PF_HistoryCache
+{
+public:
+    static constexpr std::chrono::days kKeepFor{30};
+
+    // ====================  LIFECYCLE     =======================================
+
+    PF_HistoryCache() = delete;
+    PF_HistoryCache(const fs::path &cache_directory, const std::string &provider,
+                    std::chrono::seconds current_day_ttl);
+
+    PF_HistoryCache(const PF_HistoryCache &rhs) = delete;
+    PF_HistoryCache(PF_HistoryCache &&rhs) = delete;
+
+    ~PF_HistoryCache() = default;
+
+    // ====================  ACCESSORS     =======================================
+
+    // nothing if we don't have the entry, it has expired or it can't be read.
+    // Safe to call from any number of threads.
+
+    [[nodiscard]] std::optional<std::vector<StockDataRecord>> Find(const std::string &symbol,
+                                                                   std::chrono::year_month_day first_day,
+                                                                   std::chrono::year_month_day last_day,
+                                                                   UseAdjusted use_adjusted) const;
+
+    [[nodiscard]] int64_t Hits() const
+    {
+        return hits_;
+    }
+    [[nodiscard]] int64_t Misses() const
+    {
+        return misses_;
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    // failures are logged, not thrown. The cache is just an optimization.
+
+    void Store(const std::string &symbol, std::chrono::year_month_day first_day, std::chrono::year_month_day last_day,
+               UseAdjusted use_adjusted, const std::vector<StockDataRecord> &history);
+
+    // ====================  OPERATORS     =======================================
+
+    PF_HistoryCache &operator=(const PF_HistoryCache &rhs) = delete;
+    PF_HistoryCache &operator=(PF_HistoryCache &&rhs) = delete;
+
+private:
+    // ====================  METHODS       =======================================
+
+    [[nodiscard]] fs::path EntryFileName(const std::string &symbol, std::chrono::year_month_day first_day,
+                                         std::chrono::year_month_day last_day, UseAdjusted use_adjusted) const;
+
+    void RemoveOldEntries() const;
+
+    // ====================  DATA MEMBERS  =======================================
+
+    fs::path provider_directory_;
+    std::chrono::seconds current_day_ttl_;
+
+    mutable std::atomic<int64_t> hits_ = 0;
+    mutable std::atomic<int64_t> misses_ = 0;
+
+}; // -----  end of class PF_HistoryCache  -----
+
+#endif // ----- #ifndef _PF_HISTORYCACHE_INC_  -----
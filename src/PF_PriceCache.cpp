@@ -0,0 +1,719 @@
+// =====================================================================================
+//
+//       Filename:  PF_PriceCache.cpp
+//
+//    Description:  Local, memory-mapped cache of EOD closing prices retrieved
+//    from the stock price database.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 09:40 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+#include <pqxx/pqxx>
+#include <spdlog/spdlog.h>
+
+namespace rng = std::ranges;
+
+#include "DateTimeParsing.h"
+#include "PF_PriceCache.h"
+
+// some constants for the cache files.
+
+namespace
+{
+constexpr char kCacheMagic[8] = {'P', 'F', 'P', 'R', 'I', 'C', 'E', 'S'};
+constexpr uint32_t kCacheVersion = 2;
+
+// when the log gets this big, fold it back into the main data file.
+
+constexpr size_t kMaxLogRecords = 100'000;
+
+// keep the 'IN' lists in our queries to a reasonable size.
+
+constexpr size_t kSymbolsPerQuery = 500;
+
+constexpr uint64_t AlignTo8(uint64_t offset)
+{
+    return (offset + 7) & ~uint64_t{7};
+}
+
+std::string_view SymbolFromField(const char (&field)[PF_PriceCache::kSymbolLength])
+{
+    return {field, ::strnlen(field, PF_PriceCache::kSymbolLength)};
+}
+
+void CopySymbolToField(std::string_view symbol, char (&field)[PF_PriceCache::kSymbolLength])
+{
+    std::memset(field, 0, PF_PriceCache::kSymbolLength);
+    std::memcpy(field, symbol.data(), std::min(symbol.size(), PF_PriceCache::kSymbolLength));
+}
+
+// our DB only contains dates for EOD data, so we store days since the epoch.
+
+int32_t DateStringToDays(std::string_view date)
+{
+    const auto the_date = ParseDate(date);
+    if (!the_date)
+    {
+        throw std::invalid_argument{std::format("Unable to convert: '{}' to a date.", date)};
+    }
+    return the_date->time_since_epoch().count();
+}
+
+// gives the same time point as we get when loading "%F" dates from the DB.
+
+UTCTimePoint DaysToUTCTimePoint(int32_t days)
+{
+    return SysToUTCTimePoint(std::chrono::sys_days{std::chrono::days{days}});
+}
+
+std::string DaysToDateString(int32_t days)
+{
+    return std::format("{:%F}", std::chrono::sys_days{std::chrono::days{days}});
+}
+
+// split a price field from the DB into coefficient and exponent so we can store it
+// without any loss. Decimal would do this for us but its internal representation
+// is not something we want to write to disk.
+
+bool PriceTextToCachedPrice(std::string_view price, PF_PriceCache::CachedPrice &cached_price)
+{
+    if (price.empty())
+    {
+        return false;
+    }
+    bool negative = false;
+    if (price.front() == '-' || price.front() == '+')
+    {
+        negative = price.front() == '-';
+        price.remove_prefix(1);
+    }
+
+    int64_t coefficient = 0;
+    int32_t exponent = 0;
+    bool seen_point = false;
+    bool seen_digit = false;
+    for (const char c : price)
+    {
+        if (c == '.' && !seen_point)
+        {
+            seen_point = true;
+            continue;
+        }
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+        const int digit = c - '0';
+        if (coefficient > (std::numeric_limits<int64_t>::max() - digit) / 10)
+        {
+            return false;
+        }
+        seen_digit = true;
+        coefficient = coefficient * 10 + digit;
+        if (seen_point)
+        {
+            --exponent;
+        }
+    }
+    if (!seen_digit)
+    {
+        return false;
+    }
+    cached_price.coefficient_ = negative ? -coefficient : coefficient;
+    cached_price.exponent_ = exponent;
+    return true;
+}
+
+template <typename T> void WriteBinary(std::ofstream &output, const T &value)
+{
+    output.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void PadTo(std::ofstream &output, uint64_t offset)
+{
+    static constexpr char kZeros[8] = {};
+    const auto current = static_cast<uint64_t>(output.tellp());
+    BOOST_ASSERT_MSG(offset >= current && offset - current < 8, "Price cache file layout is inconsistent.");
+    output.write(kZeros, static_cast<std::streamsize>(offset - current));
+}
+
+} // namespace
+
+bool IsAdjustedPriceField(std::string_view price_fld_name)
+{
+    // field names are case insensitive in the DB.
+
+    std::string lower_case_name{price_fld_name};
+    rng::transform(lower_case_name, lower_case_name.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower_case_name.contains("adj");
+} // -----  end of function IsAdjustedPriceField  -----
+
+//--------------------------------------------------------------------------------------
+//       Class:  PF_PriceCache
+//      Method:  PF_PriceCache
+// Description:  constructor
+//--------------------------------------------------------------------------------------
+PF_PriceCache::PF_PriceCache(const fs::path &cache_directory, const PF_DB::DB_Params &db_params,
+                             std::string price_fld_name)
+    : db_params_{db_params}, price_fld_name_{std::move(price_fld_name)}
+{
+    BOOST_ASSERT_MSG(!cache_directory.empty(), "Must provide a directory for price cache.");
+    BOOST_ASSERT_MSG(!db_params_.stock_db_data_source_.empty(), "Must provide stock data source for price cache.");
+    BOOST_ASSERT_MSG(!price_fld_name_.empty(), "Must provide price field name for price cache.");
+    BOOST_ASSERT_MSG(!IsAdjustedPriceField(price_fld_name_), "Price cache can't hold adjusted prices.");
+
+    // data from different sources or different price fields must not get mixed.
+
+    std::string cache_name = std::format("{}_{}", db_params_.stock_db_data_source_, price_fld_name_);
+    rng::replace_if(cache_name, [](char c) { return c == '.' || c == '/'; }, '_');
+
+    cache_directory_ = cache_directory / cache_name;
+    fs::create_directories(cache_directory_);
+
+    data_file_name_ = cache_directory_ / "prices.dat";
+    log_file_name_ = cache_directory_ / "prices.log";
+
+    OpenCacheFiles();
+} // -----  end of method PF_PriceCache::PF_PriceCache  (constructor)  -----
+
+void PF_PriceCache::OpenCacheFiles()
+{
+    price_data_ = MappedFile{};
+    index_entries_.clear();
+    logged_prices_.clear();
+    logged_checked_through_.clear();
+    log_record_count_ = 0;
+
+    if (fs::exists(data_file_name_))
+    {
+        MappedFile price_data{data_file_name_, MappedFile::Access::e_Random};
+
+        FileHeader header{};
+        if (price_data.size() < sizeof(FileHeader))
+        {
+            throw std::runtime_error{std::format("Price cache file: {} is too small.", data_file_name_)};
+        }
+        std::memcpy(&header, price_data.data(), sizeof(FileHeader));
+        if (std::memcmp(header.magic_, kCacheMagic, sizeof(kCacheMagic)) == 0 && header.version_ < kCacheVersion)
+        {
+            // an older layout. Nothing in it is lost by just loading it again from the DB.
+
+            spdlog::info(std::format("Price cache: {} is version: {}. Rebuilding it.", cache_directory_,
+                                     header.version_));
+            price_data = MappedFile{};
+            fs::remove(data_file_name_);
+            fs::remove(log_file_name_);
+            return;
+        }
+        if (std::memcmp(header.magic_, kCacheMagic, sizeof(kCacheMagic)) != 0 || header.version_ != kCacheVersion)
+        {
+            throw std::runtime_error{
+                std::format("Price cache file: {} is not a version: {} cache file.", data_file_name_, kCacheVersion)};
+        }
+        if (header.index_offset_ + header.symbol_count_ * sizeof(IndexEntry) > price_data.size())
+        {
+            throw std::runtime_error{std::format("Price cache file: {} is truncated.", data_file_name_)};
+        }
+
+        index_entries_.resize(header.symbol_count_);
+        std::memcpy(index_entries_.data(), price_data.data() + header.index_offset_,
+                    header.symbol_count_ * sizeof(IndexEntry));
+        price_data_ = std::move(price_data);
+    }
+
+    if (fs::exists(log_file_name_))
+    {
+        // a partial record at the end means we were interrupted while appending.
+        // we just ignore it.
+
+        MappedFile log_data{log_file_name_, MappedFile::Access::e_Sequential};
+        const size_t record_count = log_data.size() / sizeof(LogRecord);
+        for (size_t i = 0; i < record_count; ++i)
+        {
+            LogRecord record{};
+            std::memcpy(&record, log_data.data() + i * sizeof(LogRecord), sizeof(LogRecord));
+            if (record.exponent_ == kCheckedThroughMarker)
+            {
+                const auto symbol = SymbolFromField(record.symbol_);
+                auto checked = logged_checked_through_.try_emplace(std::string{symbol}, record.day_).first;
+                checked->second = std::max(checked->second, record.day_);
+                ++log_record_count_;
+                continue;
+            }
+            auto &prices = logged_prices_[std::string{SymbolFromField(record.symbol_)}];
+            if (prices.empty() || record.day_ > prices.back().day_)
+            {
+                prices.emplace_back(record.day_, record.exponent_, record.coefficient_);
+                ++log_record_count_;
+            }
+        }
+    }
+    spdlog::debug(std::format("Price cache: {} contains: {} symbols and: {} log records.", cache_directory_,
+                              index_entries_.size(), log_record_count_));
+} // -----  end of method PF_PriceCache::OpenCacheFiles  -----
+
+const PF_PriceCache::IndexEntry *PF_PriceCache::FindIndexEntry(std::string_view symbol) const
+{
+    const auto found = rng::lower_bound(index_entries_, symbol, {},
+                                        [](const IndexEntry &entry) { return SymbolFromField(entry.symbol_); });
+    if (found == index_entries_.end() || SymbolFromField(found->symbol_) != symbol)
+    {
+        return nullptr;
+    }
+    return &*found;
+} // -----  end of method PF_PriceCache::FindIndexEntry  -----
+
+bool PF_PriceCache::ContainsSymbol(std::string_view symbol) const
+{
+    return FindIndexEntry(symbol) != nullptr;
+} // -----  end of method PF_PriceCache::ContainsSymbol  -----
+
+int32_t PF_PriceCache::LastCachedDay(const IndexEntry &entry) const
+{
+    // a symbol with no data yet is still 'current' as of the day before its coverage starts.
+    // a symbol with no new data is 'current' as of the last time we checked.
+
+    int32_t last_day = entry.row_count_ == 0 ? entry.coverage_from_day_ - 1 : entry.last_day_;
+    last_day = std::max(last_day, entry.checked_through_day_);
+
+    const auto symbol = SymbolFromField(entry.symbol_);
+    if (const auto found = logged_prices_.find(symbol); found != logged_prices_.end() && !found->second.empty())
+    {
+        last_day = std::max(last_day, found->second.back().day_);
+    }
+    if (const auto found = logged_checked_through_.find(symbol); found != logged_checked_through_.end())
+    {
+        last_day = std::max(last_day, found->second);
+    }
+    return last_day;
+} // -----  end of method PF_PriceCache::LastCachedDay  -----
+
+PF_PriceCache::SymbolPrices PF_PriceCache::CollectCachedPrices(const IndexEntry &entry) const
+{
+    SymbolPrices prices;
+    prices.reserve(entry.row_count_);
+
+    const auto *days = reinterpret_cast<const int32_t *>(price_data_.data() + entry.days_offset_);
+    const auto *coefficients = reinterpret_cast<const int64_t *>(price_data_.data() + entry.coefficients_offset_);
+    const auto *exponents = reinterpret_cast<const int8_t *>(price_data_.data() + entry.exponents_offset_);
+
+    for (uint32_t i = 0; i < entry.row_count_; ++i)
+    {
+        prices.emplace_back(days[i], exponents[i], coefficients[i]);
+    }
+
+    // if we were interrupted between compacting and clearing the log, the log can
+    // repeat days we already have.
+
+    if (const auto found = logged_prices_.find(SymbolFromField(entry.symbol_)); found != logged_prices_.end())
+    {
+        for (const auto &price : found->second)
+        {
+            if (entry.row_count_ == 0 || price.day_ > entry.last_day_)
+            {
+                prices.push_back(price);
+            }
+        }
+    }
+    return prices;
+} // -----  end of method PF_PriceCache::CollectCachedPrices  -----
+
+std::vector<DateCloseRecord> PF_PriceCache::GetClosingPrices(std::string_view symbol,
+                                                             std::string_view begin_date) const
+{
+    std::vector<DateCloseRecord> closing_prices;
+
+    const auto *entry = FindIndexEntry(symbol);
+    if (entry == nullptr)
+    {
+        return closing_prices;
+    }
+
+    const int32_t begin_day = DateStringToDays(begin_date);
+
+    // we read the columns directly from the mapped file and only build Decimals
+    // for the rows we actually return.
+
+    const auto *days = reinterpret_cast<const int32_t *>(price_data_.data() + entry->days_offset_);
+    const auto *coefficients = reinterpret_cast<const int64_t *>(price_data_.data() + entry->coefficients_offset_);
+    const auto *exponents = reinterpret_cast<const int8_t *>(price_data_.data() + entry->exponents_offset_);
+
+    const auto *first = std::lower_bound(days, days + entry->row_count_, begin_day);
+
+    const auto logged = logged_prices_.find(symbol);
+    closing_prices.reserve((days + entry->row_count_ - first) +
+                           (logged != logged_prices_.end() ? logged->second.size() : 0));
+
+    for (auto i = static_cast<uint32_t>(first - days); i < entry->row_count_; ++i)
+    {
+        const decimal::Decimal exponent{static_cast<int32_t>(exponents[i])};
+        closing_prices.emplace_back(DateCloseRecord{.date_ = DaysToUTCTimePoint(days[i]),
+                                                    .close_ = decimal::Decimal{coefficients[i]}.scaleb(exponent)});
+    }
+    if (logged != logged_prices_.end())
+    {
+        for (const auto &price : logged->second)
+        {
+            if (price.day_ >= begin_day && (entry->row_count_ == 0 || price.day_ > entry->last_day_))
+            {
+                closing_prices.emplace_back(DateCloseRecord{
+                    .date_ = DaysToUTCTimePoint(price.day_),
+                    .close_ = decimal::Decimal{price.coefficient_}.scaleb(decimal::Decimal{price.exponent_})});
+            }
+        }
+    }
+    return closing_prices;
+} // -----  end of method PF_PriceCache::GetClosingPrices  -----
+
+std::map<std::string, PF_PriceCache::SymbolPrices> PF_PriceCache::QueryPricesFromDB(
+    const std::vector<std::string> &symbols, std::string_view begin_date, bool after_begin_date) const
+{
+    std::map<std::string, SymbolPrices> results;
+    if (symbols.empty())
+    {
+        return results;
+    }
+
+    struct CacheRow
+    {
+        std::string symbol_;
+        CachedPrice price_;
+        bool ok_;
+    };
+
+    auto Row2CacheRow = [](const auto &r) {
+        CacheRow row{.symbol_ = std::string{std::get<0>(r)}, .price_ = {}, .ok_ = false};
+        row.price_.day_ = DateStringToDays(std::get<1>(r));
+        row.ok_ = PriceTextToCachedPrice(std::get<2>(r), row.price_);
+        return row;
+    };
+
+    PF_DB pf_db{db_params_};
+    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+
+    for (const auto &batch : symbols | std::views::chunk(kSymbolsPerQuery))
+    {
+        std::string query_list;
+        for (const auto &symbol : batch)
+        {
+            query_list += query_list.empty() ? "( " : ", ";
+            query_list += c.quote(symbol);
+        }
+        query_list += " )";
+
+        std::string get_symbol_prices_cmd = std::format(
+            "SELECT symbol, date, {} FROM {} WHERE symbol IN {} AND date {} {} ORDER BY symbol, date ASC",
+            price_fld_name_, db_params_.stock_db_data_source_, query_list, after_begin_date ? ">" : ">=",
+            c.quote(begin_date));
+
+        const auto rows = pf_db.RunSQLQueryUsingStream<CacheRow, std::string_view, std::string_view, std::string_view>(
+            get_symbol_prices_cmd, Row2CacheRow);
+
+        for (const auto &row : rows)
+        {
+            if (!row.ok_)
+            {
+                spdlog::error(std::format("Unable to cache price for symbol: {} on day: {}. Skipping it.", row.symbol_,
+                                          std::chrono::sys_days{std::chrono::days{row.price_.day_}}));
+                continue;
+            }
+            results[row.symbol_].push_back(row.price_);
+        }
+    }
+    return results;
+} // -----  end of method PF_PriceCache::QueryPricesFromDB  -----
+
+void PF_PriceCache::RefreshSymbols(const std::vector<std::string> &symbols, std::string_view begin_date)
+{
+    const int32_t begin_day = DateStringToDays(begin_date);
+
+    std::vector<std::string> need_full_history;
+
+    // symbols we already have, grouped by the day we last checked them through, so each
+    // one only asks for what has been added since then.
+
+    std::map<int32_t, std::vector<std::string>> need_update;
+
+    for (const auto &symbol : symbols)
+    {
+        BOOST_ASSERT_MSG(symbol.size() <= kSymbolLength,
+                         std::format("Symbol: {} is too long for price cache.", symbol).c_str());
+        const auto *entry = FindIndexEntry(symbol);
+        if (entry == nullptr || entry->coverage_from_day_ > begin_day)
+        {
+            need_full_history.push_back(symbol);
+            continue;
+        }
+        need_update[LastCachedDay(*entry)].push_back(symbol);
+    }
+
+    // the newest day the DB gave us for any symbol. Every symbol we asked about is
+    // checked through that day whether it had new rows or not.
+
+    int32_t newest_day = std::numeric_limits<int32_t>::min();
+    auto NoteNewestDay = [&newest_day](const auto &new_prices) {
+        for (const auto &prices : new_prices | std::views::values)
+        {
+            if (!prices.empty())
+            {
+                newest_day = std::max(newest_day, prices.back().day_);
+            }
+        }
+    };
+
+    std::map<std::string, SymbolPrices> updated_prices;
+    for (const auto &[last_day, group] : need_update)
+    {
+        auto new_prices = QueryPricesFromDB(group, DaysToDateString(last_day), true);
+        NoteNewestDay(new_prices);
+        updated_prices.merge(new_prices);
+    }
+    AppendToLog(updated_prices);
+
+    // symbols which are new to us (or where we need more history) go directly into a new
+    // main data file. We include symbols with no data so we don't keep asking for them.
+
+    if (!need_full_history.empty())
+    {
+        spdlog::info(std::format("Loading full price history for: {} symbols into price cache.",
+                                 need_full_history.size()));
+        auto new_prices = QueryPricesFromDB(need_full_history, begin_date, false);
+        NoteNewestDay(new_prices);
+        for (const auto &symbol : need_full_history)
+        {
+            new_prices.try_emplace(symbol);
+        }
+        WriteCacheFile(new_prices, begin_day);
+    }
+
+    if (newest_day != std::numeric_limits<int32_t>::min())
+    {
+        std::vector<std::string> checked;
+        for (const auto &symbol : symbols)
+        {
+            if (LastCachedDay(*FindIndexEntry(symbol)) < newest_day)
+            {
+                checked.push_back(symbol);
+            }
+        }
+        AppendCheckedToLog(checked, newest_day);
+    }
+
+    if (log_record_count_ > kMaxLogRecords)
+    {
+        Compact();
+    }
+} // -----  end of method PF_PriceCache::RefreshSymbols  -----
+
+void PF_PriceCache::AppendToLog(const std::map<std::string, SymbolPrices> &new_prices)
+{
+    if (new_prices.empty())
+    {
+        return;
+    }
+
+    std::ofstream log_file{log_file_name_, std::ios::out | std::ios::binary | std::ios::app};
+    BOOST_ASSERT_MSG(log_file.is_open(), std::format("Unable to open price cache log: {}", log_file_name_).c_str());
+
+    for (const auto &[symbol, prices] : new_prices)
+    {
+        auto &logged = logged_prices_[symbol];
+        for (const auto &price : prices)
+        {
+            LogRecord record{};
+            CopySymbolToField(symbol, record.symbol_);
+            record.day_ = price.day_;
+            record.exponent_ = price.exponent_;
+            record.coefficient_ = price.coefficient_;
+            WriteBinary(log_file, record);
+
+            logged.push_back(price);
+            ++log_record_count_;
+        }
+    }
+    log_file.flush();
+    BOOST_ASSERT_MSG(log_file.good(), std::format("Unable to append to price cache log: {}", log_file_name_).c_str());
+} // -----  end of method PF_PriceCache::AppendToLog  -----
+
+void PF_PriceCache::AppendCheckedToLog(const std::vector<std::string> &symbols, int32_t checked_through_day)
+{
+    if (symbols.empty())
+    {
+        return;
+    }
+
+    std::ofstream log_file{log_file_name_, std::ios::out | std::ios::binary | std::ios::app};
+    BOOST_ASSERT_MSG(log_file.is_open(), std::format("Unable to open price cache log: {}", log_file_name_).c_str());
+
+    for (const auto &symbol : symbols)
+    {
+        LogRecord record{};
+        CopySymbolToField(symbol, record.symbol_);
+        record.day_ = checked_through_day;
+        record.exponent_ = kCheckedThroughMarker;
+        WriteBinary(log_file, record);
+
+        logged_checked_through_.insert_or_assign(symbol, checked_through_day);
+        ++log_record_count_;
+    }
+    log_file.flush();
+    BOOST_ASSERT_MSG(log_file.good(), std::format("Unable to append to price cache log: {}", log_file_name_).c_str());
+} // -----  end of method PF_PriceCache::AppendCheckedToLog  -----
+
+void PF_PriceCache::Compact()
+{
+    WriteCacheFile({}, 0);
+} // -----  end of method PF_PriceCache::Compact  -----
+
+void PF_PriceCache::WriteCacheFile(const std::map<std::string, SymbolPrices> &replacements,
+                                   int32_t replacements_coverage_day)
+{
+    // gather everything for the new file in symbol order. Existing entries are merged
+    // with their log records unless they are being replaced.
+
+    struct NewEntry
+    {
+        std::string symbol_;
+        SymbolPrices prices_;
+        int32_t coverage_from_day_;
+        int32_t checked_through_day_;
+    };
+    std::vector<NewEntry> new_entries;
+    new_entries.reserve(index_entries_.size() + replacements.size());
+
+    for (const auto &entry : index_entries_)
+    {
+        std::string symbol{SymbolFromField(entry.symbol_)};
+        if (!replacements.contains(symbol))
+        {
+            const auto checked = logged_checked_through_.find(symbol);
+            const int32_t checked_through_day = checked == logged_checked_through_.end()
+                                                    ? entry.checked_through_day_
+                                                    : std::max(entry.checked_through_day_, checked->second);
+            new_entries.emplace_back(std::move(symbol), CollectCachedPrices(entry), entry.coverage_from_day_,
+                                     checked_through_day);
+        }
+    }
+    for (const auto &[symbol, prices] : replacements)
+    {
+        new_entries.emplace_back(symbol, prices, replacements_coverage_day, 0);
+    }
+    rng::sort(new_entries, {}, &NewEntry::symbol_);
+
+    // now, lay out the file.
+
+    FileHeader header{};
+    std::memcpy(header.magic_, kCacheMagic, sizeof(kCacheMagic));
+    header.version_ = kCacheVersion;
+    header.symbol_count_ = static_cast<uint32_t>(new_entries.size());
+    header.index_offset_ = AlignTo8(sizeof(FileHeader));
+
+    std::vector<IndexEntry> new_index(new_entries.size());
+    uint64_t offset = AlignTo8(header.index_offset_ + new_entries.size() * sizeof(IndexEntry));
+
+    for (const auto &[entry, index] : std::views::zip(new_entries, new_index))
+    {
+        CopySymbolToField(entry.symbol_, index.symbol_);
+        index.row_count_ = static_cast<uint32_t>(entry.prices_.size());
+        index.first_day_ = entry.prices_.empty() ? 0 : entry.prices_.front().day_;
+        index.last_day_ = entry.prices_.empty() ? 0 : entry.prices_.back().day_;
+        index.coverage_from_day_ = entry.coverage_from_day_;
+        index.checked_through_day_ = entry.checked_through_day_;
+
+        index.days_offset_ = offset;
+        offset = AlignTo8(offset + index.row_count_ * sizeof(int32_t));
+        index.coefficients_offset_ = offset;
+        offset = AlignTo8(offset + index.row_count_ * sizeof(int64_t));
+        index.exponents_offset_ = offset;
+        offset = AlignTo8(offset + index.row_count_ * sizeof(int8_t));
+
+        header.total_rows_ += index.row_count_;
+    }
+
+    // write to a temporary file and rename it into place so readers never see a partial file.
+
+    const fs::path temp_file_name = fs::path{data_file_name_}.concat(".tmp");
+    {
+        std::ofstream data_file{temp_file_name, std::ios::out | std::ios::binary | std::ios::trunc};
+        BOOST_ASSERT_MSG(data_file.is_open(),
+                         std::format("Unable to open price cache file: {} for writing.", temp_file_name).c_str());
+
+        WriteBinary(data_file, header);
+        PadTo(data_file, header.index_offset_);
+        data_file.write(reinterpret_cast<const char *>(new_index.data()),
+                        static_cast<std::streamsize>(new_index.size() * sizeof(IndexEntry)));
+
+        for (const auto &[entry, index] : std::views::zip(new_entries, new_index))
+        {
+            PadTo(data_file, index.days_offset_);
+            for (const auto &price : entry.prices_)
+            {
+                WriteBinary(data_file, price.day_);
+            }
+            PadTo(data_file, index.coefficients_offset_);
+            for (const auto &price : entry.prices_)
+            {
+                WriteBinary(data_file, price.coefficient_);
+            }
+            PadTo(data_file, index.exponents_offset_);
+            for (const auto &price : entry.prices_)
+            {
+                BOOST_ASSERT_MSG(price.exponent_ >= std::numeric_limits<int8_t>::min() && price.exponent_ <= 0,
+                                 std::format("Price exponent: {} for: {} can't be cached.", price.exponent_,
+                                             entry.symbol_)
+                                     .c_str());
+                WriteBinary(data_file, static_cast<int8_t>(price.exponent_));
+            }
+        }
+        PadTo(data_file, offset);
+        data_file.flush();
+        BOOST_ASSERT_MSG(data_file.good(),
+                         std::format("Unable to write price cache file: {}.", temp_file_name).c_str());
+    }
+
+    fs::rename(temp_file_name, data_file_name_);
+
+    // everything in the log is now in the main file.
+
+    fs::remove(log_file_name_);
+
+    OpenCacheFiles();
+
+    spdlog::info(std::format("Wrote price cache: {} with: {} symbols and: {} rows.", data_file_name_,
+                             header.symbol_count_, header.total_rows_));
+} // -----  end of method PF_PriceCache::WriteCacheFile  -----
@@ -0,0 +1,216 @@
+// =====================================================================================
+//
+//       Filename:  PF_PriceCache.h
+//
+//    Description:  Local, memory-mapped cache of EOD closing prices retrieved
+//    from the stock price database.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 09:40 AM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _PF_PRICECACHE_INC_
+#define _PF_PRICECACHE_INC_
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+#include "PointAndFigureDB.h"
+#include "utilities.h"
+
+// true for any price field which holds split or dividend adjusted prices
+// ('adj_close', 'Adj_Close', 'split_adj_close'...).
+
+[[nodiscard]] bool IsAdjustedPriceField(std::string_view price_fld_name);
+
+// =====================================================================================
+//        Class:  PF_PriceCache
+//  Description:  read-through cache for closing prices from 'stock_db_data_source_'.
+//
+//  EOD history does not change once a day is closed so there is no need to
+//  re-query it from the DB every time we build a set of charts.  Each cache
+//  directory holds data for 1 stock data source and 1 price field.
+//
+//  Only days we don't have are ever asked for again so adjusted prices, which
+//  every split or dividend changes back in time, can't be cached. If old rows
+//  in the DB are corrected, remove the cache directory so it is rebuilt.
+//
+//  Each symbol also remembers the newest day it has been checked through so
+//  a symbol with no new rows (halted, delisted) doesn't make us ask for more
+//  than we need. This assumes the DB is loaded a whole day at a time.
+//
+//  prices.dat: header, then a sorted symbol index, then for each symbol,
+//  contiguous arrays of days (since epoch), price coefficients and price
+//  exponents.  The file is memory mapped so loads do no parsing at all.
+//
+//  prices.log: fixed size records for days added (and symbols checked) since
+//  the last compaction. Refreshing from the DB only appends here.  When the log gets large (or we
+//  need to replace a symbol's history) we compact everything into a new
+//  prices.dat which is renamed into place.
+//
+//  NOTE: there is no locking so only 1 process should refresh a given cache at a time.
+// =====================================================================================
+
+class PF_PriceCache
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    PF_PriceCache() = delete;
+    PF_PriceCache(const fs::path &cache_directory, const PF_DB::DB_Params &db_params, std::string price_fld_name);
+
+    PF_PriceCache(const PF_PriceCache &rhs) = delete;
+    PF_PriceCache(PF_PriceCache &&rhs) = delete;
+
+    ~PF_PriceCache() = default;
+
+    // ====================  ACCESSORS     =======================================
+
+    // all cached prices for symbol on or after begin_date in ascending date order.
+    // Nothing is returned for symbols which have not been refreshed.
+
+    [[nodiscard]] std::vector<DateCloseRecord> GetClosingPrices(std::string_view symbol,
+                                                                std::string_view begin_date) const;
+
+    [[nodiscard]] bool ContainsSymbol(std::string_view symbol) const;
+    [[nodiscard]] size_t GetSymbolCount() const
+    {
+        return index_entries_.size();
+    }
+    [[nodiscard]] size_t GetLogRecordCount() const
+    {
+        return log_record_count_;
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    // make sure the cache contains everything the DB has for each symbol from begin_date
+    // on. Symbols we already have are brought up to date with 1 incremental query per
+    // batch of symbols checked through the same day. Symbols we don't have (or whose
+    // history starts too late) are loaded in full and then the cache is compacted.
+
+    void RefreshSymbols(const std::vector<std::string> &symbols, std::string_view begin_date);
+
+    void Compact();
+
+    // ====================  OPERATORS     =======================================
+
+    PF_PriceCache &operator=(const PF_PriceCache &rhs) = delete;
+    PF_PriceCache &operator=(PF_PriceCache &&rhs) = delete;
+
+    // storage formats. These are written to and read from disk as-is.
+
+    static constexpr size_t kSymbolLength = 24;
+
+    struct FileHeader
+    {
+        char magic_[8];
+        uint32_t version_;
+        uint32_t symbol_count_;
+        uint64_t index_offset_;
+        uint64_t total_rows_;
+    };
+
+    struct IndexEntry
+    {
+        char symbol_[kSymbolLength];
+        uint64_t days_offset_;
+        uint64_t coefficients_offset_;
+        uint64_t exponents_offset_;
+        uint32_t row_count_;
+        int32_t first_day_;
+        int32_t last_day_;
+        int32_t coverage_from_day_;   // earliest 'begin_date' we have loaded data for.
+        int32_t checked_through_day_; // newest day we have asked the DB about.
+        int32_t unused_;
+    };
+
+    // a log record with this exponent has no price. It records the symbol was checked through 'day_'.
+
+    static constexpr int32_t kCheckedThroughMarker = std::numeric_limits<int32_t>::min();
+
+    struct LogRecord
+    {
+        char symbol_[kSymbolLength];
+        int32_t day_;
+        int32_t exponent_;
+        int64_t coefficient_;
+    };
+
+    // 1 price as stored in the cache.
+
+    struct CachedPrice
+    {
+        int32_t day_;
+        int32_t exponent_;
+        int64_t coefficient_;
+    };
+
+    using SymbolPrices = std::vector<CachedPrice>;
+
+private:
+    // ====================  METHODS       =======================================
+
+    void OpenCacheFiles();
+    [[nodiscard]] const IndexEntry *FindIndexEntry(std::string_view symbol) const;
+    [[nodiscard]] int32_t LastCachedDay(const IndexEntry &entry) const;
+    [[nodiscard]] SymbolPrices CollectCachedPrices(const IndexEntry &entry) const;
+
+    [[nodiscard]] std::map<std::string, SymbolPrices> QueryPricesFromDB(const std::vector<std::string> &symbols,
+                                                                        std::string_view begin_date,
+                                                                        bool after_begin_date) const;
+
+    void AppendToLog(const std::map<std::string, SymbolPrices> &new_prices);
+    void AppendCheckedToLog(const std::vector<std::string> &symbols, int32_t checked_through_day);
+    void WriteCacheFile(const std::map<std::string, SymbolPrices> &replacements, int32_t replacements_coverage_day);
+
+    // ====================  DATA MEMBERS  =======================================
+
+    fs::path cache_directory_;
+    fs::path data_file_name_;
+    fs::path log_file_name_;
+
+    PF_DB::DB_Params db_params_;
+    std::string price_fld_name_;
+
+    MappedFile price_data_;
+    std::vector<IndexEntry> index_entries_;
+
+    // log records are few, so we just keep them in memory by symbol.
+
+    std::map<std::string, SymbolPrices, std::less<>> logged_prices_;
+    std::map<std::string, int32_t, std::less<>> logged_checked_through_;
+    size_t log_record_count_ = 0;
+
+}; // -----  end of class PF_PriceCache  -----
+
+#endif // ----- #ifndef _PF_PRICECACHE_INC_  -----
@@ -0,0 +1,221 @@
+// =====================================================================================
+//
+//       Filename:  PF_RunStats.cpp
+//
+//    Description:  Per-phase wall and CPU times, DB volumes and peak memory for
+//    batch (database) runs.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 07:15 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <format>
+#include <memory>
+#include <sstream>
+
+#include <spdlog/spdlog.h>
+
+#include "PF_RunStats.h"
+
+namespace
+{
+constexpr std::array<const char *, std::to_underlying(PF_RunStats::Phase::e_count)> kPhaseNames{
+    "list_exchanges", "fetch_prices", "retrieve_charts", "apply", "write", "stats_queries"};
+
+std::chrono::nanoseconds ProcessCPUTime()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+}
+
+double Seconds(std::chrono::nanoseconds d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+double Seconds(const timeval &tv)
+{
+    return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1'000'000.0;
+}
+
+double PerSecond(int64_t count, std::chrono::nanoseconds elapsed)
+{
+    return elapsed.count() > 0 ? static_cast<double>(count) / Seconds(elapsed) : 0.0;
+}
+
+// the counts and phase times common to the run totals and each exchange.
+
+Json::Value CountsToJSON(const PF_RunStats::Counts &counts)
+{
+    Json::Value result;
+    result["symbols"] = Json::Int64{counts.symbols_};
+    result["charts_scanned"] = Json::Int64{counts.charts_scanned_};
+    result["charts_updated"] = Json::Int64{counts.charts_updated_};
+    result["rows"] = Json::Int64{counts.rows_};
+    result["bytes_fetched"] = Json::Int64{counts.bytes_};
+
+    std::chrono::nanoseconds phase_wall{0};
+    Json::Value phases{Json::objectValue};
+    for (size_t i = 0; i < counts.phases_.size(); ++i)
+    {
+        const auto &times = counts.phases_[i];
+        if (times.calls_ == 0)
+        {
+            continue;
+        }
+        Json::Value phase;
+        phase["wall_seconds"] = Seconds(times.wall_);
+        phase["cpu_seconds"] = Seconds(times.cpu_);
+        phase["calls"] = Json::Int64{times.calls_};
+        phases[kPhaseNames[i]] = phase;
+        phase_wall += times.wall_;
+    }
+    result["phases"] = phases;
+    result["phase_wall_seconds"] = Seconds(phase_wall);
+
+    // rows per second of time spent getting them and applying them.
+
+    const auto &fetch = counts.phases_[std::to_underlying(PF_RunStats::Phase::e_fetch_prices)];
+    const auto &apply = counts.phases_[std::to_underlying(PF_RunStats::Phase::e_apply)];
+    result["rows_per_second"] = PerSecond(counts.rows_, fetch.wall_ + apply.wall_);
+    result["fetch_bytes_per_second"] = PerSecond(counts.bytes_, fetch.wall_);
+    return result;
+}
+} // namespace
+
+PF_RunStats::PhaseTimer::PhaseTimer(PF_RunStats *stats, Phase phase) : stats_{stats}, phase_{phase}
+{
+    if (stats_ != nullptr)
+    {
+        wall_start_ = std::chrono::steady_clock::now();
+        cpu_start_ = ProcessCPUTime();
+    }
+} // -----  end of method PF_RunStats::PhaseTimer::PhaseTimer  (constructor)  -----
+
+PF_RunStats::PhaseTimer::~PhaseTimer()
+{
+    if (stats_ != nullptr)
+    {
+        stats_->AddPhaseTime(phase_, std::chrono::steady_clock::now() - wall_start_, ProcessCPUTime() - cpu_start_);
+    }
+} // -----  end of method PF_RunStats::PhaseTimer::~PhaseTimer  (destructor)  -----
+
+PF_RunStats::PF_RunStats(std::string run_name)
+    : run_name_{std::move(run_name)}, started_at_{std::chrono::steady_clock::now()}, cpu_at_start_{ProcessCPUTime()}
+{
+} // -----  end of method PF_RunStats::PF_RunStats  (constructor)  -----
+
+void PF_RunStats::SetExchange(std::string_view exchange)
+{
+    if (exchange.empty())
+    {
+        current_exchange_ = nullptr;
+        return;
+    }
+    auto found = exchanges_.find(exchange);
+    if (found == exchanges_.end())
+    {
+        found = exchanges_.emplace(std::string{exchange}, Counts{}).first;
+    }
+    current_exchange_ = &found->second;
+} // -----  end of method PF_RunStats::SetExchange  -----
+
+void PF_RunStats::AddSymbols(int64_t symbols)
+{
+    ForCurrent([symbols](Counts &counts) { counts.symbols_ += symbols; });
+} // -----  end of method PF_RunStats::AddSymbols  -----
+
+void PF_RunStats::AddCharts(int64_t scanned, int64_t updated)
+{
+    ForCurrent([scanned, updated](Counts &counts) {
+        counts.charts_scanned_ += scanned;
+        counts.charts_updated_ += updated;
+    });
+} // -----  end of method PF_RunStats::AddCharts  -----
+
+void PF_RunStats::AddRows(int64_t rows, int64_t bytes)
+{
+    ForCurrent([rows, bytes](Counts &counts) {
+        counts.rows_ += rows;
+        counts.bytes_ += bytes;
+    });
+} // -----  end of method PF_RunStats::AddRows  -----
+
+void PF_RunStats::AddPhaseTime(Phase phase, std::chrono::nanoseconds wall, std::chrono::nanoseconds cpu)
+{
+    ForCurrent([phase, wall, cpu](Counts &counts) {
+        auto &times = counts.phases_[std::to_underlying(phase)];
+        times.wall_ += wall;
+        times.cpu_ += cpu;
+        ++times.calls_;
+    });
+} // -----  end of method PF_RunStats::AddPhaseTime  -----
+
+Json::Value PF_RunStats::ToJSON() const
+{
+    const auto wall = std::chrono::steady_clock::now() - started_at_;
+
+    Json::Value result = CountsToJSON(totals_);
+    result["run"] = run_name_;
+    result["wall_seconds"] = Seconds(wall);
+    result["cpu_seconds"] = Seconds(ProcessCPUTime() - cpu_at_start_);
+    result["overall_rows_per_second"] = PerSecond(totals_.rows_, wall);
+
+    // rusage covers the whole process, not just this run, but a batch run is the
+    // whole process.
+
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        result["user_cpu_seconds"] = Seconds(usage.ru_utime);
+        result["system_cpu_seconds"] = Seconds(usage.ru_stime);
+        result["peak_rss_kb"] = Json::Int64{usage.ru_maxrss};
+        result["major_page_faults"] = Json::Int64{usage.ru_majflt};
+    }
+
+    Json::Value exchanges{Json::objectValue};
+    for (const auto &[exchange, counts] : exchanges_)
+    {
+        exchanges[exchange] = CountsToJSON(counts);
+    }
+    result["exchanges"] = exchanges;
+
+    return result;
+} // -----  end of method PF_RunStats::ToJSON  -----
+
+void PF_RunStats::LogSummary() const
+{
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = ""; // compact printing and string formatting
+    std::unique_ptr<Json::StreamWriter> const writer(builder.newStreamWriter());
+    std::ostringstream summary;
+    writer->write(ToJSON(), &summary);
+
+    spdlog::info(std::format("Run stats: {}", summary.str()));
+} // -----  end of method PF_RunStats::LogSummary  -----
@@ -0,0 +1,162 @@
+// =====================================================================================
+//
+//       Filename:  PF_RunStats.h
+//
+//    Description:  Per-phase wall and CPU times, DB volumes and peak memory for
+//    batch (database) runs. Logged as a single JSON line at the end of the run.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 07:15 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _PF_RUNSTATS_INC_
+#define _PF_RUNSTATS_INC_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <json/json.h>
+
+// =====================================================================================
+//        Class:  PF_RunStats
+//  Description:  collects where a batch run spends its time so runs can be compared
+//  as the data grows.
+//
+//  Time is charged to a phase with a PhaseTimer. CPU time is for the whole process
+//  so a phase which hands work to other threads is charged for all of it.
+//  Everything recorded while an exchange is current is also added to that
+//  exchange's breakdown.
+//
+//  Not thread safe. Only the thread running the batch mode should use it.
+// =====================================================================================
+
+class PF_RunStats
+{
+public:
+    enum class Phase : int32_t
+    {
+        e_list_exchanges,  // exchanges and the symbols on them
+        e_fetch_prices,    // price queries (including ATR and range)
+        e_retrieve_charts, // existing charts from the charts DB
+        e_apply,           // add prices to charts
+        e_write,           // store charts in the DB and write output files
+        e_stats_queries,   // end of run summary queries
+        e_count
+    };
+
+    struct PhaseTimes
+    {
+        std::chrono::nanoseconds wall_{0};
+        std::chrono::nanoseconds cpu_{0};
+        int64_t calls_ = 0;
+    };
+
+    struct Counts
+    {
+        std::array<PhaseTimes, std::to_underlying(Phase::e_count)> phases_;
+        int64_t symbols_ = 0;
+        int64_t charts_scanned_ = 0;
+        int64_t charts_updated_ = 0;
+        int64_t rows_ = 0;
+        int64_t bytes_ = 0;
+    };
+
+    // =====================================================================================
+    //        Class:  PhaseTimer
+    //  Description:  charges its lifetime to a phase. A null stats pointer makes it a
+    //  no-op so callers don't need to check whether stats are being kept.
+    // =====================================================================================
+
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer(PF_RunStats *stats, Phase phase);
+
+        PhaseTimer(const PhaseTimer &rhs) = delete;
+        PhaseTimer(PhaseTimer &&rhs) = delete;
+
+        ~PhaseTimer();
+
+        PhaseTimer &operator=(const PhaseTimer &rhs) = delete;
+        PhaseTimer &operator=(PhaseTimer &&rhs) = delete;
+
+    private:
+        PF_RunStats *stats_;
+        Phase phase_;
+        std::chrono::steady_clock::time_point wall_start_;
+        std::chrono::nanoseconds cpu_start_{0};
+    }; // -----  end of class PhaseTimer  -----
+
+    // ====================  LIFECYCLE     =======================================
+
+    explicit PF_RunStats(std::string run_name);
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] Json::Value ToJSON() const;
+
+    void LogSummary() const;
+
+    // ====================  MUTATORS      =======================================
+
+    // an empty exchange means what follows isn't for any one exchange.
+
+    void SetExchange(std::string_view exchange);
+
+    void AddSymbols(int64_t symbols);
+    void AddCharts(int64_t scanned, int64_t updated);
+    void AddRows(int64_t rows, int64_t bytes);
+
+private:
+    void AddPhaseTime(Phase phase, std::chrono::nanoseconds wall, std::chrono::nanoseconds cpu);
+
+    template <typename Fn>
+    void ForCurrent(Fn &&fn)
+    {
+        fn(totals_);
+        if (current_exchange_ != nullptr)
+        {
+            fn(*current_exchange_);
+        }
+    }
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::string run_name_;
+    std::chrono::steady_clock::time_point started_at_;
+    std::chrono::nanoseconds cpu_at_start_{0};
+
+    Counts totals_;
+    std::map<std::string, Counts, std::less<>> exchanges_;
+    Counts *current_exchange_ = nullptr;
+
+}; // -----  end of class PF_RunStats  -----
+
+#endif // ----- #ifndef _PF_RUNSTATS_INC_  -----
@@ -0,0 +1,95 @@
+// =====================================================================================
+//
+//       Filename:  PF_SharedState.cpp
+//
+//    Description:  Creates and removes the shared memory segment holding live
+//    chart state.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 09:10 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <algorithm>
+#include <new>
+
+#include "PF_SharedState.h"
+
+PF_SharedStateWriter::PF_SharedStateWriter(std::string shm_name, const std::vector<SlotName> &slot_names)
+    : shm_name_{std::move(shm_name)}, mapping_size_{PF_SharedState_detail::SegmentSize(slot_names.size())}
+{
+    // a segment left by a run which didn't finish cleanly is replaced. Readers still
+    // attached to it keep the old one.
+
+    shm_unlink(shm_name_.c_str());
+    const int fd = shm_open(shm_name_.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "Unable to create shared chart state: " + shm_name_);
+    }
+    if (ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0)
+    {
+        const int save_errno = errno;
+        close(fd);
+        shm_unlink(shm_name_.c_str());
+        throw std::system_error(save_errno, std::generic_category(), "Unable to size shared chart state: " + shm_name_);
+    }
+    void *mapping = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int save_errno = errno;
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        shm_unlink(shm_name_.c_str());
+        throw std::system_error(save_errno, std::generic_category(), "Unable to map shared chart state: " + shm_name_);
+    }
+
+    // the new segment is all zeros. Construct our objects in it.
+
+    header_ = new (mapping) PF_SharedStateHeader{};
+    header_->version_ = kPF_SharedStateVersion;
+    header_->slot_size_ = sizeof(PF_SharedChartSlot);
+    header_->slot_count_ = static_cast<uint32_t>(slot_names.size());
+
+    slots_ = reinterpret_cast<PF_SharedChartSlot *>(static_cast<std::byte *>(mapping) + sizeof(PF_SharedStateHeader));
+    for (size_t i = 0; i < slot_names.size(); ++i)
+    {
+        auto *slot = new (&slots_[i]) PF_SharedChartSlot{};
+        slot->sequence_.store(0, std::memory_order_relaxed);
+        slot->state_ = PF_SharedChartState{};
+
+        // names are truncated if need be but always end with a 0.
+
+        slot_names[i].symbol_.copy(slot->symbol_, sizeof(slot->symbol_) - 1);
+        slot_names[i].chart_name_.copy(slot->chart_name_, sizeof(slot->chart_name_) - 1);
+    }
+
+    header_->magic_.store(kPF_SharedStateMagic, std::memory_order_release);
+} // -----  end of method PF_SharedStateWriter::PF_SharedStateWriter  (constructor)  -----
+
+PF_SharedStateWriter::~PF_SharedStateWriter()
+{
+    header_->writer_finished_.store(1, std::memory_order_release);
+    munmap(header_, mapping_size_);
+    shm_unlink(shm_name_.c_str());
+} // -----  end of method PF_SharedStateWriter::~PF_SharedStateWriter  (destructor)  -----
@@ -0,0 +1,345 @@
+// =====================================================================================
+//
+//       Filename:  PF_SharedState.h
+//
+//    Description:  Layout of the shared memory segment holding live chart state
+//    and the reader other processes use to poll it.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 09:10 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+// Readers need only this header (and -lrt on older glibc). It doesn't depend on
+// anything else in PF_CollectData.
+//
+//      PF_SharedStateReader reader{"/PF_CollectData"};
+//      const auto slot = reader.Find("AAPL_0.1X3_linear").value();
+//      PF_SharedChartState state;
+//      uint64_t sequence = 0;
+//      if (reader.TryRead(slot, state, sequence)) { ... }
+//
+// Each chart has a slot guarded by a sequence lock. Its writer makes the sequence
+// odd, writes the state and makes it even again, so a reader which sees the same
+// even sequence before and after copying the state has a consistent copy. Readers
+// never write to the segment so any number of them can poll without slowing the
+// writer or each other. TryRead() is a single attempt and never waits.
+//
+// Each slot has exactly 1 writer (the processor thread for its symbol).
+
+#ifndef _PF_SHAREDSTATE_INC_
+#define _PF_SHAREDSTATE_INC_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+constexpr uint64_t kPF_SharedStateMagic = 0x5046'5f53'5441'5445; // "PF_STATE"
+constexpr uint32_t kPF_SharedStateVersion = 1;
+
+// the seqlock protected part of a slot. Everything is 8 bytes wide so it can be
+// copied a word at a time.
+// Times are nanoseconds since the std::chrono::utc_clock epoch. Enum values are
+// those of PF_Column::Direction, PF_SignalType and PF_SignalCategory. A chart
+// without a signal has a last_signal_type_ of 0.
+
+struct PF_SharedChartState
+{
+    int64_t column_number_ = -1;
+    int64_t direction_ = 0;
+    double column_top_ = 0.0;
+    double column_bottom_ = 0.0;
+    double latest_price_ = 0.0;
+    int64_t latest_tick_time_ns_ = 0;
+    int64_t last_signal_type_ = 0;
+    int64_t last_signal_category_ = 0;
+    double last_signal_price_ = 0.0;
+    int64_t last_signal_time_ns_ = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<PF_SharedChartState>);
+static_assert(sizeof(PF_SharedChartState) % sizeof(uint64_t) == 0);
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "sequence locks in shared memory must be lock free.");
+
+// a slot is a whole number of cache lines so writers of neighbouring slots don't
+// interfere. Names are set before the segment is marked ready and never change.
+
+struct alignas(64) PF_SharedChartSlot
+{
+    char symbol_[16];
+    char chart_name_[64];
+    std::atomic<uint64_t> sequence_; // odd while being written. Divided by 2, the number of updates.
+    PF_SharedChartState state_;
+};
+
+struct alignas(64) PF_SharedStateHeader
+{
+    std::atomic<uint64_t> magic_; // set last, once everything else is in place
+    uint32_t version_;
+    uint32_t slot_size_;
+    uint32_t slot_count_;
+    uint32_t unused_;
+    std::atomic<uint64_t> writer_finished_; // 1 when streaming has ended
+};
+
+namespace PF_SharedState_detail
+{
+inline void CopyOut(const PF_SharedChartState &from, PF_SharedChartState &to)
+{
+    auto *source = const_cast<uint64_t *>(reinterpret_cast<const uint64_t *>(&from));
+    auto *destination = reinterpret_cast<uint64_t *>(&to);
+    for (size_t i = 0; i < sizeof(PF_SharedChartState) / sizeof(uint64_t); ++i)
+    {
+        destination[i] = std::atomic_ref<uint64_t>{source[i]}.load(std::memory_order_relaxed);
+    }
+}
+
+inline void CopyIn(const PF_SharedChartState &from, PF_SharedChartState &to)
+{
+    const auto *source = reinterpret_cast<const uint64_t *>(&from);
+    auto *destination = reinterpret_cast<uint64_t *>(&to);
+    for (size_t i = 0; i < sizeof(PF_SharedChartState) / sizeof(uint64_t); ++i)
+    {
+        std::atomic_ref<uint64_t>{destination[i]}.store(source[i], std::memory_order_relaxed);
+    }
+}
+
+inline size_t SegmentSize(size_t slot_count)
+{
+    return sizeof(PF_SharedStateHeader) + slot_count * sizeof(PF_SharedChartSlot);
+}
+} // namespace PF_SharedState_detail
+
+// =====================================================================================
+//        Class:  PF_SharedStateReader
+//  Description:  maps a segment read-only. Throws if it doesn't exist or isn't
+//  ready yet.
+// =====================================================================================
+
+class PF_SharedStateReader
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    explicit PF_SharedStateReader(const std::string &shm_name)
+    {
+        const int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Unable to open shared chart state: " + shm_name);
+        }
+        struct stat file_info{};
+        if (fstat(fd, &file_info) != 0 || static_cast<size_t>(file_info.st_size) < sizeof(PF_SharedStateHeader))
+        {
+            close(fd);
+            throw std::system_error(EINVAL, std::generic_category(), "Shared chart state is not ready: " + shm_name);
+        }
+        mapping_size_ = static_cast<size_t>(file_info.st_size);
+        void *mapping = mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED, fd, 0);
+        const int save_errno = errno;
+        close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw std::system_error(save_errno, std::generic_category(),
+                                    "Unable to map shared chart state: " + shm_name);
+        }
+        header_ = static_cast<const PF_SharedStateHeader *>(mapping);
+        slots_ = reinterpret_cast<const PF_SharedChartSlot *>(static_cast<const std::byte *>(mapping) +
+                                                              sizeof(PF_SharedStateHeader));
+
+        if (header_->magic_.load(std::memory_order_acquire) != kPF_SharedStateMagic ||
+            header_->version_ != kPF_SharedStateVersion || header_->slot_size_ != sizeof(PF_SharedChartSlot) ||
+            PF_SharedState_detail::SegmentSize(header_->slot_count_) > mapping_size_)
+        {
+            munmap(mapping, mapping_size_);
+            throw std::system_error(EINVAL, std::generic_category(),
+                                    "Shared chart state is not ready or is from a different version: " + shm_name);
+        }
+    }
+
+    PF_SharedStateReader(const PF_SharedStateReader &rhs) = delete;
+    PF_SharedStateReader(PF_SharedStateReader &&rhs) = delete;
+
+    ~PF_SharedStateReader()
+    {
+        munmap(const_cast<PF_SharedStateHeader *>(header_), mapping_size_);
+    }
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] size_t size() const
+    {
+        return header_->slot_count_;
+    }
+    [[nodiscard]] std::string_view Symbol(size_t slot) const
+    {
+        return {slots_[slot].symbol_, strnlen(slots_[slot].symbol_, sizeof(slots_[slot].symbol_))};
+    }
+    [[nodiscard]] std::string_view ChartName(size_t slot) const
+    {
+        return {slots_[slot].chart_name_, strnlen(slots_[slot].chart_name_, sizeof(slots_[slot].chart_name_))};
+    }
+
+    // look slots up once, then poll them by index.
+
+    [[nodiscard]] std::optional<size_t> Find(std::string_view chart_name) const
+    {
+        for (size_t slot = 0; slot < size(); ++slot)
+        {
+            if (ChartName(slot) == chart_name)
+            {
+                return slot;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // cheap check for a change since the last read.
+
+    [[nodiscard]] uint64_t Sequence(size_t slot) const
+    {
+        return slots_[slot].sequence_.load(std::memory_order_acquire);
+    }
+
+    // one attempt. False means the writer was busy with this slot and nothing
+    // useful was copied.
+
+    [[nodiscard]] bool TryRead(size_t slot, PF_SharedChartState &state, uint64_t &sequence) const
+    {
+        const auto &the_slot = slots_[slot];
+        const uint64_t before = the_slot.sequence_.load(std::memory_order_acquire);
+        if ((before & 1) != 0)
+        {
+            return false;
+        }
+        PF_SharedState_detail::CopyOut(the_slot.state_, state);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (the_slot.sequence_.load(std::memory_order_relaxed) != before)
+        {
+            return false;
+        }
+        sequence = before;
+        return true;
+    }
+
+    // tries until it gets a consistent copy. A write takes nanoseconds so this
+    // rarely tries more than twice.
+
+    [[nodiscard]] PF_SharedChartState Read(size_t slot) const
+    {
+        PF_SharedChartState state;
+        uint64_t sequence = 0;
+        while (!TryRead(slot, state, sequence))
+        {
+        }
+        return state;
+    }
+
+    [[nodiscard]] bool WriterFinished() const
+    {
+        return header_->writer_finished_.load(std::memory_order_acquire) != 0;
+    }
+
+    // ====================  OPERATORS     =======================================
+
+    PF_SharedStateReader &operator=(const PF_SharedStateReader &rhs) = delete;
+    PF_SharedStateReader &operator=(PF_SharedStateReader &&rhs) = delete;
+
+private:
+    // ====================  DATA MEMBERS  =======================================
+
+    const PF_SharedStateHeader *header_ = nullptr;
+    const PF_SharedChartSlot *slots_ = nullptr;
+    size_t mapping_size_ = 0;
+
+}; // -----  end of class PF_SharedStateReader  -----
+
+// =====================================================================================
+//        Class:  PF_SharedStateWriter
+//  Description:  creates the segment, replacing one left by an earlier run, and
+//  removes it again when destroyed. Readers which already have it mapped keep
+//  their copy and see WriterFinished().
+// =====================================================================================
+
+class PF_SharedStateWriter
+{
+public:
+    struct SlotName
+    {
+        std::string symbol_;
+        std::string chart_name_;
+    };
+
+    // ====================  LIFECYCLE     =======================================
+
+    PF_SharedStateWriter(std::string shm_name, const std::vector<SlotName> &slot_names);
+
+    PF_SharedStateWriter(const PF_SharedStateWriter &rhs) = delete;
+    PF_SharedStateWriter(PF_SharedStateWriter &&rhs) = delete;
+
+    ~PF_SharedStateWriter();
+
+    // ====================  MUTATORS      =======================================
+
+    // only the one thread which owns a slot may publish to it.
+
+    void Publish(size_t slot, const PF_SharedChartState &state)
+    {
+        auto &the_slot = slots_[slot];
+        const uint64_t sequence = the_slot.sequence_.load(std::memory_order_relaxed);
+        the_slot.sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        PF_SharedState_detail::CopyIn(state, the_slot.state_);
+        the_slot.sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // ====================  OPERATORS     =======================================
+
+    PF_SharedStateWriter &operator=(const PF_SharedStateWriter &rhs) = delete;
+    PF_SharedStateWriter &operator=(PF_SharedStateWriter &&rhs) = delete;
+
+private:
+    // ====================  DATA MEMBERS  =======================================
+
+    std::string shm_name_;
+    PF_SharedStateHeader *header_ = nullptr;
+    PF_SharedChartSlot *slots_ = nullptr;
+    size_t mapping_size_ = 0;
+
+}; // -----  end of class PF_SharedStateWriter  -----
+
+#endif // ----- #ifndef _PF_SHAREDSTATE_INC_  -----
@@ -0,0 +1,245 @@
+// =====================================================================================
+//
+//       Filename:  PF_ShmStress.cpp
+//
+//    Description:  Stress test for the shared memory chart state. Writer threads
+//    update every slot as fast as they can while reader processes check that
+//    every copy they get is consistent.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 09:10 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+// Every state written is derived from its update number, which is also the slot's
+// sequence / 2. A reader can therefore tell a torn copy (fields from 2 different
+// updates) or a copy which doesn't match its sequence. Either one is a failure
+// and the exit status is non-zero.
+//
+//      ./PF_ShmStress --slots 2000 --writers 16 --readers 8 --seconds 30
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "PF_SharedState.h"
+
+namespace po = boost::program_options;
+
+namespace
+{
+PF_SharedChartState MakeState(int64_t update)
+{
+    return PF_SharedChartState{.column_number_ = update,
+                               .direction_ = update % 3,
+                               .column_top_ = static_cast<double>(update) * 2.0,
+                               .column_bottom_ = static_cast<double>(update),
+                               .latest_price_ = static_cast<double>(update) + 0.25,
+                               .latest_tick_time_ns_ = update * 1'000,
+                               .last_signal_type_ = update % 11,
+                               .last_signal_category_ = update % 2,
+                               .last_signal_price_ = static_cast<double>(update) + 0.5,
+                               .last_signal_time_ns_ = update * 1'000 + 1};
+}
+
+bool IsConsistent(const PF_SharedChartState &state, uint64_t sequence)
+{
+    // nothing has been written to a slot with a sequence of 0.
+
+    const auto expected = sequence == 0 ? PF_SharedChartState{} : MakeState(static_cast<int64_t>(sequence / 2));
+    return std::memcmp(&state, &expected, sizeof(PF_SharedChartState)) == 0;
+}
+
+// runs in a child process. Polls every slot until the writer is done.
+
+int RunReader(const std::string &shm_name, int32_t reader_id)
+{
+    const PF_SharedStateReader reader{shm_name};
+
+    std::vector<uint64_t> last_sequence(reader.size(), 0);
+    int64_t reads = 0;
+    int64_t busy = 0;
+    int64_t changed = 0;
+    int64_t bad = 0;
+
+    const auto started_at = std::chrono::steady_clock::now();
+    while (!reader.WriterFinished())
+    {
+        for (size_t slot = 0; slot < reader.size(); ++slot)
+        {
+            PF_SharedChartState state;
+            uint64_t sequence = 0;
+            if (!reader.TryRead(slot, state, sequence))
+            {
+                ++busy;
+                continue;
+            }
+            ++reads;
+            if (!IsConsistent(state, sequence) || sequence < last_sequence[slot])
+            {
+                ++bad;
+            }
+            changed += sequence != last_sequence[slot] ? 1 : 0;
+            last_sequence[slot] = sequence;
+        }
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+
+    std::cout << std::format("reader {}: {} reads ({:.0f}/sec), {} saw a change, {} writer busy, {} BAD.\n", reader_id,
+                             reads, static_cast<double>(reads) / elapsed, changed, busy, bad);
+    return bad == 0 ? 0 : 2;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string shm_name;
+    int32_t slot_count = 0;
+    int32_t writer_count = 0;
+    int32_t reader_count = 0;
+    int32_t seconds = 0;
+
+    // clang-format off
+    po::options_description desc{"PF_ShmStress options"};
+    desc.add_options()
+        ("help,h",              "produce help message")
+        ("shm-name",            po::value<std::string>(&shm_name)->default_value("/PF_ShmStress"), "shared memory segment to use. Default is '/PF_ShmStress'.")
+        ("slots",               po::value<int32_t>(&slot_count)->default_value(512), "number of chart slots. Default is 512.")
+        ("writers",             po::value<int32_t>(&writer_count)->default_value(8), "writer threads. Each owns every Nth slot. Default is 8.")
+        ("readers",             po::value<int32_t>(&reader_count)->default_value(4), "reader processes. Default is 4.")
+        ("seconds",             po::value<int32_t>(&seconds)->default_value(10), "how long to run. Default is 10.")
+        ;
+    // clang-format on
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+        if (vm.contains("help"))
+        {
+            std::cout << desc << '\n';
+            return 0;
+        }
+        if (slot_count <= 0 || writer_count <= 0 || reader_count <= 0 || seconds <= 0)
+        {
+            std::cerr << "slots, writers, readers and seconds must be > 0.\n";
+            return 1;
+        }
+
+        std::vector<PF_SharedStateWriter::SlotName> slot_names;
+        for (int32_t i = 0; i < slot_count; ++i)
+        {
+            slot_names.push_back({.symbol_ = std::format("SYM{}", i), .chart_name_ = std::format("SYM{}_1X3", i)});
+        }
+        auto writer = std::make_unique<PF_SharedStateWriter>(shm_name, slot_names);
+
+        // readers are started before any threads so fork() is safe.
+
+        std::vector<pid_t> readers;
+        for (int32_t i = 0; i < reader_count; ++i)
+        {
+            const pid_t pid = fork();
+            if (pid == 0)
+            {
+                int status = 1;
+                try
+                {
+                    status = RunReader(shm_name, i);
+                }
+                catch (const std::exception &e)
+                {
+                    std::cerr << std::format("reader {}: {}\n", i, e.what());
+                }
+                std::cout.flush();
+                _exit(status);
+            }
+            if (pid < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "Unable to start reader process");
+            }
+            readers.push_back(pid);
+        }
+
+        std::atomic<bool> stop = false;
+        std::atomic<int64_t> total_updates = 0;
+        std::vector<std::thread> writers;
+        for (int32_t w = 0; w < writer_count; ++w)
+        {
+            writers.emplace_back([&, w] {
+                std::vector<int64_t> updates(slot_count, 0);
+                int64_t count = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    for (int32_t slot = w; slot < slot_count; slot += writer_count)
+                    {
+                        writer->Publish(slot, MakeState(++updates[slot]));
+                        ++count;
+                    }
+                }
+                total_updates += count;
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds{seconds});
+        stop = true;
+        for (auto &thread : writers)
+        {
+            thread.join();
+        }
+        writer.reset();
+
+        int32_t failed_readers = 0;
+        for (const pid_t pid : readers)
+        {
+            int status = 0;
+            waitpid(pid, &status, 0);
+            failed_readers += WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+        }
+
+        std::cout << std::format("{} updates ({:.0f}/sec) to {} slots by {} writers. {} of {} readers failed.\n",
+                                 total_updates.load(), static_cast<double>(total_updates.load()) / seconds, slot_count,
+                                 writer_count, failed_readers, reader_count);
+        return failed_readers == 0 ? 0 : 2;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "PF_ShmStress: " << e.what() << '\n';
+        return 1;
+    }
+}
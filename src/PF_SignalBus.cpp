@@ -0,0 +1,358 @@
+// =====================================================================================
+//
+//       Filename:  PF_SignalBus.cpp
+//
+//    Description:  Hands new signals to any number of subscribers (sinks) as soon
+//    as they are found without making the streaming threads wait for them.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 09:45 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <system_error>
+#include <utility>
+
+#include <boost/assert.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include "PF_SignalBus.h"
+#include "PF_StreamingMetrics.h"
+#include "PF_Trace.h"
+
+namespace
+{
+constexpr char kJournalMagic[8] = {'P', 'F', '_', 'S', 'I', 'G', 'N', 'L'};
+constexpr uint32_t kJournalVersion = 1;
+
+struct JournalHeader
+{
+    char magic_[8];
+    uint32_t version_;
+    uint32_t record_size_;
+};
+
+int64_t SteadyNs(std::chrono::steady_clock::time_point when)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+}
+
+// the event is copied a word at a time so a reader racing with a writer
+// gets a torn copy, which it throws away, rather than undefined behaviour.
+
+void CopyEventIn(const PF_SignalEvent &from, PF_SignalEvent &to)
+{
+    const auto *source = reinterpret_cast<const uint64_t *>(&from);
+    auto *destination = reinterpret_cast<uint64_t *>(&to);
+    for (size_t i = 0; i < sizeof(PF_SignalEvent) / sizeof(uint64_t); ++i)
+    {
+        std::atomic_ref<uint64_t>{destination[i]}.store(source[i], std::memory_order_relaxed);
+    }
+}
+
+void CopyEventOut(const PF_SignalEvent &from, PF_SignalEvent &to)
+{
+    auto *source = const_cast<uint64_t *>(reinterpret_cast<const uint64_t *>(&from));
+    auto *destination = reinterpret_cast<uint64_t *>(&to);
+    for (size_t i = 0; i < sizeof(PF_SignalEvent) / sizeof(uint64_t); ++i)
+    {
+        destination[i] = std::atomic_ref<uint64_t>{source[i]}.load(std::memory_order_relaxed);
+    }
+}
+} // namespace
+
+PF_SignalEvent MakeSignalEvent(const PF_Chart &chart, const PF_Signal &signal,
+                               std::chrono::steady_clock::time_point received_at)
+{
+    PF_SignalEvent event{};
+
+    // names are truncated if need be but always end with a 0.
+
+    chart.GetSymbol().copy(event.symbol_, sizeof(event.symbol_) - 1);
+    chart.GetChartBaseName().copy(event.chart_name_, sizeof(event.chart_name_) - 1);
+    event.box_size_ = dec2dbl(chart.GetFNameBoxSize());
+    event.reversal_boxes_ = chart.GetReversalboxes();
+    event.box_scale_ = std::to_underlying(chart.GetBoxScale());
+    event.signal_type_ = std::to_underlying(signal.signal_type_);
+    event.signal_category_ = std::to_underlying(signal.signal_category_);
+    event.priority_ = std::to_underlying(signal.priority_);
+    event.column_number_ = signal.column_number_;
+    event.signal_price_ = dec2dbl(signal.signal_price_);
+    event.box_ = dec2dbl(signal.box_);
+    event.signal_time_ns_ =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(signal.tpt_.time_since_epoch()).count();
+    event.received_at_ns_ = SteadyNs(received_at);
+    event.detected_at_ns_ = SteadyNs(std::chrono::steady_clock::now());
+    return event;
+} // -----  end of function MakeSignalEvent  -----
+
+// ===================  PF_SignalJournalSink  =============================
+
+PF_SignalJournalSink::PF_SignalJournalSink(const fs::path &journal_path) : journal_path_{journal_path}
+{
+    fd_ = ::open(journal_path_.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Unable to open signal journal: " + journal_path_.string());
+    }
+
+    JournalHeader header{};
+    std::memcpy(header.magic_, kJournalMagic, sizeof(header.magic_));
+    header.version_ = kJournalVersion;
+    header.record_size_ = sizeof(PF_SignalEvent);
+
+    if (::lseek(fd_, 0, SEEK_END) == 0)
+    {
+        if (::write(fd_, &header, sizeof(header)) != sizeof(header))
+        {
+            const int save_errno = errno;
+            ::close(fd_);
+            throw std::system_error(save_errno, std::generic_category(),
+                                    "Unable to write signal journal header: " + journal_path_.string());
+        }
+        return;
+    }
+
+    JournalHeader existing{};
+    if (::pread(fd_, &existing, sizeof(existing), 0) != sizeof(existing) ||
+        std::memcmp(&existing, &header, sizeof(header)) != 0)
+    {
+        ::close(fd_);
+        throw std::runtime_error(
+            std::format("Signal journal: {} has a different layout. Use a new file.", journal_path_));
+    }
+} // -----  end of method PF_SignalJournalSink::PF_SignalJournalSink  (constructor)  -----
+
+PF_SignalJournalSink::~PF_SignalJournalSink()
+{
+    ::fdatasync(fd_);
+    ::close(fd_);
+} // -----  end of method PF_SignalJournalSink::~PF_SignalJournalSink  (destructor)  -----
+
+std::string PF_SignalJournalSink::Name() const
+{
+    return std::format("journal:{}", journal_path_);
+} // -----  end of method PF_SignalJournalSink::Name  -----
+
+bool PF_SignalJournalSink::Consume(const PF_SignalEvent &event)
+{
+    // O_APPEND and one write per record so a record is never split by another writer.
+    // It reaches the page cache now and the disk when the OS gets to it (or at close).
+
+    return ::write(fd_, &event, sizeof(event)) == sizeof(event);
+} // -----  end of method PF_SignalJournalSink::Consume  -----
+
+// ===================  PF_SignalDatagramSink  ============================
+
+PF_SignalDatagramSink::PF_SignalDatagramSink(const fs::path &socket_path) : socket_path_{socket_path}
+{
+    sockaddr_un address{};
+    if (socket_path_.native().size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error(std::format("Signal socket path: {} is too long.", socket_path_));
+    }
+    fd_ = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "Unable to create signal datagram socket");
+    }
+} // -----  end of method PF_SignalDatagramSink::PF_SignalDatagramSink  (constructor)  -----
+
+PF_SignalDatagramSink::~PF_SignalDatagramSink()
+{
+    ::close(fd_);
+} // -----  end of method PF_SignalDatagramSink::~PF_SignalDatagramSink  (destructor)  -----
+
+std::string PF_SignalDatagramSink::Name() const
+{
+    return std::format("datagram:{}", socket_path_);
+} // -----  end of method PF_SignalDatagramSink::Name  -----
+
+bool PF_SignalDatagramSink::Consume(const PF_SignalEvent &event)
+{
+    // the subscriber may come and go so we look it up by name every time.
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    socket_path_.native().copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+    return ::sendto(fd_, &event, sizeof(event), MSG_DONTWAIT, reinterpret_cast<const sockaddr *>(&address),
+                    sizeof(address)) == sizeof(event);
+} // -----  end of method PF_SignalDatagramSink::Consume  -----
+
+// ===================  PF_SignalBus  =====================================
+
+PF_SignalBus::PF_SignalBus(size_t capacity, PF_StreamingMetrics *metrics)
+    : capacity_{std::bit_ceil(std::max(capacity, size_t{2}))}, mask_{capacity_ - 1}, metrics_{metrics}
+{
+    ring_ = std::make_unique<Slot[]>(capacity_);
+} // -----  end of method PF_SignalBus::PF_SignalBus  (constructor)  -----
+
+PF_SignalBus::~PF_SignalBus()
+{
+    Stop();
+} // -----  end of method PF_SignalBus::~PF_SignalBus  (destructor)  -----
+
+void PF_SignalBus::AddSink(std::unique_ptr<PF_SignalSink> sink)
+{
+    BOOST_ASSERT_MSG(subscribers_.empty() || !subscribers_.front()->thread_.joinable(),
+                     "Sinks must be added before the signal bus is started.");
+    auto subscriber = std::make_unique<Subscriber>();
+    subscriber->sink_ = std::move(sink);
+    subscribers_.push_back(std::move(subscriber));
+} // -----  end of method PF_SignalBus::AddSink  -----
+
+void PF_SignalBus::Start()
+{
+    stopping_ = false;
+    for (auto &subscriber : subscribers_)
+    {
+        subscriber->thread_ = std::thread{&PF_SignalBus::DeliverTo, this, std::ref(*subscriber)};
+        spdlog::info(std::format("Sending new signals to: {}", subscriber->sink_->Name()));
+    }
+} // -----  end of method PF_SignalBus::Start  -----
+
+void PF_SignalBus::Stop()
+{
+    if (subscribers_.empty() || !subscribers_.front()->thread_.joinable())
+    {
+        return;
+    }
+    stopping_ = true;
+    published_.fetch_add(1, std::memory_order_release);
+    published_.notify_all();
+
+    for (auto &subscriber : subscribers_)
+    {
+        subscriber->thread_.join();
+        spdlog::info(std::format("Signals for: {}. Published: {}. Delivered: {}. Failed: {}. Dropped: {}.",
+                                 subscriber->sink_->Name(), next_sequence_.load(), subscriber->delivered_,
+                                 subscriber->failed_, subscriber->dropped_));
+    }
+} // -----  end of method PF_SignalBus::Stop  -----
+
+void PF_SignalBus::Publish(PF_SignalEvent event)
+{
+    const uint64_t sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+    event.sequence_ = sequence;
+    event.published_at_ns_ = SteadyNs(std::chrono::steady_clock::now());
+
+    auto &slot = ring_[sequence & mask_];
+    slot.stamp_.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    CopyEventIn(event, slot.event_);
+    slot.stamp_.store(2 * sequence + 2, std::memory_order_release);
+
+    // only a system call if a sink is actually asleep.
+
+    published_.fetch_add(1, std::memory_order_release);
+    published_.notify_all();
+} // -----  end of method PF_SignalBus::Publish  -----
+
+PF_SignalBus::TakeResult PF_SignalBus::Take(uint64_t sequence, PF_SignalEvent &event) const
+{
+    const auto &slot = ring_[sequence & mask_];
+    const uint64_t wanted = 2 * sequence + 2;
+
+    const uint64_t before = slot.stamp_.load(std::memory_order_acquire);
+    if (before < wanted)
+    {
+        return TakeResult::e_not_yet;
+    }
+    if (before > wanted)
+    {
+        return TakeResult::e_overwritten;
+    }
+    CopyEventOut(slot.event_, event);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.stamp_.load(std::memory_order_relaxed) == wanted ? TakeResult::e_taken : TakeResult::e_overwritten;
+} // -----  end of method PF_SignalBus::Take  -----
+
+void PF_SignalBus::DeliverTo(Subscriber &subscriber)
+{
+    PF_TRACE_THREAD_NAME("signal sink");
+
+    uint64_t next = next_sequence_.load(std::memory_order_acquire);
+    PF_SignalEvent event;
+    while (true)
+    {
+        const uint64_t seen = published_.load(std::memory_order_acquire);
+
+        while (true)
+        {
+            const auto result = Take(next, event);
+            if (result == TakeResult::e_not_yet)
+            {
+                break;
+            }
+            if (result == TakeResult::e_overwritten)
+            {
+                // we are more than a whole ring behind. Skip to the oldest event still there.
+
+                const uint64_t oldest = next_sequence_.load(std::memory_order_acquire) - capacity_;
+                const uint64_t resume_at = std::max(next + 1, oldest);
+                subscriber.dropped_ += static_cast<int64_t>(resume_at - next);
+                next = resume_at;
+                continue;
+            }
+            ++next;
+            if (subscriber.sink_->Consume(event))
+            {
+                ++subscriber.delivered_;
+            }
+            else
+            {
+                ++subscriber.failed_;
+            }
+            if (metrics_ != nullptr)
+            {
+                const auto now = SteadyNs(std::chrono::steady_clock::now());
+                metrics_->Record(PF_StreamingMetrics::Stage::e_signal_to_sink,
+                                 std::chrono::nanoseconds{now - event.detected_at_ns_});
+                metrics_->Record(PF_StreamingMetrics::Stage::e_tick_to_sink,
+                                 std::chrono::nanoseconds{now - event.received_at_ns_});
+            }
+        }
+
+        // publishers are done before we are stopped so once we've caught up, we're finished.
+
+        if (stopping_.load(std::memory_order_acquire) && next >= next_sequence_.load(std::memory_order_acquire))
+        {
+            break;
+        }
+        published_.wait(seen, std::memory_order_acquire);
+    }
+} // -----  end of method PF_SignalBus::DeliverTo  -----
@@ -0,0 +1,263 @@
+// =====================================================================================
+//
+//       Filename:  PF_SignalBus.h
+//
+//    Description:  Hands new signals to any number of subscribers (sinks) as soon
+//    as they are found without making the streaming threads wait for them.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 09:45 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _PF_SIGNALBUS_INC_
+#define _PF_SIGNALBUS_INC_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "PF_Chart.h"
+#include "PF_Signals.h"
+
+namespace fs = std::filesystem;
+
+class PF_StreamingMetrics;
+
+// one new signal. This exact layout is what the journal and datagram sinks send
+// so it is fixed size with no pointers.
+// Enum values are those of BoxScale, PF_SignalType, PF_SignalCategory and
+// PF_SignalPriority. signal_time_ns_ is since the std::chrono::utc_clock epoch. The
+// other times are steady_clock (CLOCK_MONOTONIC) nanoseconds so a process on the
+// same machine can compare them with its own clock to get the delivery latency.
+
+struct PF_SignalEvent
+{
+    char symbol_[16];
+    char chart_name_[64];
+    double box_size_;
+    int32_t reversal_boxes_;
+    int32_t box_scale_;
+    int32_t signal_type_;
+    int32_t signal_category_;
+    int32_t priority_;
+    int32_t column_number_;
+    double signal_price_;
+    double box_;
+    int64_t signal_time_ns_;
+    int64_t received_at_ns_; // the tick which made the signal arrived
+    int64_t detected_at_ns_; // the chart found the signal
+    int64_t published_at_ns_;
+    uint64_t sequence_; // counts up from 0 for each run
+};
+
+static_assert(std::is_trivially_copyable_v<PF_SignalEvent>);
+static_assert(sizeof(PF_SignalEvent) % sizeof(uint64_t) == 0);
+
+[[nodiscard]] PF_SignalEvent MakeSignalEvent(const PF_Chart &chart, const PF_Signal &signal,
+                                             std::chrono::steady_clock::time_point received_at);
+
+// =====================================================================================
+//        Class:  PF_SignalSink
+//  Description:  somewhere signals go. Each sink gets its own thread so a slow
+//  one only delays itself.
+// =====================================================================================
+
+class PF_SignalSink
+{
+public:
+    virtual ~PF_SignalSink() = default;
+
+    [[nodiscard]] virtual std::string Name() const = 0;
+
+    // false means this event couldn't be delivered (and is counted as such).
+
+    virtual bool Consume(const PF_SignalEvent &event) = 0;
+};
+
+// appends each event to a file after a 16 byte header: 'PF_SIGNL', the version
+// and sizeof(PF_SignalEvent) as 4 byte integers. An existing journal is added to
+// if it has the same layout.
+
+class PF_SignalJournalSink : public PF_SignalSink
+{
+public:
+    explicit PF_SignalJournalSink(const fs::path &journal_path);
+    ~PF_SignalJournalSink() override;
+
+    PF_SignalJournalSink(const PF_SignalJournalSink &rhs) = delete;
+    PF_SignalJournalSink &operator=(const PF_SignalJournalSink &rhs) = delete;
+
+    [[nodiscard]] std::string Name() const override;
+    bool Consume(const PF_SignalEvent &event) override;
+
+private:
+    fs::path journal_path_;
+    int fd_ = -1;
+};
+
+// sends each event as one datagram to a Unix datagram socket some other process
+// has bound. Never blocks: if nobody is listening or their buffer is full, the
+// event is dropped for that subscriber.
+
+class PF_SignalDatagramSink : public PF_SignalSink
+{
+public:
+    explicit PF_SignalDatagramSink(const fs::path &socket_path);
+    ~PF_SignalDatagramSink() override;
+
+    PF_SignalDatagramSink(const PF_SignalDatagramSink &rhs) = delete;
+    PF_SignalDatagramSink &operator=(const PF_SignalDatagramSink &rhs) = delete;
+
+    [[nodiscard]] std::string Name() const override;
+    bool Consume(const PF_SignalEvent &event) override;
+
+private:
+    fs::path socket_path_;
+    int fd_ = -1;
+};
+
+// for code in this process.
+
+class PF_SignalCallbackSink : public PF_SignalSink
+{
+public:
+    using Callback = std::function<void(const PF_SignalEvent &event)>;
+
+    PF_SignalCallbackSink(std::string name, Callback callback)
+        : name_{std::move(name)}, callback_{std::move(callback)}
+    {
+    }
+
+    [[nodiscard]] std::string Name() const override
+    {
+        return name_;
+    }
+    bool Consume(const PF_SignalEvent &event) override
+    {
+        callback_(event);
+        return true;
+    }
+
+private:
+    std::string name_;
+    Callback callback_;
+};
+
+// =====================================================================================
+//        Class:  PF_SignalBus
+//  Description:  a broadcast ring buffer. Publishers claim the next sequence number
+//  with one atomic add and write the event into its slot under a sequence lock.
+//  Every sink has its own thread and its own position in the ring so each sees
+//  every event, in order, without any locks.
+//
+//  Publish() never waits. A sink which falls a whole ring behind skips the events
+//  it missed and they are counted as dropped for that sink.
+//
+//  Sinks are added before Start(). Stop() delivers everything already published.
+// =====================================================================================
+
+class PF_SignalBus
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    // capacity is rounded up to a power of 2.
+
+    explicit PF_SignalBus(size_t capacity = 4096, PF_StreamingMetrics *metrics = nullptr);
+
+    PF_SignalBus(const PF_SignalBus &rhs) = delete;
+    PF_SignalBus(PF_SignalBus &&rhs) = delete;
+
+    ~PF_SignalBus();
+
+    // ====================  MUTATORS      =======================================
+
+    void AddSink(std::unique_ptr<PF_SignalSink> sink);
+
+    void Start();
+    void Stop();
+
+    // any thread.
+
+    void Publish(PF_SignalEvent event);
+
+    // ====================  OPERATORS     =======================================
+
+    PF_SignalBus &operator=(const PF_SignalBus &rhs) = delete;
+    PF_SignalBus &operator=(PF_SignalBus &&rhs) = delete;
+
+private:
+    struct alignas(64) Slot
+    {
+        // 2 * sequence + 1 while being written, 2 * sequence + 2 once published.
+        std::atomic<uint64_t> stamp_ = 0;
+        PF_SignalEvent event_;
+    };
+
+    struct alignas(64) Subscriber
+    {
+        std::unique_ptr<PF_SignalSink> sink_;
+        std::thread thread_;
+        int64_t delivered_ = 0;
+        int64_t failed_ = 0;
+        int64_t dropped_ = 0;
+    };
+
+    enum class TakeResult : int32_t
+    {
+        e_taken,
+        e_not_yet,
+        e_overwritten
+    };
+
+    [[nodiscard]] TakeResult Take(uint64_t sequence, PF_SignalEvent &event) const;
+    void DeliverTo(Subscriber &subscriber);
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::unique_ptr<Slot[]> ring_;
+    uint64_t capacity_;
+    uint64_t mask_;
+
+    PF_StreamingMetrics *metrics_;
+
+    alignas(64) std::atomic<uint64_t> next_sequence_ = 0;
+
+    // bumped after every publish so idle sinks can sleep on it.
+    alignas(64) std::atomic<uint64_t> published_ = 0;
+    std::atomic<bool> stopping_ = false;
+
+    std::vector<std::unique_ptr<Subscriber>> subscribers_;
+
+}; // -----  end of class PF_SignalBus  -----
+
+#endif // ----- #ifndef _PF_SIGNALBUS_INC_  -----
@@ -0,0 +1,505 @@
+// =====================================================================================
+//
+//       Filename:  PF_StreamingMetrics.cpp
+//
+//    Description:  Latency histograms, queue depths and tick rates for the
+//    streaming pipeline.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 05:30 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/assert.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include "PF_StreamingMetrics.h"
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+using tcp = boost::asio::ip::tcp;
+
+namespace
+{
+constexpr std::array<const char *, std::to_underlying(PF_StreamingMetrics::Stage::e_count)> kStageNames{
+    "parse_queue", "parse",          "process_queue", "chart_apply", "tick_to_signal",
+    "render",      "tick_to_render", "file_write",    "tick_to_disk", "signal_to_sink", "tick_to_sink"};
+
+constexpr std::array<const char *, std::to_underlying(PF_StreamingMetrics::Queue::e_count)> kQueueNames{
+    "parse", "render", "persist"};
+
+constexpr std::array<double, 4> kQuantiles{0.5, 0.9, 0.99, 0.999};
+
+constexpr int32_t kBusiestSymbolsToLog = 5;
+
+std::string FormatNs(uint64_t value_ns)
+{
+    if (value_ns < 1'000)
+    {
+        return std::format("{}ns", value_ns);
+    }
+    if (value_ns < 1'000'000)
+    {
+        return std::format("{:.1f}us", value_ns / 1'000.0);
+    }
+    if (value_ns < 1'000'000'000)
+    {
+        return std::format("{:.2f}ms", value_ns / 1'000'000.0);
+    }
+    return std::format("{:.2f}s", value_ns / 1'000'000'000.0);
+}
+} // namespace
+
+// =====================================================================================
+// a minimal HTTP server on localhost which answers GET /metrics. One request per
+// connection is plenty for a scraper.
+// =====================================================================================
+
+struct PF_StreamingMetrics::MetricsServer
+{
+    struct Connection
+    {
+        explicit Connection(tcp::socket socket) : socket_{std::move(socket)}
+        {
+        }
+
+        tcp::socket socket_;
+        beast::flat_buffer buffer_;
+        http::request<http::empty_body> request_;
+        http::response<http::string_body> response_;
+    };
+
+    MetricsServer(const PF_StreamingMetrics &metrics, int32_t port)
+        : metrics_{metrics},
+          acceptor_{ioc_, tcp::endpoint{net::ip::make_address("127.0.0.1"), static_cast<uint16_t>(port)}}
+    {
+        DoAccept();
+        io_thread_ = std::thread{[this] { ioc_.run(); }};
+    }
+
+    ~MetricsServer()
+    {
+        ioc_.stop();
+        io_thread_.join();
+    }
+
+    void DoAccept()
+    {
+        acceptor_.async_accept([this](beast::error_code ec, tcp::socket socket) {
+            if (ec == net::error::operation_aborted)
+            {
+                return;
+            }
+            if (!ec)
+            {
+                Respond(std::make_shared<Connection>(std::move(socket)));
+            }
+            DoAccept();
+        });
+    }
+
+    void Respond(std::shared_ptr<Connection> connection)
+    {
+        http::async_read(
+            connection->socket_, connection->buffer_, connection->request_,
+            [this, connection](beast::error_code ec, std::size_t) {
+                if (ec)
+                {
+                    return;
+                }
+                auto &response = connection->response_;
+                response.version(connection->request_.version());
+                response.keep_alive(false);
+                if (connection->request_.method() == http::verb::get &&
+                    (connection->request_.target() == "/metrics" || connection->request_.target() == "/"))
+                {
+                    response.result(http::status::ok);
+                    response.set(http::field::content_type, "text/plain; version=0.0.4; charset=utf-8");
+                    response.body() = metrics_.PrometheusText();
+                }
+                else
+                {
+                    response.result(http::status::not_found);
+                    response.set(http::field::content_type, "text/plain");
+                    response.body() = "Not found. Try /metrics\n";
+                }
+                response.prepare_payload();
+                http::async_write(connection->socket_, response, [connection](beast::error_code, std::size_t) {
+                    beast::error_code ignored;
+                    connection->socket_.shutdown(tcp::socket::shutdown_send, ignored);
+                });
+            });
+    }
+
+    const PF_StreamingMetrics &metrics_;
+    net::io_context ioc_;
+    tcp::acceptor acceptor_;
+    std::thread io_thread_;
+};
+
+LatencyHistogram::Snapshot LatencyHistogram::TakeAndReset()
+{
+    Snapshot snapshot;
+    for (int32_t bucket = 0; bucket < kBuckets; ++bucket)
+    {
+        snapshot.counts_[bucket] = counts_[bucket].exchange(0, std::memory_order_relaxed);
+        snapshot.count_ += snapshot.counts_[bucket];
+    }
+    snapshot.max_ns_ = max_ns_.exchange(0, std::memory_order_relaxed);
+    return snapshot;
+} // -----  end of method LatencyHistogram::TakeAndReset  -----
+
+uint64_t LatencyHistogram::Snapshot::ValueAt(double fraction) const
+{
+    if (count_ == 0)
+    {
+        return 0;
+    }
+    const auto wanted = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * count_)));
+    uint64_t seen = 0;
+    for (int32_t bucket = 0; bucket < kBuckets; ++bucket)
+    {
+        seen += counts_[bucket];
+        if (seen >= wanted)
+        {
+            return std::min(BucketUpperBound(bucket), max_ns_);
+        }
+    }
+    return max_ns_;
+} // -----  end of method LatencyHistogram::Snapshot::ValueAt  -----
+
+PF_StreamingMetrics::PF_StreamingMetrics(const std::vector<std::string> &symbols, int32_t connections)
+    : symbols_{symbols},
+      symbol_metrics_{std::make_unique<SymbolMetrics[]>(symbols.size())},
+      connections_{std::max(connections, 1)},
+      connection_metrics_{std::make_unique<ConnectionState[]>(connections_)},
+      last_ticks_per_second_(symbols.size(), 0.0),
+      ticks_at_last_report_(symbols.size(), 0),
+      last_frames_per_second_(connections_, 0.0),
+      frames_at_last_report_(connections_, 0),
+      last_report_at_{Clock::now()}
+{
+    for (int32_t i = 0; i < std::ssize(symbols_); ++i)
+    {
+        symbol_index_.emplace(symbols_[i], i);
+    }
+} // -----  end of method PF_StreamingMetrics::PF_StreamingMetrics  (constructor)  -----
+
+PF_StreamingMetrics::~PF_StreamingMetrics()
+{
+    Stop();
+} // -----  end of method PF_StreamingMetrics::~PF_StreamingMetrics  (destructor)  -----
+
+void PF_StreamingMetrics::CountTick(std::string_view symbol)
+{
+    if (const auto found = symbol_index_.find(symbol); found != symbol_index_.end())
+    {
+        symbol_metrics_[found->second].ticks_.fetch_add(1, std::memory_order_relaxed);
+    }
+} // -----  end of method PF_StreamingMetrics::CountTick  -----
+
+void PF_StreamingMetrics::CountConflated(std::string_view symbol, uint64_t dropped_ticks)
+{
+    if (const auto found = symbol_index_.find(symbol); found != symbol_index_.end())
+    {
+        symbol_metrics_[found->second].conflated_ticks_.fetch_add(dropped_ticks, std::memory_order_relaxed);
+    }
+} // -----  end of method PF_StreamingMetrics::CountConflated  -----
+
+void PF_StreamingMetrics::SetSymbolQueueDepth(std::string_view symbol, int64_t depth)
+{
+    if (const auto found = symbol_index_.find(symbol); found != symbol_index_.end())
+    {
+        symbol_metrics_[found->second].queue_depth_.store(depth, std::memory_order_relaxed);
+    }
+} // -----  end of method PF_StreamingMetrics::SetSymbolQueueDepth  -----
+
+void PF_StreamingMetrics::SetParseQueueDepth(int32_t connection, int64_t depth)
+{
+    connection_metrics_[connection].parse_queue_depth_.store(depth, std::memory_order_relaxed);
+
+    int64_t total = 0;
+    for (int32_t i = 0; i < connections_; ++i)
+    {
+        total += connection_metrics_[i].parse_queue_depth_.load(std::memory_order_relaxed);
+    }
+    SetQueueDepth(Queue::e_parse, total);
+} // -----  end of method PF_StreamingMetrics::SetParseQueueDepth  -----
+
+void PF_StreamingMetrics::Start(std::chrono::seconds report_interval, int32_t port)
+{
+    BOOST_ASSERT_MSG(report_interval.count() > 0, "Metrics report interval must be > 0.");
+    BOOST_ASSERT_MSG(!reporter_.joinable(), "Metrics already started.");
+
+    report_interval_ = report_interval;
+    last_report_at_ = Clock::now();
+    done_ = false;
+    reporter_ = std::thread{&PF_StreamingMetrics::ReportTask, this};
+
+    if (port > 0)
+    {
+        try
+        {
+            server_ = std::make_unique<MetricsServer>(*this, port);
+            spdlog::info(std::format("Streaming metrics at: http://127.0.0.1:{}/metrics", port));
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Unable to start metrics endpoint on port: {} because: {}", port, e.what()));
+        }
+    }
+} // -----  end of method PF_StreamingMetrics::Start  -----
+
+void PF_StreamingMetrics::Stop()
+{
+    if (!reporter_.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        done_ = true;
+    }
+    cv_.notify_one();
+    reporter_.join();
+    server_.reset();
+} // -----  end of method PF_StreamingMetrics::Stop  -----
+
+void PF_StreamingMetrics::ReportTask()
+{
+    // always report the last, partial, interval too.
+
+    bool done = false;
+    while (!done)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            cv_.wait_for(lock, report_interval_, [this] { return done_; });
+            done = done_;
+        }
+        RollOver();
+
+        std::lock_guard<std::mutex> report_lock(report_mtx_);
+
+        for (int32_t stage = 0; stage < std::ssize(last_interval_); ++stage)
+        {
+            const auto &snapshot = last_interval_[stage];
+            if (snapshot.count_ == 0)
+            {
+                continue;
+            }
+            spdlog::info(std::format("Streaming latency {}: n: {} p50: {} p90: {} p99: {} p99.9: {} max: {}",
+                                     kStageNames[stage], snapshot.count_, FormatNs(snapshot.ValueAt(0.5)),
+                                     FormatNs(snapshot.ValueAt(0.9)), FormatNs(snapshot.ValueAt(0.99)),
+                                     FormatNs(snapshot.ValueAt(0.999)), FormatNs(snapshot.max_ns_)));
+        }
+
+        std::vector<int32_t> by_rate(symbols_.size());
+        std::iota(by_rate.begin(), by_rate.end(), 0);
+        std::ranges::sort(by_rate, std::greater<>{}, [this](int32_t i) { return last_ticks_per_second_[i]; });
+
+        std::string busiest;
+        for (const auto i : by_rate | std::views::take(kBusiestSymbolsToLog))
+        {
+            std::format_to(std::back_inserter(busiest), " {}: {:.1f}", symbols_[i], last_ticks_per_second_[i]);
+        }
+
+        int64_t deepest = 0;
+        std::string deepest_symbol{"none"};
+        for (int32_t i = 0; i < std::ssize(symbols_); ++i)
+        {
+            if (const auto depth = symbol_metrics_[i].queue_depth_.load(std::memory_order_relaxed); depth > deepest)
+            {
+                deepest = depth;
+                deepest_symbol = symbols_[i];
+            }
+        }
+        spdlog::info(std::format(
+            "Streaming ticks/sec: {:.1f}. Busiest:{}. Queues parse: {} render: {} persist: {} deepest symbol: {} {}.",
+            std::reduce(last_ticks_per_second_.begin(), last_ticks_per_second_.end()), busiest,
+            queue_depths_[std::to_underlying(Queue::e_parse)].load(std::memory_order_relaxed),
+            queue_depths_[std::to_underlying(Queue::e_render)].load(std::memory_order_relaxed),
+            queue_depths_[std::to_underlying(Queue::e_persist)].load(std::memory_order_relaxed), deepest_symbol,
+            deepest));
+
+        std::string connections;
+        for (int32_t i = 0; i < connections_; ++i)
+        {
+            const auto &connection = connection_metrics_[i];
+            std::format_to(std::back_inserter(connections),
+                           " {}: {} frames/sec: {:.1f} reconnects: {} parse queue: {}.", i,
+                           connection.health_.connected_.load(std::memory_order_relaxed) ? "up" : "DOWN",
+                           last_frames_per_second_[i], connection.health_.reconnects_.load(std::memory_order_relaxed),
+                           connection.parse_queue_depth_.load(std::memory_order_relaxed));
+        }
+        spdlog::info(std::format("Streaming connections:{}", connections));
+    }
+} // -----  end of method PF_StreamingMetrics::ReportTask  -----
+
+void PF_StreamingMetrics::RollOver()
+{
+    const auto now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(report_mtx_);
+
+    for (int32_t stage = 0; stage < std::ssize(histograms_); ++stage)
+    {
+        last_interval_[stage] = histograms_[stage].TakeAndReset();
+    }
+
+    const std::chrono::duration<double> elapsed = now - last_report_at_;
+    for (int32_t i = 0; i < std::ssize(symbols_); ++i)
+    {
+        const auto ticks = symbol_metrics_[i].ticks_.load(std::memory_order_relaxed);
+        last_ticks_per_second_[i] =
+            elapsed.count() > 0.0 ? static_cast<double>(ticks - ticks_at_last_report_[i]) / elapsed.count() : 0.0;
+        ticks_at_last_report_[i] = ticks;
+    }
+    for (int32_t i = 0; i < connections_; ++i)
+    {
+        const auto frames = connection_metrics_[i].health_.frames_.load(std::memory_order_relaxed);
+        last_frames_per_second_[i] =
+            elapsed.count() > 0.0 ? static_cast<double>(frames - frames_at_last_report_[i]) / elapsed.count() : 0.0;
+        frames_at_last_report_[i] = frames;
+    }
+    last_report_at_ = now;
+} // -----  end of method PF_StreamingMetrics::RollOver  -----
+
+std::string PF_StreamingMetrics::PrometheusText() const
+{
+    std::string text;
+    auto out = std::back_inserter(text);
+
+    std::lock_guard<std::mutex> lock(report_mtx_);
+
+    std::format_to(out, "# HELP pf_streaming_latency_seconds Streaming stage latency. Quantiles cover the last "
+                        "report interval.\n# TYPE pf_streaming_latency_seconds summary\n");
+    for (int32_t stage = 0; stage < std::ssize(histograms_); ++stage)
+    {
+        for (const auto quantile : kQuantiles)
+        {
+            std::format_to(out, "pf_streaming_latency_seconds{{stage=\"{}\",quantile=\"{}\"}} {:.9f}\n",
+                           kStageNames[stage], quantile, last_interval_[stage].ValueAt(quantile) / 1e9);
+        }
+        std::format_to(out, "pf_streaming_latency_seconds_sum{{stage=\"{}\"}} {:.9f}\n", kStageNames[stage],
+                       histograms_[stage].TotalSumNs() / 1e9);
+        std::format_to(out, "pf_streaming_latency_seconds_count{{stage=\"{}\"}} {}\n", kStageNames[stage],
+                       histograms_[stage].TotalCount());
+    }
+
+    std::format_to(out, "# HELP pf_streaming_latency_max_seconds Largest stage latency in the last report "
+                        "interval.\n# TYPE pf_streaming_latency_max_seconds gauge\n");
+    for (int32_t stage = 0; stage < std::ssize(histograms_); ++stage)
+    {
+        std::format_to(out, "pf_streaming_latency_max_seconds{{stage=\"{}\"}} {:.9f}\n", kStageNames[stage],
+                       last_interval_[stage].max_ns_ / 1e9);
+    }
+
+    std::format_to(out, "# HELP pf_streaming_queue_depth Items waiting in each streaming queue.\n"
+                        "# TYPE pf_streaming_queue_depth gauge\n");
+    for (int32_t queue = 0; queue < std::ssize(queue_depths_); ++queue)
+    {
+        std::format_to(out, "pf_streaming_queue_depth{{queue=\"{}\"}} {}\n", kQueueNames[queue],
+                       queue_depths_[queue].load(std::memory_order_relaxed));
+    }
+
+    std::format_to(out, "# HELP pf_streaming_symbol_queue_depth Ticks waiting for each symbol's processor.\n"
+                        "# TYPE pf_streaming_symbol_queue_depth gauge\n");
+    for (int32_t i = 0; i < std::ssize(symbols_); ++i)
+    {
+        std::format_to(out, "pf_streaming_symbol_queue_depth{{symbol=\"{}\"}} {}\n", symbols_[i],
+                       symbol_metrics_[i].queue_depth_.load(std::memory_order_relaxed));
+    }
+
+    std::format_to(out, "# HELP pf_streaming_ticks_total Ticks received for each symbol.\n"
+                        "# TYPE pf_streaming_ticks_total counter\n");
+    for (int32_t i = 0; i < std::ssize(symbols_); ++i)
+    {
+        std::format_to(out, "pf_streaming_ticks_total{{symbol=\"{}\"}} {}\n", symbols_[i],
+                       symbol_metrics_[i].ticks_.load(std::memory_order_relaxed));
+    }
+
+    std::format_to(out, "# HELP pf_streaming_conflated_ticks_total Ticks for each symbol skipped by conflating a "
+                        "backlog.\n# TYPE pf_streaming_conflated_ticks_total counter\n");
+    for (int32_t i = 0; i < std::ssize(symbols_); ++i)
+    {
+        std::format_to(out, "pf_streaming_conflated_ticks_total{{symbol=\"{}\"}} {}\n", symbols_[i],
+                       symbol_metrics_[i].conflated_ticks_.load(std::memory_order_relaxed));
+    }
+
+    std::format_to(out, "# HELP pf_streaming_connection_up 1 if the websocket connection is up.\n"
+                        "# TYPE pf_streaming_connection_up gauge\n");
+    for (int32_t i = 0; i < connections_; ++i)
+    {
+        std::format_to(out, "pf_streaming_connection_up{{connection=\"{}\"}} {}\n", i,
+                       connection_metrics_[i].health_.connected_.load(std::memory_order_relaxed) ? 1 : 0);
+    }
+
+    std::format_to(out, "# HELP pf_streaming_connection_frames_total Frames received on each websocket connection.\n"
+                        "# TYPE pf_streaming_connection_frames_total counter\n");
+    for (int32_t i = 0; i < connections_; ++i)
+    {
+        std::format_to(out, "pf_streaming_connection_frames_total{{connection=\"{}\"}} {}\n", i,
+                       connection_metrics_[i].health_.frames_.load(std::memory_order_relaxed));
+    }
+
+    std::format_to(out, "# HELP pf_streaming_connection_reconnects_total Reconnect attempts on each websocket "
+                        "connection.\n# TYPE pf_streaming_connection_reconnects_total counter\n");
+    for (int32_t i = 0; i < connections_; ++i)
+    {
+        std::format_to(out, "pf_streaming_connection_reconnects_total{{connection=\"{}\"}} {}\n", i,
+                       connection_metrics_[i].health_.reconnects_.load(std::memory_order_relaxed));
+    }
+
+    std::format_to(out, "# HELP pf_streaming_connection_parse_queue_depth Frames from each websocket connection "
+                        "waiting for its parser.\n# TYPE pf_streaming_connection_parse_queue_depth gauge\n");
+    for (int32_t i = 0; i < connections_; ++i)
+    {
+        std::format_to(out, "pf_streaming_connection_parse_queue_depth{{connection=\"{}\"}} {}\n", i,
+                       connection_metrics_[i].parse_queue_depth_.load(std::memory_order_relaxed));
+    }
+
+    std::format_to(out, "# HELP pf_streaming_ticks_per_second Ticks per second for each symbol over the last "
+                        "report interval.\n# TYPE pf_streaming_ticks_per_second gauge\n");
+    for (int32_t i = 0; i < std::ssize(symbols_); ++i)
+    {
+        std::format_to(out, "pf_streaming_ticks_per_second{{symbol=\"{}\"}} {:.3f}\n", symbols_[i],
+                       last_ticks_per_second_[i]);
+    }
+
+    return text;
+} // -----  end of method PF_StreamingMetrics::PrometheusText  -----
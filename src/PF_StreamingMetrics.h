@@ -0,0 +1,308 @@
+// =====================================================================================
+//
+//       Filename:  PF_StreamingMetrics.h
+//
+//    Description:  Latency histograms, queue depths and tick rates for the
+//    streaming pipeline.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 05:30 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _PF_STREAMINGMETRICS_INC_
+#define _PF_STREAMINGMETRICS_INC_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// =====================================================================================
+//        Class:  LatencyHistogram
+//  Description:  HDR style histogram of nanosecond values. Values below 32 get
+//  their own bucket. Above that each power of 2 is split into 16 buckets so any
+//  reported value is within 1/16 (6.25%) of the true one, from nanoseconds up to
+//  centuries, in a fixed 976 buckets.
+//
+//  Record() is lock-free and can be called from any number of threads.
+//  TakeAndReset() hands back the counts since the last call. The running total
+//  count and sum are never reset.
+// =====================================================================================
+
+class LatencyHistogram
+{
+public:
+    static constexpr int32_t kSubBucketBits = 5;
+    static constexpr uint64_t kSubBuckets = 1ULL << kSubBucketBits;
+    static constexpr uint64_t kHalfSubBuckets = kSubBuckets / 2;
+    static constexpr int32_t kBuckets = (64 - kSubBucketBits) * kHalfSubBuckets + kSubBuckets;
+
+    struct Snapshot
+    {
+        std::array<uint64_t, kBuckets> counts_{};
+        uint64_t count_ = 0;
+        uint64_t max_ns_ = 0;
+
+        // the value at the given fraction (0.0 - 1.0) of the distribution. Reported
+        // as the top of its bucket so it errs on the slow side.
+
+        [[nodiscard]] uint64_t ValueAt(double fraction) const;
+    };
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] uint64_t TotalCount() const
+    {
+        return total_count_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] uint64_t TotalSumNs() const
+    {
+        return total_sum_ns_.load(std::memory_order_relaxed);
+    }
+
+    static constexpr int32_t BucketFor(uint64_t value_ns)
+    {
+        if (value_ns < kSubBuckets)
+        {
+            return static_cast<int32_t>(value_ns);
+        }
+        const int32_t shift = std::bit_width(value_ns) - kSubBucketBits;
+        return static_cast<int32_t>(shift * kHalfSubBuckets + (value_ns >> shift));
+    }
+
+    static constexpr uint64_t BucketUpperBound(int32_t bucket)
+    {
+        if (bucket < static_cast<int32_t>(kSubBuckets))
+        {
+            return static_cast<uint64_t>(bucket);
+        }
+        const int32_t shift = bucket / static_cast<int32_t>(kHalfSubBuckets) - 1;
+        const uint64_t top = bucket % kHalfSubBuckets + kHalfSubBuckets;
+        return ((top + 1) << shift) - 1;
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    void Record(std::chrono::nanoseconds value)
+    {
+        const auto value_ns = static_cast<uint64_t>(std::max<int64_t>(0, value.count()));
+        counts_[BucketFor(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        total_count_.fetch_add(1, std::memory_order_relaxed);
+        total_sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+
+        auto current_max = max_ns_.load(std::memory_order_relaxed);
+        while (value_ns > current_max &&
+               !max_ns_.compare_exchange_weak(current_max, value_ns, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    Snapshot TakeAndReset();
+
+private:
+    // ====================  DATA MEMBERS  =======================================
+
+    std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+    std::atomic<uint64_t> max_ns_ = 0;
+    std::atomic<uint64_t> total_count_ = 0;
+    std::atomic<uint64_t> total_sum_ns_ = 0;
+
+}; // -----  end of class LatencyHistogram  -----
+
+// =====================================================================================
+//        Class:  PF_StreamingMetrics
+//  Description:  where the time goes between a trade arriving on the websocket and
+//  its chart reaching disk.
+//
+//  Each stream message is stamped when it is received. Every stage records its own
+//  duration and the 'tick_to_*' stages record the time since the message was
+//  received. A chart which changes several times before it is drawn keeps the
+//  time of its oldest undrawn tick so tick_to_render and tick_to_disk include the
+//  time spent waiting for the next draw.
+//
+//  Each websocket connection has its own health: whether it is up, frames
+//  received, reconnects and how many frames are waiting for its parser.
+//
+//  Every report interval the histograms are rolled over and a summary is logged.
+//  If a port is given, the latest interval is also served on localhost in
+//  Prometheus text format at /metrics.
+// =====================================================================================
+
+class PF_StreamingMetrics
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Stage : int32_t
+    {
+        e_parse_queue,    // received -> taken by parser
+        e_parse,          // parse one message
+        e_process_queue,  // parsed -> taken by symbol processor
+        e_chart_apply,    // add value to all the symbol's charts
+        e_tick_to_signal, // received -> new signal found
+        e_render,         // draw one chart and its JSON
+        e_tick_to_render, // received -> chart drawn
+        e_file_write,     // write one output file
+        e_tick_to_disk,   // received -> chart file replaced on disk
+        e_signal_to_sink, // new signal found -> handed to a subscriber
+        e_tick_to_sink,   // received -> new signal handed to a subscriber
+        e_count
+    };
+
+    enum class Queue : int32_t
+    {
+        e_parse,   // frames waiting for the parser
+        e_render,  // charts waiting to be drawn
+        e_persist, // charts waiting to be stored in the DB
+        e_count
+    };
+
+    // health of 1 websocket connection. Updated by its reader.
+
+    struct ConnectionMetrics
+    {
+        std::atomic<bool> connected_ = false;
+        std::atomic<uint64_t> frames_ = 0;
+        std::atomic<uint64_t> reconnects_ = 0;
+    };
+
+    // ====================  LIFECYCLE     =======================================
+
+    explicit PF_StreamingMetrics(const std::vector<std::string> &symbols, int32_t connections = 1);
+
+    PF_StreamingMetrics(const PF_StreamingMetrics &rhs) = delete;
+    PF_StreamingMetrics(PF_StreamingMetrics &&rhs) = delete;
+
+    ~PF_StreamingMetrics();
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] std::string PrometheusText() const;
+
+    // ====================  MUTATORS      =======================================
+
+    void Record(Stage stage, Clock::duration elapsed)
+    {
+        histograms_[std::to_underlying(stage)].Record(elapsed);
+    }
+    void RecordSince(Stage stage, Clock::time_point start)
+    {
+        Record(stage, Clock::now() - start);
+    }
+    void SetQueueDepth(Queue queue, int64_t depth)
+    {
+        queue_depths_[std::to_underlying(queue)].store(depth, std::memory_order_relaxed);
+    }
+
+    // unknown symbols are ignored.
+
+    void CountTick(std::string_view symbol);
+    void CountConflated(std::string_view symbol, uint64_t dropped_ticks);
+    void SetSymbolQueueDepth(std::string_view symbol, int64_t depth);
+
+    // the parse queue depth is the total for all connections.
+
+    void SetParseQueueDepth(int32_t connection, int64_t depth);
+
+    [[nodiscard]] ConnectionMetrics &Connection(int32_t connection)
+    {
+        return connection_metrics_[connection].health_;
+    }
+
+    // report_interval must be > 0. port 0 means no metrics endpoint.
+
+    void Start(std::chrono::seconds report_interval, int32_t port);
+    void Stop();
+
+    // ====================  OPERATORS     =======================================
+
+    PF_StreamingMetrics &operator=(const PF_StreamingMetrics &rhs) = delete;
+    PF_StreamingMetrics &operator=(PF_StreamingMetrics &&rhs) = delete;
+
+private:
+    struct SymbolMetrics
+    {
+        std::atomic<uint64_t> ticks_ = 0;
+        std::atomic<uint64_t> conflated_ticks_ = 0; // dropped from a backlog by conflation
+        std::atomic<int64_t> queue_depth_ = 0;
+    };
+
+    struct ConnectionState
+    {
+        ConnectionMetrics health_;
+        std::atomic<int64_t> parse_queue_depth_ = 0;
+    };
+
+    struct MetricsServer;
+
+    void ReportTask();
+    void RollOver();
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::array<LatencyHistogram, std::to_underlying(Stage::e_count)> histograms_;
+    std::array<std::atomic<int64_t>, std::to_underlying(Queue::e_count)> queue_depths_{};
+
+    // built once in the constructor and only read after that so lookups need no lock.
+
+    std::vector<std::string> symbols_;
+    std::map<std::string, int32_t, std::less<>> symbol_index_;
+    std::unique_ptr<SymbolMetrics[]> symbol_metrics_;
+
+    int32_t connections_;
+    std::unique_ptr<ConnectionState[]> connection_metrics_;
+
+    // the last complete interval. Used by the log report and the endpoint.
+
+    mutable std::mutex report_mtx_;
+    std::array<LatencyHistogram::Snapshot, std::to_underlying(Stage::e_count)> last_interval_;
+    std::vector<double> last_ticks_per_second_;
+    std::vector<uint64_t> ticks_at_last_report_;
+    std::vector<double> last_frames_per_second_;
+    std::vector<uint64_t> frames_at_last_report_;
+    Clock::time_point last_report_at_;
+
+    std::chrono::seconds report_interval_{0};
+    std::condition_variable cv_;
+    std::mutex mtx_;
+    std::thread reporter_;
+    bool done_ = false;
+
+    std::unique_ptr<MetricsServer> server_;
+
+}; // -----  end of class PF_StreamingMetrics  -----
+
+#endif // ----- #ifndef _PF_STREAMINGMETRICS_INC_  -----
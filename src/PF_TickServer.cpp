@@ -0,0 +1,452 @@
+// =====================================================================================
+//
+//       Filename:  PF_TickServer.cpp
+//
+//    Description:  Local websocket server which speaks the Tiingo or Eodhd
+//    streaming protocol and sends made up trades. Used to load test the
+//    streaming code without a live market.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 03:50 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+// Point PF_CollectData at it with:
+//
+//      --streaming-host localhost --streaming-port <port> --streaming-data-source <Tiingo|Eodhd>
+//
+// (the api key file must exist but its contents are ignored.)
+//
+// Each connection gets its own thread and its own random walk for the symbols it
+// subscribes to. The server reports how many trades it actually sent versus the
+// requested rate. When the client can't keep up, websocket writes block and the
+// difference shows up as 'behind'.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <boost/program_options.hpp>
+
+#include <json/json.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include "SyntheticPrices.h"
+
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+namespace po = boost::program_options;
+using tcp = boost::asio::ip::tcp;
+
+namespace
+{
+enum class Protocol : int32_t
+{
+    e_Tiingo,
+    e_Eodhd
+};
+
+struct ServerOptions
+{
+    Protocol protocol_ = Protocol::e_Tiingo;
+    std::string cert_file_;
+    std::string key_file_;
+    double rate_ = 1000.0; // trades per second per connection
+    double burst_factor_ = 1.0;
+    int32_t burst_every_secs_ = 0;
+    int32_t burst_length_ms_ = 0;
+    int32_t heartbeat_secs_ = 0;
+    int32_t disconnect_every_secs_ = 0;
+    int32_t report_secs_ = 5;
+    int64_t start_cents_ = 10'000;
+    int32_t max_step_cents_ = 5;
+    uint64_t seed_ = 12345;
+    uint16_t port_ = 8443;
+};
+
+struct ServerStats
+{
+    std::atomic<int64_t> trades_sent_ = 0;
+    std::atomic<int64_t> trades_behind_ = 0;
+    std::atomic<int32_t> sessions_ = 0;
+};
+
+ServerStats g_stats;
+
+// ===================  certificates  =====================================
+
+template <typename T, void (*Free)(T *)>
+struct OpenSSLDeleter
+{
+    void operator()(T *p) const
+    {
+        Free(p);
+    }
+};
+
+using EVP_PKEY_ptr = std::unique_ptr<EVP_PKEY, OpenSSLDeleter<EVP_PKEY, EVP_PKEY_free>>;
+using X509_ptr = std::unique_ptr<X509, OpenSSLDeleter<X509, X509_free>>;
+
+// good enough for localhost. The streaming client doesn't verify the peer.
+
+void UseSelfSignedCertificate(ssl::context &ctx)
+{
+    EVP_PKEY_ptr key{EVP_EC_gen("P-256")};
+    X509_ptr cert{X509_new()};
+    if (!key || !cert)
+    {
+        throw std::runtime_error("Unable to create self-signed certificate.");
+    }
+
+    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert.get()), 60L * 60 * 24 * 365);
+    X509_set_pubkey(cert.get(), key.get());
+
+    X509_NAME *name = X509_get_subject_name(cert.get());
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("localhost"), -1, -1,
+                               0);
+    X509_set_issuer_name(cert.get(), name);
+
+    if (X509_sign(cert.get(), key.get(), EVP_sha256()) == 0 ||
+        SSL_CTX_use_certificate(ctx.native_handle(), cert.get()) != 1 ||
+        SSL_CTX_use_PrivateKey(ctx.native_handle(), key.get()) != 1)
+    {
+        throw std::runtime_error("Unable to use self-signed certificate.");
+    }
+}
+
+// ===================  protocol  =========================================
+
+struct Subscription
+{
+    std::vector<std::string> symbols_;
+    bool unsubscribe_ = false;
+};
+
+std::optional<Subscription> ParseSubscription(Protocol protocol, const std::string &message)
+{
+    Json::Value request;
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    JSONCPP_STRING err;
+    if (!reader->parse(message.data(), message.data() + message.size(), &request, &err))
+    {
+        return {};
+    }
+
+    Subscription result;
+    if (protocol == Protocol::e_Tiingo)
+    {
+        // {"eventName":"subscribe","authorization":"...","eventData":{"thresholdLevel":6,"tickers":["aapl",...]}}
+
+        result.unsubscribe_ = request["eventName"].asString() == "unsubscribe";
+        for (const auto &ticker : request["eventData"]["tickers"])
+        {
+            result.symbols_.push_back(ticker.asString());
+        }
+    }
+    else
+    {
+        // {"action": "subscribe", "symbols": "AAPL, MSFT"}
+
+        result.unsubscribe_ = request["action"].asString() == "unsubscribe";
+        const std::string symbols = request["symbols"].asString();
+        for (const auto symbol : std::views::split(symbols, ','))
+        {
+            std::string_view sym{symbol.begin(), symbol.end()};
+            while (!sym.empty() && sym.front() == ' ')
+            {
+                sym.remove_prefix(1);
+            }
+            while (!sym.empty() && sym.back() == ' ')
+            {
+                sym.remove_suffix(1);
+            }
+            if (!sym.empty())
+            {
+                result.symbols_.emplace_back(sym);
+            }
+        }
+    }
+    return result;
+}
+
+std::string SubscribeResponse(Protocol protocol, int32_t session_id)
+{
+    if (protocol == Protocol::e_Tiingo)
+    {
+        return std::format(
+            R"({{"messageType":"I","response":{{"code":200,"message":"Success"}},"data":{{"subscriptionId":"{}"}}}})",
+            session_id);
+    }
+    return R"({"status_code":200,"message":"Subscribed"})";
+}
+
+std::string TradeMessage(Protocol protocol, const std::string &symbol, int64_t price_cents, int32_t shares)
+{
+    const auto now = std::chrono::system_clock::now();
+    if (protocol == Protocol::e_Tiingo)
+    {
+        return std::format(R"({{"messageType":"A","service":"iex","data":["{:%FT%T}+00:00","{}",{}]}})",
+                           std::chrono::floor<std::chrono::nanoseconds>(now), symbol, CentsToPriceString(price_cents));
+    }
+    return std::format(R"({{"s":"{}","p":{},"c":[12,37],"v":{},"dp":false,"ms":"open","t":{}}})", symbol,
+                       CentsToPriceString(price_cents), shares,
+                       std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
+}
+
+// ===================  sessions  =========================================
+
+// true while inside a burst window.
+
+bool InBurst(const ServerOptions &options, std::chrono::steady_clock::duration since_start)
+{
+    if (options.burst_every_secs_ <= 0 || options.burst_length_ms_ <= 0)
+    {
+        return false;
+    }
+    const auto into_cycle = since_start % std::chrono::seconds{options.burst_every_secs_};
+    return into_cycle < std::chrono::milliseconds{options.burst_length_ms_};
+}
+
+void RunSession(tcp::socket socket, ssl::context &ctx, const ServerOptions &options, int32_t session_id)
+{
+    ++g_stats.sessions_;
+    try
+    {
+        websocket::stream<beast::ssl_stream<tcp::socket>> ws{std::move(socket), ctx};
+        ws.next_layer().handshake(ssl::stream_base::server);
+        ws.accept();
+
+        beast::flat_buffer buffer;
+        ws.read(buffer);
+        const auto subscription = ParseSubscription(options.protocol_, beast::buffers_to_string(buffer.cdata()));
+        if (!subscription)
+        {
+            std::cerr << std::format("session {}: unable to parse subscription.\n", session_id);
+            ws.close(websocket::close_code::policy_error);
+            --g_stats.sessions_;
+            return;
+        }
+
+        ws.text(true);
+        ws.write(net::buffer(SubscribeResponse(options.protocol_, session_id)));
+
+        if (subscription->unsubscribe_ || subscription->symbols_.empty())
+        {
+            ws.close(websocket::close_code::normal);
+            --g_stats.sessions_;
+            return;
+        }
+
+        std::cout << std::format("session {}: streaming {} symbols.\n", session_id, subscription->symbols_.size());
+
+        RandomWalkPrices prices{static_cast<int32_t>(subscription->symbols_.size()), options.start_cents_,
+                                options.max_step_cents_, options.seed_ + static_cast<uint64_t>(session_id)};
+        std::mt19937 shares_engine{static_cast<uint32_t>(options.seed_)};
+        std::uniform_int_distribution<int32_t> shares{1, 500};
+
+        const auto started_at = std::chrono::steady_clock::now();
+        auto last_pass = started_at;
+        auto last_heartbeat = started_at;
+        double trades_due = 0.0;
+
+        while (true)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            const auto since_start = now - started_at;
+
+            if (options.disconnect_every_secs_ > 0 &&
+                since_start >= std::chrono::seconds{options.disconnect_every_secs_})
+            {
+                // drop the connection without a websocket close so the client has to reconnect.
+
+                std::cout << std::format("session {}: forcing disconnect.\n", session_id);
+                beast::get_lowest_layer(ws).close();
+                break;
+            }
+
+            if (options.protocol_ == Protocol::e_Tiingo && options.heartbeat_secs_ > 0 &&
+                now - last_heartbeat >= std::chrono::seconds{options.heartbeat_secs_})
+            {
+                constexpr std::string_view kHeartbeat{
+                    R"({"messageType":"H","response":{"code":200,"message":"HeartBeat"}})"};
+                ws.write(net::buffer(kHeartbeat));
+                last_heartbeat = now;
+            }
+
+            const double rate = InBurst(options, since_start) ? options.rate_ * options.burst_factor_ : options.rate_;
+            trades_due += std::chrono::duration<double>(now - last_pass).count() * rate;
+            last_pass = now;
+
+            // don't try to catch up more than 1 second's worth. What we can't send is 'behind'.
+
+            if (trades_due > rate)
+            {
+                g_stats.trades_behind_ += static_cast<int64_t>(trades_due - rate);
+                trades_due = rate;
+            }
+
+            for (; trades_due >= 1.0; trades_due -= 1.0)
+            {
+                const int32_t which = prices.NextSymbol();
+                ws.write(net::buffer(TradeMessage(options.protocol_, subscription->symbols_[which],
+                                                  prices.NextPriceCents(which), shares(shares_engine))));
+                ++g_stats.trades_sent_;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << std::format("session {} ended: {}\n", session_id, e.what());
+    }
+    --g_stats.sessions_;
+}
+
+void ReportStats(const ServerOptions &options)
+{
+    int64_t previous_sent = 0;
+    int64_t previous_behind = 0;
+    while (true)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds{options.report_secs_});
+        const int64_t sent = g_stats.trades_sent_;
+        const int64_t behind = g_stats.trades_behind_;
+        std::cout << std::format(
+            "sessions: {}  sent/sec: {:.0f}  behind/sec: {:.0f}  target/sec per session: {:.0f}\n",
+            g_stats.sessions_.load(), static_cast<double>(sent - previous_sent) / options.report_secs_,
+            static_cast<double>(behind - previous_behind) / options.report_secs_, options.rate_);
+        previous_sent = sent;
+        previous_behind = behind;
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ServerOptions options;
+    std::string protocol;
+
+    // clang-format off
+    po::options_description desc{"PF_TickServer options"};
+    desc.add_options()
+        ("help,h",              "produce help message")
+        ("protocol",            po::value<std::string>(&protocol)->default_value("Tiingo"), "protocol to speak: 'Tiingo' or 'Eodhd'. Default is 'Tiingo'.")
+        ("port",                po::value<uint16_t>(&options.port_)->default_value(8443), "port to listen on. Default is 8443.")
+        ("cert",                po::value<std::string>(&options.cert_file_), "PEM certificate file. Default is: generate a self-signed certificate.")
+        ("key",                 po::value<std::string>(&options.key_file_), "PEM private key file for 'cert'.")
+        ("rate",                po::value<double>(&options.rate_)->default_value(1000.0), "trades per second for each connection. Default is 1000.")
+        ("burst-every",         po::value<int32_t>(&options.burst_every_secs_)->default_value(0), "seconds between bursts. Default is 0: no bursts.")
+        ("burst-length",        po::value<int32_t>(&options.burst_length_ms_)->default_value(0), "milliseconds each burst lasts.")
+        ("burst-factor",        po::value<double>(&options.burst_factor_)->default_value(10.0), "rate multiplier during a burst. Default is 10.")
+        ("heartbeat",           po::value<int32_t>(&options.heartbeat_secs_)->default_value(0), "seconds between heartbeat messages (Tiingo only). Default is 0: none.")
+        ("disconnect-every",    po::value<int32_t>(&options.disconnect_every_secs_)->default_value(0), "drop each connection after this many seconds. Default is 0: never.")
+        ("start-price",         po::value<int64_t>(&options.start_cents_)->default_value(10'000), "starting price in cents for every symbol. Default is 10000.")
+        ("max-step",            po::value<int32_t>(&options.max_step_cents_)->default_value(5), "largest price change per trade in cents. Default is 5.")
+        ("seed",                po::value<uint64_t>(&options.seed_)->default_value(12345), "random number seed. Default is 12345.")
+        ("report-every",        po::value<int32_t>(&options.report_secs_)->default_value(5), "seconds between rate reports. Default is 5.")
+        ;
+    // clang-format on
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+        if (vm.contains("help"))
+        {
+            std::cout << desc << '\n';
+            return 0;
+        }
+        if (protocol != "Tiingo" && protocol != "Eodhd")
+        {
+            std::cerr << "protocol must be 'Tiingo' or 'Eodhd'.\n";
+            return 1;
+        }
+        if (options.rate_ <= 0.0 || options.report_secs_ <= 0 || options.max_step_cents_ <= 0)
+        {
+            std::cerr << "rate, report-every and max-step must be > 0.\n";
+            return 1;
+        }
+        options.protocol_ = protocol == "Tiingo" ? Protocol::e_Tiingo : Protocol::e_Eodhd;
+
+        ssl::context ctx{ssl::context::tlsv12_server};
+        if (options.cert_file_.empty())
+        {
+            UseSelfSignedCertificate(ctx);
+        }
+        else
+        {
+            ctx.use_certificate_chain_file(options.cert_file_);
+            ctx.use_private_key_file(options.key_file_.empty() ? options.cert_file_ : options.key_file_,
+                                     ssl::context::pem);
+        }
+
+        net::io_context ioc;
+        tcp::acceptor acceptor{ioc, tcp::endpoint{net::ip::make_address("127.0.0.1"), options.port_}};
+
+        std::cout << std::format("PF_TickServer: {} protocol on localhost:{} at {} trades/sec per connection.\n",
+                                 protocol, options.port_, options.rate_);
+
+        std::thread{ReportStats, std::cref(options)}.detach();
+
+        for (int32_t session_id = 1;; ++session_id)
+        {
+            tcp::socket socket{ioc};
+            acceptor.accept(socket);
+            socket.set_option(tcp::no_delay{true});
+            std::thread{RunSession, std::move(socket), std::ref(ctx), std::cref(options), session_id}.detach();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "PF_TickServer: " << e.what() << '\n';
+        return 2;
+    }
+    return 0;
+}
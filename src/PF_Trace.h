@@ -0,0 +1,270 @@
+// =====================================================================================
+//
+//       Filename:  PF_Trace.h
+//
+//    Description:  Scoped trace macros for offline profiling. Output is Chrome
+//    trace-event JSON which can be opened in chrome://tracing or ui.perfetto.dev.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 06:40 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+// Usage:
+//
+//      PF_TRACE_SCOPE("db", "load_symbol");                 // until end of enclosing block
+//      PF_TRACE_SCOPE_ARG("chart", "apply", symbol);        // plus a detail string
+//      PF_TRACE_THREAD_NAME("output worker");               // label this thread's row
+//      PF_TRACE_WRITE();                                    // once, at exit
+//
+// Category and name must be string literals (they are kept as pointers).
+//
+// Unless PF_ENABLE_TRACE is defined (see the Trace config in makefile_collect) every
+// macro expands to nothing so none of this code, not even the argument expressions,
+// is compiled in.
+//
+// When enabled, each thread appends finished scopes to its own buffer so recording
+// takes no lock. PF_TRACE_WRITE() must be called after all worker threads are done.
+// It writes to the file named by the PF_TRACE_FILE environment variable or to
+// 'PF_CollectData_trace.json' in the current directory.
+
+#ifndef _PF_TRACE_INC_
+#define _PF_TRACE_INC_
+
+#ifdef PF_ENABLE_TRACE
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace PF_Trace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Event
+{
+    const char *category_;
+    const char *name_;
+    std::string detail_;
+    Clock::time_point start_;
+    Clock::duration duration_;
+};
+
+struct ThreadBuffer
+{
+    int32_t tid_ = 0;
+    std::string thread_name_;
+    std::vector<Event> events_;
+};
+
+// buffers are shared with the registry so events survive their thread exiting.
+
+struct Registry
+{
+    std::mutex mtx_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    Clock::time_point start_ = Clock::now();
+};
+
+inline Registry &TheRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+inline ThreadBuffer &ThisThreadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto &registry = TheRegistry();
+        auto new_buffer = std::make_shared<ThreadBuffer>();
+        new_buffer->events_.reserve(4096);
+
+        std::lock_guard<std::mutex> lock(registry.mtx_);
+        new_buffer->tid_ = static_cast<int32_t>(registry.buffers_.size()) + 1;
+        registry.buffers_.push_back(new_buffer);
+        return new_buffer;
+    }();
+    return *buffer;
+}
+
+inline void SetThreadName(std::string_view name)
+{
+    ThisThreadBuffer().thread_name_ = name;
+}
+
+// =====================================================================================
+//        Class:  Scope
+//  Description:  records one complete ('X') event covering its own lifetime.
+// =====================================================================================
+
+class Scope
+{
+public:
+    // the buffer is looked up first so a thread's first event doesn't start before
+    // the registry's clock does.
+
+    Scope(const char *category, const char *name, std::string detail = {})
+        : buffer_{&ThisThreadBuffer()}, category_{category}, name_{name}, detail_{std::move(detail)},
+          start_{Clock::now()}
+    {
+    }
+
+    Scope(const Scope &rhs) = delete;
+    Scope(Scope &&rhs) = delete;
+
+    ~Scope()
+    {
+        const auto end = Clock::now();
+        buffer_->events_.push_back(
+            Event{.category_ = category_, .name_ = name_, .detail_ = std::move(detail_), .start_ = start_,
+                  .duration_ = end - start_});
+    }
+
+    Scope &operator=(const Scope &rhs) = delete;
+    Scope &operator=(Scope &&rhs) = delete;
+
+private:
+    ThreadBuffer *buffer_;
+    const char *category_;
+    const char *name_;
+    std::string detail_;
+    Clock::time_point start_;
+}; // -----  end of class Scope  -----
+
+inline std::string EscapeJSON(std::string_view text)
+{
+    std::string result;
+    result.reserve(text.size());
+    for (const char c : text)
+    {
+        switch (c)
+        {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    result += std::format("\\u{:04x}", static_cast<int32_t>(c));
+                }
+                else
+                {
+                    result += c;
+                }
+        }
+    }
+    return result;
+}
+
+inline void WriteTrace()
+{
+    const char *env_file = std::getenv("PF_TRACE_FILE");
+    const std::string trace_file_name =
+        env_file != nullptr && *env_file != '\0' ? env_file : "PF_CollectData_trace.json";
+
+    std::ofstream trace_file{trace_file_name, std::ios::out | std::ios::trunc};
+    if (!trace_file)
+    {
+        std::fprintf(stderr, "Unable to open trace file: %s\n", trace_file_name.c_str());
+        return;
+    }
+
+    auto &registry = TheRegistry();
+    std::lock_guard<std::mutex> lock(registry.mtx_);
+
+    auto to_us = [](Clock::duration d) { return std::chrono::duration<double, std::micro>(d).count(); };
+
+    size_t total_events = 0;
+    const char *separator = "";
+    trace_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (const auto &buffer : registry.buffers_)
+    {
+        if (!buffer->thread_name_.empty())
+        {
+            trace_file << separator
+                       << std::format(R"({{"ph":"M","name":"thread_name","pid":1,"tid":{},"args":{{"name":"{}"}}}})",
+                                      buffer->tid_, EscapeJSON(buffer->thread_name_));
+            separator = ",\n";
+        }
+        for (const auto &event : buffer->events_)
+        {
+            trace_file << separator
+                       << std::format(R"({{"ph":"X","cat":"{}","name":"{}","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f})",
+                                      event.category_, event.name_, buffer->tid_, to_us(event.start_ - registry.start_),
+                                      to_us(event.duration_));
+            if (!event.detail_.empty())
+            {
+                trace_file << std::format(R"(,"args":{{"detail":"{}"}})", EscapeJSON(event.detail_));
+            }
+            trace_file << '}';
+            separator = ",\n";
+        }
+        total_events += buffer->events_.size();
+    }
+    trace_file << "\n]}\n";
+
+    std::fprintf(stderr, "Wrote %zu trace events from %zu threads to: %s\n", total_events, registry.buffers_.size(),
+                 trace_file_name.c_str());
+}
+
+} // namespace PF_Trace
+
+#define PF_TRACE_CONCAT_(a, b) a##b
+#define PF_TRACE_CONCAT(a, b) PF_TRACE_CONCAT_(a, b)
+
+#define PF_TRACE_SCOPE(category, name) \
+    const PF_Trace::Scope PF_TRACE_CONCAT(pf_trace_scope_, __COUNTER__){category, name}
+#define PF_TRACE_SCOPE_ARG(category, name, detail) \
+    const PF_Trace::Scope PF_TRACE_CONCAT(pf_trace_scope_, __COUNTER__){category, name, std::string{detail}}
+#define PF_TRACE_THREAD_NAME(name) PF_Trace::SetThreadName(name)
+#define PF_TRACE_WRITE() PF_Trace::WriteTrace()
+
+#else
+
+#define PF_TRACE_SCOPE(category, name) static_cast<void>(0)
+#define PF_TRACE_SCOPE_ARG(category, name, detail) static_cast<void>(0)
+#define PF_TRACE_THREAD_NAME(name) static_cast<void>(0)
+#define PF_TRACE_WRITE() static_cast<void>(0)
+
+#endif // PF_ENABLE_TRACE
+
+#endif // ----- #ifndef _PF_TRACE_INC_  -----
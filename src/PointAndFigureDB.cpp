@@ -31,10 +31,9 @@
 //
 // =====================================================================================
 
-#include <date/date.h> // for from_stream
-
 #include <boost/assert.hpp>
 #include <format>
+#include <ranges>
 #include <pqxx/pqxx>
 #include <pqxx/stream_from.hxx>
 #include <pqxx/transaction.hxx>
@@ -42,6 +41,7 @@
 // #include <date/tz.h>
 #include <spdlog/spdlog.h>
 
+#include "DateTimeParsing.h"
 #include "PF_Chart.h"
 #include "PointAndFigureDB.h"
 #include "utilities.h"
@@ -180,6 +180,45 @@ std::vector<PF_Chart> PF_DB::RetrieveAllEODChartsForSymbol(std::string_view symb
     return charts;
 } // -----  end of method PF_DB::RetrieveAllEODChartsForSymbol  -----
 
+std::map<std::string, std::vector<PF_Chart>, std::less<>> PF_DB::RetrieveAllEODCharts() const
+{
+    std::map<std::string, std::vector<PF_Chart>, std::less<>> charts;
+
+    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    pqxx::transaction trxn{c};
+
+    auto retrieve_chart_data_cmd =
+        std::format("SELECT symbol, chart_data FROM {}_point_and_figure.pf_charts WHERE file_name like '%_eod.json' ",
+                    db_params_.PF_db_mode_);
+
+    // there can be a lot of these so stream them instead of holding the whole result.
+
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+
+    for (const auto &[symbol, the_data] : trxn.stream<std::string_view, std::string_view>(retrieve_chart_data_cmd))
+    {
+        JSONCPP_STRING err;
+        Json::Value chart_data;
+
+        if (!reader->parse(the_data.data(), the_data.data() + the_data.size(), &chart_data, &err))
+        {
+            spdlog::error(
+                std::format("Problem parsing chart data from DB for symbol: {}. Skipping it.\n{}", symbol, err));
+            continue;
+        }
+        auto found = charts.find(symbol);
+        if (found == charts.end())
+        {
+            found = charts.emplace(std::string{symbol}, std::vector<PF_Chart>{}).first;
+        }
+        found->second.emplace_back(chart_data);
+    }
+    trxn.commit();
+
+    return charts;
+} // -----  end of method PF_DB::RetrieveAllEODCharts  -----
+
 void PF_DB::StorePFChartDataIntoDB(const PF_Chart &the_chart, std::string_view interval,
                                    std::string_view cvs_graphics_data) const
 {
@@ -247,6 +286,61 @@ void PF_DB::UpdatePFChartDataInDB(const PF_Chart &the_chart, std::string_view in
     trxn.commit();
 } // -----  end of method PF_DB::UpdatePFChartDataInDB  -----
 
+void PF_DB::UpsertPFChartsInDB(const std::vector<ChartForDB> &charts, std::string_view interval) const
+{
+    if (charts.empty())
+    {
+        return;
+    }
+
+    // keep each statement to a reasonable size. Everything still goes in 1 transaction.
+
+    constexpr size_t kChartsPerStatement = 100;
+
+    pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
+    pqxx::work trxn{c};
+
+    Json::StreamWriterBuilder wbuilder;
+    wbuilder["indentation"] = "";
+
+    for (const auto &batch : charts | std::views::chunk(kChartsPerStatement))
+    {
+        std::string values;
+        for (const auto &[the_chart, cvs_graphics_data] : batch)
+        {
+            auto json = the_chart->ToJSON();
+            std::string for_db = Json::writeString(wbuilder, json);
+
+            values += std::format(
+                "{}({}, {}, {}, {}, 'e_{}', 'e_{}', {}, {}, {}, {}, 'e_{}', 'e_{}', {}, {})", values.empty() ? "" : ", ",
+                trxn.quote(the_chart->GetSymbol()), trxn.quote(the_chart->GetFNameBoxSize().format("f")),
+                trxn.quote(the_chart->GetChartBoxSize().format("f")), the_chart->GetReversalboxes(),
+                json["boxes"]["box_type"].asString(), json["boxes"]["box_scale"].asString(),
+                trxn.quote(the_chart->MakeChartFileName(interval, "json")),
+                trxn.quote(std::format("{:%F %T%z}", the_chart->GetFirstTime())),
+                trxn.quote(std::format("{:%F %T%z}", the_chart->GetLastChangeTime())),
+                trxn.quote(std::format("{:%F %T%z}", the_chart->GetLastCheckedTime())),
+                json["current_direction"].asString(), the_chart->GetCurrentSignal().value_or(PF_Signal{}).signal_type_,
+                trxn.quote(for_db), trxn.quote(cvs_graphics_data));
+        }
+
+        const auto upsert_cmd = std::format(
+            "INSERT INTO {}_point_and_figure.pf_charts ({}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {})"
+            " VALUES {} ON CONFLICT (file_name) DO UPDATE SET"
+            " chart_box_size = EXCLUDED.chart_box_size, last_change_date = EXCLUDED.last_change_date,"
+            " last_checked_date = EXCLUDED.last_checked_date, current_direction = EXCLUDED.current_direction,"
+            " current_signal = EXCLUDED.current_signal, chart_data = EXCLUDED.chart_data,"
+            " cvs_graphics_data = EXCLUDED.cvs_graphics_data",
+            db_params_.PF_db_mode_, "symbol", "fname_box_size", "chart_box_size", "reversal_boxes", "box_type",
+            "box_scale", "file_name", "first_date", "last_change_date", "last_checked_date", "current_direction",
+            "current_signal", "chart_data", "cvs_graphics_data", values);
+
+        trxn.exec(upsert_cmd);
+    }
+
+    trxn.commit();
+} // -----  end of method PF_DB::UpsertPFChartsInDB  -----
+
 void PF_DB::UpdateLastCheckedDateInChartsDB(std::string_view exchange, std::string_view last_checked_date) const
 {
     pqxx::connection c{std::format("dbname={} user={}", db_params_.db_name_, db_params_.user_name_)};
@@ -332,19 +426,17 @@ std::vector<MultiSymbolDateCloseRecord> PF_DB::GetPriceDataForSymbolsInList(cons
 
     std::vector<MultiSymbolDateCloseRecord> db_data;
 
-    std::istringstream time_stream;
-    std::chrono::utc_time<std::chrono::utc_clock::duration> tp;
+    const auto which_format = ClassifyDateTimeFormat(date_format);
+    BOOST_ASSERT_MSG(which_format != DateTimeFormat::e_unknown,
+                     std::format("Unsupported date format: '{}' for stock price data.", date_format).c_str());
 
     // we know our database contains 'date's, but we need timepoints.
     // we'll handle that in the conversion routine below.
 
-    auto Row2Closing = [date_format, &time_stream, &tp](const auto &r) {
-        time_stream.clear();
-        time_stream.str(std::string{std::get<1>(r)});
-        std::chrono::from_stream(time_stream, date_format, tp);
-        std::chrono::utc_time<std::chrono::utc_clock::duration> tp1{tp.time_since_epoch()};
-        MultiSymbolDateCloseRecord new_data{
-            .symbol_ = std::string{std::get<0>(r)}, .date_ = tp1, .close_ = decimal::Decimal{std::get<2>(r)}};
+    auto Row2Closing = [which_format](const auto &r) {
+        MultiSymbolDateCloseRecord new_data{.symbol_ = std::string{std::get<0>(r)},
+                                            .date_ = ParseUTCTimePoint(which_format, std::get<1>(r)),
+                                            .close_ = decimal::Decimal{std::get<2>(r)}};
         return new_data;
     };
 
@@ -386,19 +478,17 @@ std::vector<MultiSymbolDateCloseRecord> PF_DB::GetPriceDataForSymbolsOnExchange(
 
     std::vector<MultiSymbolDateCloseRecord> db_data;
 
-    std::istringstream time_stream;
-    std::chrono::utc_time<std::chrono::utc_clock::duration> tp;
+    const auto which_format = ClassifyDateTimeFormat(date_format);
+    BOOST_ASSERT_MSG(which_format != DateTimeFormat::e_unknown,
+                     std::format("Unsupported date format: '{}' for stock price data.", date_format).c_str());
 
     // we know our database contains 'date's, but we need timepoints.
     // we'll handle that in the conversion routine below.
 
-    auto Row2Closing = [date_format, &time_stream, &tp](const auto &r) {
-        time_stream.clear();
-        time_stream.str(std::string{std::get<1>(r)});
-        std::chrono::from_stream(time_stream, date_format, tp);
-        std::chrono::utc_time<std::chrono::utc_clock::duration> tp1{tp.time_since_epoch()};
-        MultiSymbolDateCloseRecord new_data{
-            .symbol_ = std::string{std::get<0>(r)}, .date_ = tp1, .close_ = decimal::Decimal{std::get<2>(r)}};
+    auto Row2Closing = [which_format](const auto &r) {
+        MultiSymbolDateCloseRecord new_data{.symbol_ = std::string{std::get<0>(r)},
+                                            .date_ = ParseUTCTimePoint(which_format, std::get<1>(r)),
+                                            .close_ = decimal::Decimal{std::get<2>(r)}};
         return new_data;
     };
 
@@ -37,6 +37,7 @@
 #include <json/json.h>
 
 #include <decimal.hh>
+#include <map>
 #include <pqxx/pqxx>
 #include <pqxx/stream_from>
 #include <string>
@@ -71,6 +72,14 @@ public:
         int32_t port_number_ = kDefaultPort;
     };
 
+    // a chart along with its (optional) CSV graphics data for batch storage.
+
+    struct ChartForDB
+    {
+        const PF_Chart *chart_ = nullptr;
+        std::string cvs_graphics_data_;
+    };
+
     // ====================  LIFECYCLE     =======================================
     PF_DB() = default; // constructor
     PF_DB(const PF_DB &pf_db) = default;
@@ -88,11 +97,19 @@ public:
     [[nodiscard]] Json::Value GetPFChartData(std::string_view file_name) const;
     [[nodiscard]] std::vector<PF_Chart> RetrieveAllEODChartsForSymbol(std::string_view symbol) const;
 
+    // every EOD chart in the charts DB, grouped by symbol.
+
+    [[nodiscard]] std::map<std::string, std::vector<PF_Chart>, std::less<>> RetrieveAllEODCharts() const;
+
     void StorePFChartDataIntoDB(const PF_Chart &the_chart, std::string_view interval,
                                 std::string_view cvs_graphics_data) const;
     void UpdatePFChartDataInDB(const PF_Chart &the_chart, std::string_view interval,
                                std::string_view cvs_graphics_data) const;
 
+    // insert or replace all the charts in 1 transaction.
+
+    void UpsertPFChartsInDB(const std::vector<ChartForDB> &charts, std::string_view interval) const;
+
     void UpdateLastCheckedDateInChartsDB(std::string_view exchange, std::string_view last_checked_date) const;
 
     [[nodiscard]] std::vector<StockDataRecord> RetrieveMostRecentStockDataRecordsFromDB(std::string_view symbol,
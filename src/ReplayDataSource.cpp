@@ -0,0 +1,140 @@
+// =====================================================================================
+//
+//       Filename:  ReplayDataSource.cpp
+//
+//    Description:  'stream' previously captured frames through the normal
+//    streaming pipeline.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 03:05 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <format>
+#include <thread>
+
+#include <boost/assert.hpp>
+
+#include "ReplayDataSource.h"
+
+ReplayDataSource::ReplayDataSource(std::unique_ptr<RemoteDataSource> captured_from, const fs::path &capture_file_name,
+                                   double speed)
+    : captured_from_{std::move(captured_from)}, capture_file_name_{capture_file_name}, speed_{speed}
+{
+    BOOST_ASSERT_MSG(captured_from_, "\nReplay needs the data source the capture came from.");
+    BOOST_ASSERT_MSG(speed_ >= 0.0, "\nReplay speed must be >= 0.");
+} // -----  end of method ReplayDataSource::ReplayDataSource  (constructor)  -----
+
+RemoteDataSource::TopOfBookList ReplayDataSource::GetTopOfBookAndLastClose()
+{
+    return captured_from_->GetTopOfBookAndLastClose();
+} // -----  end of method ReplayDataSource::GetTopOfBookAndLastClose  -----
+
+std::vector<StockDataRecord> ReplayDataSource::GetMostRecentTickerData(const std::string &symbol,
+                                                                       std::chrono::year_month_day start_from,
+                                                                       int how_many_previous, UseAdjusted use_adjusted,
+                                                                       const US_MarketHolidays *holidays)
+{
+    return captured_from_->GetMostRecentTickerData(symbol, start_from, how_many_previous, use_adjusted, holidays);
+} // -----  end of method ReplayDataSource::GetMostRecentTickerData  -----
+
+RemoteDataSource::PF_Data ReplayDataSource::ExtractStreamedData(std::string_view buffer)
+{
+    return captured_from_->ExtractStreamedData(buffer);
+} // -----  end of method ReplayDataSource::ExtractStreamedData  -----
+
+void ReplayDataSource::StreamData(std::atomic<bool> *had_signal, StreamerContext &streamer_context)
+{
+    // there is no websocket here. We just push the captured frames into the same
+    // queue the websocket reader would, pausing between them as needed.
+
+    StreamCaptureReader reader{capture_file_name_};
+
+    std::optional<std::chrono::sys_time<std::chrono::nanoseconds>> first_received_at;
+    const auto replay_started_at = std::chrono::steady_clock::now();
+    int64_t frames_replayed = 0;
+    if (connection_metrics_)
+    {
+        connection_metrics_->connected_ = true;
+    }
+
+    while (!*had_signal)
+    {
+        const auto next_frame = reader.NextFrame();
+        if (!next_frame)
+        {
+            break;
+        }
+        if (!first_received_at)
+        {
+            first_received_at = next_frame->received_at_;
+        }
+
+        if (speed_ > 0.0)
+        {
+            const auto offset = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::nano>((next_frame->received_at_ - first_received_at.value()).count() /
+                                                         speed_));
+            std::this_thread::sleep_until(replay_started_at + offset);
+        }
+
+        auto frame = streamer_context.frame_pool_.Acquire();
+        frame.Assign(next_frame->frame_);
+        {
+            std::lock_guard<std::mutex> queue_lock(streamer_context.mtx_);
+            streamer_context.streamed_data_.push_back(
+                {.data_ = std::move(frame), .received_at_ = std::chrono::steady_clock::now()});
+        }
+        streamer_context.cv_.notify_one();
+        ++frames_replayed;
+        if (connection_metrics_)
+        {
+            connection_metrics_->frames_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (connection_metrics_)
+    {
+        connection_metrics_->connected_ = false;
+    }
+
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - replay_started_at);
+    spdlog::info(std::format("Replayed {} frames from: {} in {}.", frames_replayed, capture_file_name_, elapsed));
+
+    StopStreaming(streamer_context);
+} // -----  end of method ReplayDataSource::StreamData  -----
+
+void ReplayDataSource::OnConnected()
+{
+    // nothing to subscribe to.
+} // -----  end of method ReplayDataSource::OnConnected  -----
+
+void ReplayDataSource::StopStreaming(StreamerContext &streamer_context)
+{
+    {
+        std::lock_guard<std::mutex> lock(streamer_context.mtx_);
+        streamer_context.done_ = true;
+    }
+    streamer_context.cv_.notify_one();
+} // -----  end of method ReplayDataSource::StopStreaming  -----
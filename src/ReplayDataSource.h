@@ -0,0 +1,86 @@
+// =====================================================================================
+//
+//       Filename:  ReplayDataSource.h
+//
+//    Description:  'stream' previously captured frames through the normal
+//    streaming pipeline.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 03:05 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _REPLAYDATASOURCE_INC_
+#define _REPLAYDATASOURCE_INC_
+
+#include <memory>
+
+#include "Streamer.h"
+
+// =====================================================================================
+//        Class:  ReplayDataSource
+//  Description:  feeds frames from a capture file into the streamer context just
+//  like a live websocket would. Frames are parsed by the source they were
+//  captured from.
+//
+//  speed: 1.0 replays at the recorded pace, N replays N times faster and 0 replays
+//  as fast as the pipeline will take them.
+// =====================================================================================
+
+class ReplayDataSource : public RemoteDataSource
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    ReplayDataSource(std::unique_ptr<RemoteDataSource> captured_from, const fs::path &capture_file_name,
+                     double speed);
+    ~ReplayDataSource() override = default;
+
+    // ====================  ACCESSORS     =======================================
+
+    TopOfBookList GetTopOfBookAndLastClose() override;
+    std::vector<StockDataRecord> GetMostRecentTickerData(const std::string &symbol,
+                                                         std::chrono::year_month_day start_from, int how_many_previous,
+                                                         UseAdjusted use_adjusted,
+                                                         const US_MarketHolidays *holidays) override;
+
+    PF_Data ExtractStreamedData(std::string_view buffer) override;
+
+    // ====================  MUTATORS      =======================================
+
+    void StreamData(std::atomic<bool> *had_signal, StreamerContext &streamer_context) override;
+
+    void OnConnected() override;
+    void StopStreaming(StreamerContext &streamer_context) override;
+
+private:
+    // ====================  DATA MEMBERS  =======================================
+
+    std::unique_ptr<RemoteDataSource> captured_from_;
+    fs::path capture_file_name_;
+    double speed_;
+
+}; // -----  end of class ReplayDataSource  -----
+
+#endif // ----- #ifndef _REPLAYDATASOURCE_INC_  -----
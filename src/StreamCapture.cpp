@@ -0,0 +1,136 @@
+// =====================================================================================
+//
+//       Filename:  StreamCapture.cpp
+//
+//    Description:  Record raw streamed frames to a file and read them back
+//    for replay.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 03:05 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+
+#include "StreamCapture.h"
+
+namespace
+{
+constexpr char kCaptureMagic[8] = {'P', 'F', 'S', 'T', 'R', 'E', 'A', 'M'};
+constexpr uint32_t kCaptureVersion = 1;
+constexpr size_t kCaptureHeaderSize = sizeof(kCaptureMagic) + 2 * sizeof(uint32_t);
+constexpr size_t kFrameHeaderSize = sizeof(int64_t) + sizeof(uint32_t);
+constexpr size_t kCaptureFileBufferSize = 1 << 20;
+
+template <typename T>
+T ReadValue(const char *from)
+{
+    T result;
+    std::memcpy(&result, from, sizeof(T));
+    return result;
+}
+} // namespace
+
+StreamCaptureWriter::StreamCaptureWriter(const fs::path &capture_file_name) : file_buffer_(kCaptureFileBufferSize)
+{
+    // a large buffer keeps us from making a system call for every frame.
+
+    capture_file_.rdbuf()->pubsetbuf(file_buffer_.data(), static_cast<std::streamsize>(file_buffer_.size()));
+    capture_file_.open(capture_file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!capture_file_.is_open())
+    {
+        throw std::runtime_error(std::format("Unable to open stream capture file: {}", capture_file_name));
+    }
+
+    const uint32_t unused = 0;
+    capture_file_.write(kCaptureMagic, sizeof(kCaptureMagic));
+    capture_file_.write(reinterpret_cast<const char *>(&kCaptureVersion), sizeof(kCaptureVersion));
+    capture_file_.write(reinterpret_cast<const char *>(&unused), sizeof(unused));
+} // -----  end of method StreamCaptureWriter::StreamCaptureWriter  (constructor)  -----
+
+StreamCaptureWriter::~StreamCaptureWriter()
+{
+    capture_file_.close();
+    spdlog::info(std::format("Recorded {} streamed frames.", frames_recorded_));
+} // -----  end of method StreamCaptureWriter::~StreamCaptureWriter  (destructor)  -----
+
+void StreamCaptureWriter::Record(std::string_view frame)
+{
+    const int64_t received_at =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    const auto length = static_cast<uint32_t>(frame.size());
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    capture_file_.write(reinterpret_cast<const char *>(&received_at), sizeof(received_at));
+    capture_file_.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    capture_file_.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    ++frames_recorded_;
+} // -----  end of method StreamCaptureWriter::Record  -----
+
+StreamCaptureReader::StreamCaptureReader(const fs::path &capture_file_name)
+    : capture_file_{capture_file_name}, capture_file_name_{capture_file_name}, position_{kCaptureHeaderSize}
+{
+    if (capture_file_.size() < kCaptureHeaderSize ||
+        std::memcmp(capture_file_.data(), kCaptureMagic, sizeof(kCaptureMagic)) != 0)
+    {
+        throw std::runtime_error(std::format("File: {} is not a stream capture file.", capture_file_name));
+    }
+    const auto version = ReadValue<uint32_t>(capture_file_.data() + sizeof(kCaptureMagic));
+    if (version != kCaptureVersion)
+    {
+        throw std::runtime_error(
+            std::format("Stream capture file: {} has unsupported version: {}.", capture_file_name, version));
+    }
+} // -----  end of method StreamCaptureReader::StreamCaptureReader  (constructor)  -----
+
+std::optional<CapturedFrame> StreamCaptureReader::NextFrame()
+{
+    if (capture_file_.size() - position_ < kFrameHeaderSize)
+    {
+        return {};
+    }
+    const char *frame_header = capture_file_.data() + position_;
+    const auto received_at = ReadValue<int64_t>(frame_header);
+    const auto length = ReadValue<uint32_t>(frame_header + sizeof(int64_t));
+
+    // a capture which was cut off (program killed while recording) just ends early.
+
+    if (capture_file_.size() - position_ - kFrameHeaderSize < length)
+    {
+        spdlog::warn(std::format("Stream capture file: {} ends with a partial frame.", capture_file_name_));
+        position_ = capture_file_.size();
+        return {};
+    }
+
+    CapturedFrame result{.received_at_ = std::chrono::sys_time<std::chrono::nanoseconds>{
+                             std::chrono::nanoseconds{received_at}},
+                         .frame_ = std::string_view{frame_header + kFrameHeaderSize, length}};
+    position_ += kFrameHeaderSize + length;
+    return result;
+} // -----  end of method StreamCaptureReader::NextFrame  -----
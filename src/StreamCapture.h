@@ -0,0 +1,125 @@
+// =====================================================================================
+//
+//       Filename:  StreamCapture.h
+//
+//    Description:  Record raw streamed frames to a file and read them back
+//    for replay.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 03:05 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _STREAMCAPTURE_INC_
+#define _STREAMCAPTURE_INC_
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace fs = std::filesystem;
+
+// capture file layout (native byte order):
+//
+//  header:  8 byte magic "PFSTREAM", uint32 version, uint32 unused
+//  frames:  int64 receive time (ns since epoch), uint32 length, <length> bytes of frame
+//
+// Frames are stored exactly as received from the websocket.
+
+struct CapturedFrame
+{
+    std::chrono::sys_time<std::chrono::nanoseconds> received_at_;
+    std::string_view frame_;
+};
+
+// =====================================================================================
+//        Class:  StreamCaptureWriter
+//  Description:  append frames to a capture file. Safe to call from any thread.
+// =====================================================================================
+
+class StreamCaptureWriter
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    explicit StreamCaptureWriter(const fs::path &capture_file_name);
+
+    StreamCaptureWriter(const StreamCaptureWriter &rhs) = delete;
+    StreamCaptureWriter(StreamCaptureWriter &&rhs) = delete;
+
+    ~StreamCaptureWriter();
+
+    // ====================  MUTATORS      =======================================
+
+    void Record(std::string_view frame);
+
+    // ====================  OPERATORS     =======================================
+
+    StreamCaptureWriter &operator=(const StreamCaptureWriter &rhs) = delete;
+    StreamCaptureWriter &operator=(StreamCaptureWriter &&rhs) = delete;
+
+private:
+    // ====================  DATA MEMBERS  =======================================
+
+    std::vector<char> file_buffer_;
+    std::ofstream capture_file_;
+    std::mutex mtx_;
+    int64_t frames_recorded_ = 0;
+
+}; // -----  end of class StreamCaptureWriter  -----
+
+// =====================================================================================
+//        Class:  StreamCaptureReader
+//  Description:  walk through the frames in a capture file. Frames are views into
+//  the mapped file so they stay valid as long as the reader does.
+// =====================================================================================
+
+class StreamCaptureReader
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    explicit StreamCaptureReader(const fs::path &capture_file_name);
+
+    // ====================  MUTATORS      =======================================
+
+    std::optional<CapturedFrame> NextFrame();
+
+private:
+    // ====================  DATA MEMBERS  =======================================
+
+    MappedFile capture_file_;
+    fs::path capture_file_name_;
+    size_t position_ = 0;
+
+}; // -----  end of class StreamCaptureReader  -----
+
+#endif // ----- #ifndef _STREAMCAPTURE_INC_  -----
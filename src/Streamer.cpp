@@ -5,7 +5,10 @@
 
 #include "Streamer.h"
 #include <algorithm>
+#include <ranges>
+#include <utility>
 #include <boost/asio/bind_executor.hpp>
+#include <boost/assert.hpp>
 
 namespace rng = std::ranges;
 namespace http = beast::http;
@@ -21,7 +24,8 @@ RemoteDataSource::RemoteDataSource(const Host &host, const Port &port, const API
     : api_key_{api_key.get()}, host_{host.get()}, port_{port.get()}, websocket_prefix_{prefix.get()},
       ctx_{ssl::context::tlsv12_client}, resolver_{ioc_}, ws_{std::in_place, ioc_, ctx_}, reconnect_timer_(ioc_),
       max_reconnect_attempts_(5), reconnect_attempts_(0), base_reconnect_delay_(std::chrono::seconds(1)),
-      rng_(std::random_device{}()), jitter_dist_(0, 500), should_reconnect_(false)
+      rng_(std::random_device{}()), jitter_dist_(0, 500), should_reconnect_(false),
+      https_client_{std::make_unique<HttpsClient>(host_, port_)}
 {
 }
 
@@ -39,12 +43,12 @@ void RemoteDataSource::StartReconnect()
     start_reconnection();
 }
 
-void RemoteDataSource::StreamData(bool *had_signal, StreamerContext &streamer_context)
+void RemoteDataSource::StreamData(std::atomic<bool> *had_signal, StreamerContext &streamer_context)
 {
     // Store pointers for async handlers
     had_signal_ptr_ = had_signal;
     context_ptr_ = &streamer_context;
-    *had_signal = false;
+    stop_requested_ = false;
 
     // Reset io_context for new run
     ioc_.restart();
@@ -70,10 +74,21 @@ void RemoteDataSource::StreamData(bool *had_signal, StreamerContext &streamer_co
 
     // Cleanup
     signals_.clear();
+    read_frame_ = {};
     context_ptr_ = nullptr;
     had_signal_ptr_ = nullptr;
 }
 
+void RemoteDataSource::CaptureStreamTo(std::shared_ptr<StreamCaptureWriter> stream_capture)
+{
+    stream_capture_ = std::move(stream_capture);
+}
+
+void RemoteDataSource::UseConnectionMetrics(PF_StreamingMetrics::ConnectionMetrics *connection_metrics)
+{
+    connection_metrics_ = connection_metrics;
+}
+
 void RemoteDataSource::ConnectWS()
 {
     ws_.emplace(ioc_, ctx_);
@@ -151,6 +166,10 @@ void RemoteDataSource::on_handshake(beast::error_code ec)
     }
 
     spdlog::debug("Connected. performing subscription...");
+    if (connection_metrics_)
+    {
+        connection_metrics_->connected_ = true;
+    }
     reconnect_attempts_ = 0;  // Reset attempts on successful connection
     should_reconnect_ = true; // Enable reconnection from now on
     // 5. Let derived class handle subscription
@@ -159,6 +178,11 @@ void RemoteDataSource::on_handshake(beast::error_code ec)
 
 void RemoteDataSource::start_reconnection()
 {
+    if (connection_metrics_)
+    {
+        connection_metrics_->connected_ = false;
+    }
+
     if (!should_reconnect_ || reconnect_attempts_ >= max_reconnect_attempts_)
     {
         spdlog::info("Max reconnection attempts reached or reconnection disabled. Stopping.");
@@ -167,6 +191,10 @@ void RemoteDataSource::start_reconnection()
     }
 
     ++reconnect_attempts_;
+    if (connection_metrics_)
+    {
+        ++connection_metrics_->reconnects_;
+    }
     auto delay = calculate_reconnect_delay();
 
     spdlog::info("Attempting to reconnect in {} seconds (attempt {}/{}).", delay.count(), reconnect_attempts_,
@@ -234,8 +262,17 @@ void RemoteDataSource::StartReadLoop()
 
 void RemoteDataSource::do_read()
 {
+    // read straight into a pooled frame. A frame left over from a failed read is
+    // just emptied and used again.
+
+    if (!read_frame_)
+    {
+        read_frame_ = context_ptr_->frame_pool_.Acquire();
+    }
+    read_frame_.Buffer().clear();
+
     // Async Read
-    ws_.value().async_read(buffer_, beast::bind_front_handler(&RemoteDataSource::on_read, this));
+    ws_.value().async_read(read_frame_.Buffer(), beast::bind_front_handler(&RemoteDataSource::on_read, this));
 }
 
 void RemoteDataSource::on_read(beast::error_code ec, std::size_t bytes_transferred)
@@ -243,6 +280,10 @@ void RemoteDataSource::on_read(beast::error_code ec, std::size_t bytes_transferr
     if (ec == websocket::error::closed)
     {
         spdlog::debug("Websocket closed normally.");
+        if (connection_metrics_)
+        {
+            connection_metrics_->connected_ = false;
+        }
         StopStreaming(*context_ptr_);
         if (had_signal_ptr_)
             *had_signal_ptr_ = true;
@@ -284,17 +325,24 @@ void RemoteDataSource::on_read(beast::error_code ec, std::size_t bytes_transferr
     }
 
     // Process Data
-    if (buffer_.size() > 0 && context_ptr_)
+    if (read_frame_ && read_frame_.Buffer().size() > 0 && context_ptr_)
     {
-        // We read the data, then manually consume it.
-        std::string buffer_content = beast::buffers_to_string(buffer_.cdata());
+        const auto received_at = std::chrono::steady_clock::now();
+
+        // the frame itself goes to the parser. No copy.
 
-        // Remove the processed bytes from the buffer so it's empty for the next read
-        buffer_.clear();
+        if (stream_capture_)
+        {
+            stream_capture_->Record(read_frame_.View());
+        }
+        if (connection_metrics_)
+        {
+            connection_metrics_->frames_.fetch_add(1, std::memory_order_relaxed);
+        }
 
         {
             std::lock_guard<std::mutex> queue_lock(context_ptr_->mtx_);
-            context_ptr_->streamed_data_.push(std::move(buffer_content));
+            context_ptr_->streamed_data_.push_back({.data_ = std::move(read_frame_), .received_at_ = received_at});
         }
         context_ptr_->cv_.notify_one();
     }
@@ -337,6 +385,10 @@ void RemoteDataSource::on_signal(beast::error_code ec, int signal_number)
             StopStreaming(*context_ptr_);
 
         should_reconnect_ = false; // Disable reconnection
+        if (connection_metrics_)
+        {
+            connection_metrics_->connected_ = false;
+        }
         // Stop the IO context to exit the run() loop
         ioc_.stop();
     }
@@ -344,8 +396,13 @@ void RemoteDataSource::on_signal(beast::error_code ec, int signal_number)
 
 void RemoteDataSource::RequestStop()
 {
-    // This can be called from outside to trigger graceful shutdown
+    // This can be called from outside to trigger graceful shutdown. Both our reader
+    // and the app may ask so we only unsubscribe once.
     boost::asio::post(ioc_, [this]() {
+        if (std::exchange(stop_requested_, true))
+        {
+            return;
+        }
         if (had_signal_ptr_)
             *had_signal_ptr_ = true;
         if (context_ptr_)
@@ -397,31 +454,81 @@ void RemoteDataSource::UseSymbols(const std::vector<std::string> &symbols)
     rng::for_each(symbol_list_, [](auto &symbol) { rng::for_each(symbol, [](char &c) { c = std::toupper(c); }); });
 }
 
+void RemoteDataSource::UseRequestLimits(int32_t max_connections, int32_t requests_per_second)
+{
+    https_client_ = std::make_unique<HttpsClient>(host_, port_, max_connections, requests_per_second);
+}
+
 std::string RemoteDataSource::RequestData(const std::string &request_string)
 {
-    // Keep this synchronous for one-off requests
-    net::io_context ioc_req;
-    ssl::context ctx_req{ssl::context::tlsv12_client};
-    beast::ssl_stream<beast::tcp_stream> stream(ioc_req, ctx_req);
-    tcp::resolver resolver_req{ioc_req};
-
-    if (!SSL_set_tlsext_host_name(stream.native_handle(), host_.c_str()))
-        throw beast::system_error{
-            beast::error_code(static_cast<int>(::ERR_get_error()), net::error::get_ssl_category())};
-
-    auto const results = resolver_req.resolve(host_, port_);
-    beast::get_lowest_layer(stream).connect(results);
-    stream.handshake(ssl::stream_base::client);
-
-    http::request<http::string_body> req{http::verb::get, request_string, version};
-    req.set(http::field::host, host_);
-    req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
-    http::write(stream, req);
-
-    beast::flat_buffer buffer;
-    http::response<http::string_body> res;
-    http::read(stream, buffer, res);
-
-    beast::get_lowest_layer(stream).close();
-    return res.body();
+    BOOST_ASSERT_MSG(https_client_, "No host to send requests to.");
+    return https_client_->Get(request_string);
+}
+
+std::vector<std::string> RemoteDataSource::RequestData(const std::vector<std::string> &request_strings)
+{
+    BOOST_ASSERT_MSG(https_client_, "No host to send requests to.");
+    return https_client_->GetMany(request_strings);
+}
+
+void RemoteDataSource::UseHistoryCache(std::unique_ptr<PF_HistoryCache> history_cache)
+{
+    history_cache_ = std::move(history_cache);
+}
+
+std::map<std::string, std::vector<StockDataRecord>> RemoteDataSource::GetMostRecentTickerDataForSymbols(
+    const std::vector<std::string> &symbols, std::chrono::year_month_day start_from, int how_many_previous,
+    UseAdjusted use_adjusted, const US_MarketHolidays *holidays)
+{
+    std::vector<std::optional<std::vector<StockDataRecord>>> results(symbols.size());
+
+    // the cache is keyed by the same business day range GetMostRecentTickerData will ask for.
+
+    std::vector<size_t> to_request;
+    std::pair<std::chrono::year_month_day, std::chrono::year_month_day> business_days;
+    if (history_cache_)
+    {
+        business_days = ConstructeBusinessDayRange(start_from, how_many_previous, UpOrDown::e_Down, holidays);
+        for (size_t i = 0; i < symbols.size(); ++i)
+        {
+            results[i] = history_cache_->Find(symbols[i], business_days.second, business_days.first, use_adjusted);
+            if (!results[i])
+            {
+                to_request.push_back(i);
+            }
+        }
+        spdlog::info(std::format("History cache has: {} of: {} symbols. Requesting the rest.",
+                                 symbols.size() - to_request.size(), symbols.size()));
+    }
+    else
+    {
+        to_request = std::views::iota(size_t{0}, symbols.size()) | rng::to<std::vector>();
+    }
+
+    RunConcurrently(to_request.size(), https_client_ ? https_client_->MaxConnections() : 1, [&](size_t r) {
+        const auto i = to_request[r];
+        try
+        {
+            results[i] = GetMostRecentTickerData(symbols[i], start_from, how_many_previous, use_adjusted, holidays);
+            if (history_cache_)
+            {
+                history_cache_->Store(symbols[i], business_days.second, business_days.first, use_adjusted,
+                                      *results[i]);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            spdlog::error(std::format("Unable to get recent data for: {} because: {}", symbols[i], e.what()));
+        }
+    });
+
+    std::map<std::string, std::vector<StockDataRecord>> histories;
+    for (size_t i = 0; i < symbols.size(); ++i)
+    {
+        if (results[i])
+        {
+            histories[symbols[i]] = std::move(*results[i]);
+        }
+    }
+    return histories;
 }
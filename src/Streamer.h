@@ -6,13 +6,16 @@
 #ifndef _STREAMER_INC_
 #define _STREAMER_INC_
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <queue>
 #include <random>
+#include <string_view>
 #include <vector>
 
 #include <boost/asio/connect.hpp>
@@ -34,6 +37,11 @@ namespace net = boost::asio;            // from <boost/asio.hpp>
 namespace ssl = boost::asio::ssl;       // from <boost/asio/ssl.hpp>
 using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
 
+#include "FramePool.h"
+#include "HttpsClient.h"
+#include "PF_HistoryCache.h"
+#include "PF_StreamingMetrics.h"
+#include "StreamCapture.h"
 #include "Uniqueifier.h"
 #include "utilities.h"
 
@@ -76,14 +84,32 @@ public:
         int32_t last_size_{-1};
         bool dark_pool_{false};
         EodMktStatus market_status_{EodMktStatus::e_unknown};
+
+        // for streaming metrics: when the message arrived and when it was parsed.
+        std::chrono::steady_clock::time_point received_at_{};
+        std::chrono::steady_clock::time_point parsed_at_{};
+    };
+
+    // the frame is read straight into a pooled buffer and parsed in place.
+
+    struct StreamedFrame
+    {
+        FramePool::Frame data_;
+        std::chrono::steady_clock::time_point received_at_{};
     };
 
+    // the parser swaps streamed_data_ for its own empty vector and works through
+    // what it got. Both vectors keep their capacity so, like the frames, the queue
+    // stops allocating once it has been as deep as it gets. The pool is declared
+    // first so it outlives any frames still queued.
+
     struct StreamerContext
     {
         std::condition_variable cv_ = {};
         bool done_ = false; // Flag to signal completion
         std::mutex mtx_ = {};
-        std::queue<std::string> streamed_data_;
+        FramePool frame_pool_;
+        std::vector<StreamedFrame> streamed_data_;
     };
 
     struct ProcessorContext
@@ -105,20 +131,37 @@ public:
 
     // ====================  ACCESSORS     =======================================
 
-    // Synchronous request (kept for non-streaming data)
+    // REST requests to our host. These share a pool of kept-alive connections and
+    // can be made from any number of threads.
     std::string RequestData(const std::string &request_string);
+    std::vector<std::string> RequestData(const std::vector<std::string> &request_strings);
 
     virtual TopOfBookList GetTopOfBookAndLastClose() = 0;
     virtual std::vector<StockDataRecord> GetMostRecentTickerData(const std::string &symbol,
                                                                  std::chrono::year_month_day start_from,
                                                                  int how_many_previous, UseAdjusted use_adjusted,
                                                                  const US_MarketHolidays *holidays) = 0;
-    virtual PF_Data ExtractStreamedData(const std::string &buffer) = 0;
+    virtual PF_Data ExtractStreamedData(std::string_view buffer) = 0;
+
+    // GetMostRecentTickerData for each symbol, several at a time. A symbol we can't get
+    // data for is logged and left out. If we have a history cache, only what it doesn't
+    // have is requested.
+    std::map<std::string, std::vector<StockDataRecord>> GetMostRecentTickerDataForSymbols(
+        const std::vector<std::string> &symbols, std::chrono::year_month_day start_from, int how_many_previous,
+        UseAdjusted use_adjusted, const US_MarketHolidays *holidays);
 
     // ====================  MUTATORS      =======================================
 
     // Main entry point for the async loop
-    void StreamData(bool *had_signal, StreamerContext &streamer_context);
+    // had_signal is shared by every streamer in a session. It is set, never cleared, here.
+    virtual void StreamData(std::atomic<bool> *had_signal, StreamerContext &streamer_context);
+
+    // record every frame we receive so it can be replayed later. Several streamers
+    // can share 1 capture.
+    void CaptureStreamTo(std::shared_ptr<StreamCaptureWriter> stream_capture);
+
+    // where to count frames, reconnects and whether we are connected.
+    void UseConnectionMetrics(PF_StreamingMetrics::ConnectionMetrics *connection_metrics);
 
     // Derived classes implement this to send subscription messages after connection
     virtual void OnConnected() = 0;
@@ -128,6 +171,11 @@ public:
 
     void UseSymbols(const std::vector<std::string> &symbols);
 
+    // how many REST requests can be in flight at once and, if > 0, how many can be
+    // started per second.
+    void UseRequestLimits(int32_t max_connections, int32_t requests_per_second);
+    void UseHistoryCache(std::unique_ptr<PF_HistoryCache> history_cache);
+
     void RequestStop();
     void ConnectWS();
     void DisconnectWS();
@@ -163,7 +211,10 @@ protected:
     // Async components
     boost::asio::steady_timer timer_{ioc_};
     boost::asio::signal_set signals_{ioc_};
-    beast::flat_buffer buffer_;
+    beast::flat_buffer buffer_; // for the subscription exchange
+
+    // the message being read. Taken from our context's frame pool.
+    FramePool::Frame read_frame_;
 
     net::steady_timer reconnect_timer_;
     int max_reconnect_attempts_;
@@ -172,10 +223,16 @@ protected:
     std::mt19937 rng_;
     std::uniform_int_distribution<> jitter_dist_;
     bool should_reconnect_;
+    bool stop_requested_ = false; // only touched on ioc_'s thread
 
     // Pointers to external context (valid only during StreamData execution)
     StreamerContext *context_ptr_ = nullptr;
-    bool *had_signal_ptr_ = nullptr;
+    std::atomic<bool> *had_signal_ptr_ = nullptr;
+
+    std::shared_ptr<StreamCaptureWriter> stream_capture_;
+    PF_StreamingMetrics::ConnectionMetrics *connection_metrics_ = nullptr;
+    std::unique_ptr<HttpsClient> https_client_;
+    std::unique_ptr<PF_HistoryCache> history_cache_;
 
     std::vector<std::string> symbol_list_;
     const std::string host_;
@@ -0,0 +1,158 @@
+// =====================================================================================
+//
+//       Filename:  SyntheticPrices.h
+//
+//    Description:  Generate made up trade prices for testing and load
+//    generation.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 03:50 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _SYNTHETICPRICES_INC_
+#define _SYNTHETICPRICES_INC_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// =====================================================================================
+//        Class:  RandomWalkPrices
+//  Description:  one random walk per symbol. Prices are kept in cents so they look
+//  like what the streaming sources send. Each step moves the price up or down by
+//  1 to max_step_cents cents but never below 1 cent.
+//
+//  A fixed seed always gives the same sequence.
+// =====================================================================================
+
+class RandomWalkPrices
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    RandomWalkPrices(int32_t symbol_count, int64_t start_cents, int32_t max_step_cents, uint64_t seed)
+        : prices_cents_(symbol_count, start_cents), engine_{seed}, step_{1, max_step_cents}, up_or_down_{0.5}
+    {
+    }
+
+    // ====================  ACCESSORS     =======================================
+
+    [[nodiscard]] int32_t SymbolCount() const
+    {
+        return static_cast<int32_t>(prices_cents_.size());
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    // move the given symbol and return its new price in cents.
+
+    int64_t NextPriceCents(int32_t which_symbol)
+    {
+        const int64_t step = step_(engine_);
+        auto &price = prices_cents_[which_symbol];
+        price = std::max<int64_t>(1, up_or_down_(engine_) ? price + step : price - step);
+        return price;
+    }
+
+    // pick a symbol to trade next. Every symbol is equally likely.
+
+    int32_t NextSymbol()
+    {
+        return std::uniform_int_distribution<int32_t>{0, SymbolCount() - 1}(engine_);
+    }
+
+private:
+    // ====================  DATA MEMBERS  =======================================
+
+    std::vector<int64_t> prices_cents_;
+    std::mt19937_64 engine_;
+    std::uniform_int_distribution<int32_t> step_;
+    std::bernoulli_distribution up_or_down_;
+
+}; // -----  end of class RandomWalkPrices  -----
+
+// =====================================================================================
+//        Class:  GBMPrices
+//  Description:  geometric Brownian motion for a single symbol. This is the usual
+//  simple model of stock prices and gives charts a realistic mix of columns and
+//  reversals.
+//
+//  drift and volatility are annual. steps_per_year is how many prices make a
+//  year (252 for EOD data, 252 * 23'400 for 1 second data).
+// =====================================================================================
+
+class GBMPrices
+{
+public:
+    // ====================  LIFECYCLE     =======================================
+
+    GBMPrices(double start_price, double drift, double volatility, double steps_per_year, uint64_t seed)
+        : price_{start_price},
+          step_drift_{(drift - 0.5 * volatility * volatility) / steps_per_year},
+          step_volatility_{volatility * std::sqrt(1.0 / steps_per_year)},
+          engine_{seed}
+    {
+    }
+
+    // ====================  MUTATORS      =======================================
+
+    // the next price rounded to cents. Never less than 1 cent.
+
+    int64_t NextPriceCents()
+    {
+        price_ *= std::exp(step_drift_ + step_volatility_ * normal_(engine_));
+        return std::max<int64_t>(1, std::llround(price_ * 100.0));
+    }
+
+private:
+    // ====================  DATA MEMBERS  =======================================
+
+    double price_;
+    double step_drift_;
+    double step_volatility_;
+    std::mt19937_64 engine_;
+    std::normal_distribution<double> normal_{0.0, 1.0};
+
+}; // -----  end of class GBMPrices  -----
+
+// format cents as 'dollars.cents' the way the streaming sources do.
+
+inline std::string CentsToPriceString(int64_t cents)
+{
+    std::string result = std::to_string(cents / 100);
+    result += '.';
+    const auto fraction = cents % 100;
+    if (fraction < 10)
+    {
+        result += '0';
+    }
+    result += std::to_string(fraction);
+    return result;
+}
+
+#endif // ----- #ifndef _SYNTHETICPRICES_INC_  -----
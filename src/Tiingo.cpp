@@ -15,8 +15,10 @@
 // =====================================================================================
 
 #include "Tiingo.h"
+#include "DateTimeParsing.h"
 #include <boost/regex.hpp>
 #include <format>
+#include <iterator>
 #include <ranges>
 #include <sstream>
 
@@ -101,7 +103,7 @@ void Tiingo::on_read_subscribe(beast::error_code ec, std::size_t bytes_transferr
     StartReadLoop();
 }
 
-Tiingo::PF_Data Tiingo::ExtractStreamedData(const std::string &buffer)
+Tiingo::PF_Data Tiingo::ExtractStreamedData(std::string_view buffer)
 {
     // Tiingo only provides 3 fields for its 'free' IEX feed
     // - nanoseconds timestamp as fully formatted text string
@@ -111,13 +113,19 @@ Tiingo::PF_Data Tiingo::ExtractStreamedData(const std::string &buffer)
     static const boost::regex kNumericTradePrice{R"***(("data":\["(?:[^,]*,){2})([0-9]*\.[0-9]*)])***"};
     static const boost::regex kQuotedTradePrice{R"***(("data":\[(?:[^,]*,){2})"([0-9]*\.[0-9]*)")***"};
     static const std::string kStringTradePrice{R"***($1"$2"])***"};
-    const std::string zapped_buffer = boost::regex_replace(buffer, kNumericTradePrice, kStringTradePrice);
+
+    // each parser thread reuses its buffer and reader rather than making new ones
+    // for every message.
+
+    thread_local std::string zapped_buffer;
+    zapped_buffer.clear();
+    boost::regex_replace(std::back_inserter(zapped_buffer), buffer.begin(), buffer.end(), kNumericTradePrice,
+                         kStringTradePrice);
 
     JSONCPP_STRING err;
     Json::Value response;
 
-    Json::CharReaderBuilder builder;
-    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    thread_local const std::unique_ptr<Json::CharReader> reader(Json::CharReaderBuilder{}.newCharReader());
 
     if (!reader->parse(zapped_buffer.data(), zapped_buffer.data() + zapped_buffer.size(), &response, &err))
     {
@@ -249,19 +257,28 @@ RemoteDataSource::TopOfBookList Tiingo::GetTopOfBookAndLastClose()
     // via the base class common request method.
     // if any problems occur here, we'll just let beast throw an exception.
 
-    std::string symbols;
-    auto s = symbol_list_.begin();
-    symbols += *s;
-    for (++s; s != symbol_list_.end(); ++s)
+    // a long list of tickers makes for a very long URL and one slow response so we
+    // ask for them in chunks, several chunks at a time.
+
+    constexpr size_t kTickersPerRequest = 100;
+
+    std::vector<std::string> request_strings;
+    for (const auto &chunk : symbol_list_ | vws::chunk(kTickersPerRequest))
     {
-        symbols += ',';
-        symbols += *s;
+        std::string symbols;
+        for (const auto &symbol : chunk)
+        {
+            if (!symbols.empty())
+            {
+                symbols += ',';
+            }
+            symbols += symbol;
+        }
+        request_strings.push_back(
+            std::format("https://{}{}/?tickers={}&token={}&format=csv", host_, websocket_prefix_, symbols, api_key_));
     }
 
-    const std::string request_string =
-        std::format("https://{}{}/?tickers={}&token={}&format=csv", host_, websocket_prefix_, symbols, api_key_);
-
-    const auto data = RequestData(request_string);
+    const auto responses = RequestData(request_strings);
 
     // now, parse our our csv data
     // <ticker>,<askPrice>,<askSize>,<bidPrice>,<bidSize>,<high>,<last>,<lastSize>,<lastSaleTimestamp>,<low>,<mid>,<open>,
@@ -279,36 +296,39 @@ RemoteDataSource::TopOfBookList Tiingo::GetTopOfBookAndLastClose()
 
     TopOfBookList stock_data;
 
-    const auto rows = split_string<std::string_view>(data, "\n");
-
-    rng::for_each(rows | vws::drop(1), [&stock_data](const auto row) {
-        const auto fields = split_string<std::string_view>(row, ",");
-
-        // a few checks to try to catch any changes in response format
-
-        BOOST_ASSERT_MSG(
-            fields.size() == 17,
-            std::format("Missing 1 or more fields from response: '{}'. Expected 17. Got: {}", row, fields.size())
-                .c_str());
-
-        // if we have any problems with this data, skip the row an try the next.
-        // missing data here is not very important.
-        try
-        {
-            const auto tstmp = StringToUTCTimePoint("%FT%T%z", fields[e_timestamp]);
-
-            TopOfBookOpenAndLastClose new_data{.symbol_ = std::string{fields[e_symbol_]},
-                                               .time_stamp_nsecs_ = tstmp,
-                                               .open_ = sv2dec(fields[e_open]),
-                                               .last_ = sv2dec(fields[e_tiingo_last]),
-                                               .previous_close_ = sv2dec(fields[e_previous_close])};
-            stock_data.push_back(new_data);
-        }
-        catch (const std::exception &e)
-        {
-            spdlog::error(e.what());
-        }
-    });
+    for (const auto &data : responses)
+    {
+        const auto rows = split_string<std::string_view>(data, "\n");
+
+        rng::for_each(rows | vws::drop(1), [&stock_data](const auto row) {
+            const auto fields = split_string<std::string_view>(row, ",");
+
+            // a few checks to try to catch any changes in response format
+
+            BOOST_ASSERT_MSG(
+                fields.size() == 17,
+                std::format("Missing 1 or more fields from response: '{}'. Expected 17. Got: {}", row, fields.size())
+                    .c_str());
+
+            // if we have any problems with this data, skip the row an try the next.
+            // missing data here is not very important.
+            try
+            {
+                const auto tstmp = ParseUTCTimePoint(DateTimeFormat::e_iso_date_time_zone, fields[e_timestamp]);
+
+                TopOfBookOpenAndLastClose new_data{.symbol_ = std::string{fields[e_symbol_]},
+                                                   .time_stamp_nsecs_ = tstmp,
+                                                   .open_ = sv2dec(fields[e_open]),
+                                                   .last_ = sv2dec(fields[e_tiingo_last]),
+                                                   .previous_close_ = sv2dec(fields[e_previous_close])};
+                stock_data.push_back(new_data);
+            }
+            catch (const std::exception &e)
+            {
+                spdlog::error(e.what());
+            }
+        });
+    }
     return stock_data;
 }
 std::vector<StockDataRecord> Tiingo::GetMostRecentTickerData(const std::string &symbol,
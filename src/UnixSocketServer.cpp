@@ -0,0 +1,201 @@
+// =====================================================================================
+//
+//       Filename:  UnixSocketServer.cpp
+//
+//    Description:  A small line oriented request/response server on a local (Unix
+//    domain) socket.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 07:50 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include <format>
+#include <thread>
+#include <utility>
+
+#include <boost/asio/buffers_iterator.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/assert.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include "UnixSocketServer.h"
+
+namespace net = boost::asio;
+using local_socket = net::local::stream_protocol;
+
+namespace
+{
+// a request is a command line, not a document.
+
+constexpr size_t kMaxRequestBytes = 64 * 1024;
+} // namespace
+
+struct UnixSocketServer::Impl
+{
+    // =====================================================================================
+    //        Class:  Session
+    //  Description:  one client connection. Reads a line, hands it to the handler and
+    //  doesn't read the next one until the reply has been written.
+    // =====================================================================================
+
+    class Session : public std::enable_shared_from_this<Session>
+    {
+    public:
+        Session(local_socket::socket socket, const Handler &handler)
+            : socket_{std::move(socket)}, buffer_{kMaxRequestBytes}, handler_{handler}
+        {
+        }
+
+        void ReadRequest()
+        {
+            net::async_read_until(
+                socket_, buffer_, '\n', [self = shared_from_this()](boost::system::error_code ec, size_t length) {
+                    if (ec)
+                    {
+                        // closed by the client, too long or we are stopping.
+
+                        if (ec == net::error::not_found)
+                        {
+                            self->WriteResponse(R"({"status":"error","message":"request too long"})");
+                        }
+                        return;
+                    }
+                    const auto begin = net::buffers_begin(self->buffer_.data());
+                    std::string request{begin, begin + static_cast<std::ptrdiff_t>(length) - 1};
+                    self->buffer_.consume(length);
+                    if (!request.empty() && request.back() == '\r')
+                    {
+                        request.pop_back();
+                    }
+                    if (request.empty())
+                    {
+                        self->ReadRequest();
+                        return;
+                    }
+
+                    // the reply can come from any thread so hop back onto ours to write it.
+
+                    self->handler_(request, [self](std::string response) {
+                        auto executor = self->socket_.get_executor();
+                        net::post(executor, [self, response = std::move(response)]() mutable {
+                            self->WriteResponse(std::move(response));
+                            self->ReadRequest();
+                        });
+                    });
+                });
+        }
+
+    private:
+        void WriteResponse(std::string response)
+        {
+            auto message = std::make_shared<std::string>(std::move(response));
+            *message += '\n';
+            net::async_write(socket_, net::buffer(*message),
+                             [self = shared_from_this(), message](boost::system::error_code, size_t) {});
+        }
+
+        local_socket::socket socket_;
+        net::streambuf buffer_;
+        const Handler &handler_;
+    };
+
+    Impl(fs::path socket_path, Handler handler)
+        : socket_path_{std::move(socket_path)}, handler_{std::move(handler)}, acceptor_{ioc_}
+    {
+    }
+
+    void DoAccept()
+    {
+        acceptor_.async_accept([this](boost::system::error_code ec, local_socket::socket socket) {
+            if (ec == net::error::operation_aborted)
+            {
+                return;
+            }
+            if (!ec)
+            {
+                std::make_shared<Session>(std::move(socket), handler_)->ReadRequest();
+            }
+            DoAccept();
+        });
+    }
+
+    fs::path socket_path_;
+    Handler handler_;
+    net::io_context ioc_;
+    local_socket::acceptor acceptor_;
+    std::thread io_thread_;
+};
+
+UnixSocketServer::UnixSocketServer(fs::path socket_path, Handler handler)
+    : impl_{std::make_unique<Impl>(std::move(socket_path), std::move(handler))}
+{
+    BOOST_ASSERT_MSG(!impl_->socket_path_.empty(), "Must provide a path for the socket.");
+} // -----  end of method UnixSocketServer::UnixSocketServer  (constructor)  -----
+
+UnixSocketServer::~UnixSocketServer()
+{
+    Stop();
+} // -----  end of method UnixSocketServer::~UnixSocketServer  (destructor)  -----
+
+void UnixSocketServer::Start()
+{
+    // a socket file can only be bound once so remove one left by a previous run.
+
+    std::error_code ec;
+    fs::remove(impl_->socket_path_, ec);
+
+    local_socket::endpoint endpoint{impl_->socket_path_.string()};
+    impl_->acceptor_.open(endpoint.protocol());
+    impl_->acceptor_.bind(endpoint);
+    fs::permissions(impl_->socket_path_, fs::perms::owner_read | fs::perms::owner_write, fs::perm_options::replace);
+    impl_->acceptor_.listen();
+
+    impl_->DoAccept();
+    impl_->io_thread_ = std::thread{[this] { impl_->ioc_.run(); }};
+
+    spdlog::info(std::format("Listening for commands on: {}", impl_->socket_path_));
+} // -----  end of method UnixSocketServer::Start  -----
+
+void UnixSocketServer::Stop()
+{
+    if (!impl_->io_thread_.joinable())
+    {
+        return;
+    }
+    impl_->ioc_.stop();
+    impl_->io_thread_.join();
+
+    boost::system::error_code ignored;
+    impl_->acceptor_.close(ignored);
+
+    std::error_code ec;
+    fs::remove(impl_->socket_path_, ec);
+} // -----  end of method UnixSocketServer::Stop  -----
@@ -0,0 +1,94 @@
+// =====================================================================================
+//
+//       Filename:  UnixSocketServer.h
+//
+//    Description:  A small line oriented request/response server on a local (Unix
+//    domain) socket.
+//
+//        Version:  1.0
+//        Created:  2026-10-19 07:50 PM
+//       Revision:  none
+//       Compiler:  g++
+//
+//         Author:  David P. Riedel (dpr), driedel@cox.net
+//        License:  GNU General Public License v3
+//        Company:
+//
+// =====================================================================================
+
+/* This file is part of PF_CollectData. */
+
+/* PF_CollectData is free software: you can redistribute it and/or modify */
+/* it under the terms of the GNU General Public License as published by */
+/* the Free Software Foundation, either version 3 of the License, or */
+/* (at your option) any later version. */
+
+/* PF_CollectData is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the */
+/* GNU General Public License for more details. */
+
+/* You should have received a copy of the GNU General Public License */
+/* along with PF_CollectData.  If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef _UNIXSOCKETSERVER_INC_
+#define _UNIXSOCKETSERVER_INC_
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+// =====================================================================================
+//        Class:  UnixSocketServer
+//  Description:  each request is one line of text and gets exactly one line back.
+//  A connection may send any number of requests but they are answered in order,
+//  one at a time.
+//
+//  The handler is called on the server's own thread. It must not block. It can
+//  answer right away or keep the Reply and call it later from any thread, which
+//  lets slow commands run elsewhere while quick ones are answered immediately.
+//  All Replies must be called or destroyed before the server is.
+// =====================================================================================
+
+class UnixSocketServer
+{
+public:
+    using Reply = std::function<void(std::string response)>;
+    using Handler = std::function<void(std::string_view request, Reply reply)>;
+
+    // ====================  LIFECYCLE     =======================================
+
+    UnixSocketServer(fs::path socket_path, Handler handler);
+
+    UnixSocketServer(const UnixSocketServer &rhs) = delete;
+    UnixSocketServer(UnixSocketServer &&rhs) = delete;
+
+    ~UnixSocketServer();
+
+    // ====================  MUTATORS      =======================================
+
+    // replaces a socket file left behind by an earlier run. The socket is only
+    // accessible to our own user.
+
+    void Start();
+    void Stop();
+
+    // ====================  OPERATORS     =======================================
+
+    UnixSocketServer &operator=(const UnixSocketServer &rhs) = delete;
+    UnixSocketServer &operator=(UnixSocketServer &&rhs) = delete;
+
+private:
+    struct Impl;
+
+    // ====================  DATA MEMBERS  =======================================
+
+    std::unique_ptr<Impl> impl_;
+
+}; // -----  end of class UnixSocketServer  -----
+
+#endif // ----- #ifndef _UNIXSOCKETSERVER_INC_  -----